@@ -0,0 +1,338 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "shellanything/ConfigManager.h"
+#include "shellanything/Context.h"
+#include "shellanything/Validator.h"
+#include "MenuIndex.h"
+#include "PathType.h"
+#include "PathTypeCache.h"
+
+#include "rapidassist/filesystem.h"
+#include "rapidassist/strings.h"
+
+#include <thread>
+#include <chrono>
+
+namespace shellanything { namespace benchmarks
+{
+  // Returns the xml content of a configuration file with (num_top_menus * 100) menus.
+  // Each top menu owns 9 parent menus of 10 menus. Half of the leaf menus are visible with *.txt files.
+  std::string GetBenchConfiguration(size_t num_top_menus)
+  {
+    std::string xml;
+    xml += "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+    xml += "<root>\n";
+    xml += "  <shell>\n";
+    for(size_t i=0; i<num_top_menus; i++)
+    {
+      xml += "    <menu name=\"menu " + ra::strings::ToString(i) + "\">\n";
+      for(size_t j=0; j<9; j++)
+      {
+        xml += "      <menu name=\"menu " + ra::strings::ToString(i) + "." + ra::strings::ToString(j) + "\">\n";
+        for(size_t k=0; k<10; k++)
+        {
+          const char * extension = (k % 2 == 0 ? "txt" : "zip");
+          xml += "        <menu name=\"menu " + ra::strings::ToString(i) + "." + ra::strings::ToString(j) + "." + ra::strings::ToString(k) + "\">\n";
+          xml += std::string("          <visibility fileextensions=\"") + extension + "\" />\n";
+          xml += "        </menu>\n";
+        }
+        xml += "      </menu>\n";
+      }
+      xml += "    </menu>\n";
+    }
+    xml += "  </shell>\n";
+    xml += "</root>\n";
+    return xml;
+  }
+
+  // Loads a configuration file with the given number of menus in the ConfigManager.
+  // The file is written once in a temporary directory and reused by the next runs.
+  void LoadBenchConfiguration(size_t num_menus)
+  {
+    static const std::string path_separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + path_separator + "shellanything_bench_menus_" + ra::strings::ToString(num_menus);
+    const std::string path = directory + path_separator + "menus.xml";
+    ra::filesystem::CreateDirectory(directory.c_str());
+    if (!ra::filesystem::FileExists(path.c_str()))
+      ra::filesystem::WriteFile(path, GetBenchConfiguration(num_menus / 100));
+
+    ConfigManager & cmgr = ConfigManager::GetInstance();
+    cmgr.ClearSearchPath();
+    cmgr.AddSearchPath(directory);
+    cmgr.Refresh();
+  }
+
+  // Updates the given menus and their submenus like Menu::Update() did before the menu index:
+  // the submenus are found with FindChildren() and FilterNodes(), which allocate a list at each level, and each validator is evaluated.
+  void UpdateMenusBaseline(Node & parent, const Context & c, bool & all_invisible)
+  {
+    all_invisible = true;
+    Menu::MenuPtrList menus = FilterNodes<Menu*>(parent.FindChildren("Menu"));
+    for(size_t i=0; i<menus.size(); i++)
+    {
+      Menu * menu = menus[i];
+      bool visible = menu->GetVisibility().Validate(c);
+      bool enabled = menu->GetValidity().Validate(c);
+      menu->SetVisible(visible);
+      menu->SetEnabled(enabled);
+
+      bool all_invisible_children = true;
+      UpdateMenusBaseline(*menu, c, all_invisible_children);
+
+      //Issue #4 - Parent menu with no children.
+      if (menu->IsParentMenu() && visible && all_invisible_children)
+        menu->SetVisible(false);
+
+      all_invisible = all_invisible && !menu->IsVisible();
+    }
+  }
+
+  // Assigns the command ids of the given menus and their submenus like Menu::AssignCommandIds() did before the menu index.
+  uint32_t AssignCommandIdsBaseline(Node & parent, const uint32_t & iFirstCommandId)
+  {
+    uint32_t nextCommandId = iFirstCommandId;
+    Menu::MenuPtrList menus = FilterNodes<Menu*>(parent.FindChildren("Menu"));
+    for(size_t i=0; i<menus.size(); i++)
+    {
+      Menu * menu = menus[i];
+      if (!menu->IsVisible() || nextCommandId == Menu::INVALID_COMMAND_ID)
+      {
+        menu->SetCommandId(Menu::INVALID_COMMAND_ID);
+        AssignCommandIdsBaseline(*menu, Menu::INVALID_COMMAND_ID);
+      }
+      else
+      {
+        menu->SetCommandId(nextCommandId);
+        nextCommandId = AssignCommandIdsBaseline(*menu, nextCommandId + 1);
+      }
+    }
+    return nextCommandId;
+  }
+
+  // Builds the same tree of menus as GetBenchConfiguration(), in memory.
+  void BuildBenchMenus(Node & root, size_t num_top_menus)
+  {
+    for(size_t i=0; i<num_top_menus; i++)
+    {
+      Menu * top = new Menu();
+      root.AddChild(top);
+      for(size_t j=0; j<9; j++)
+      {
+        Menu * parent = new Menu();
+        top->AddChild(parent);
+        for(size_t k=0; k<10; k++)
+        {
+          Validator visibility;
+          visibility.SetFileExtensions(k % 2 == 0 ? "txt" : "zip");
+          Menu * menu = new Menu();
+          menu->SetVisibility(visibility);
+          parent->AddChild(menu);
+        }
+      }
+    }
+  }
+
+  // Returns a context with a single *.txt file.
+  Context GetBenchContext()
+  {
+    Context context;
+    Context::ElementList elements;
+    elements.push_back(ra::filesystem::GetTemporaryDirectory() + ra::filesystem::GetPathSeparatorStr() + "foo.txt");
+    context.SetElements(elements);
+    return context;
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  static void BM_MenuTreeUpdate(benchmark::State & state)
+  {
+    // The update of a tree of menus in memory, through the pre-order index of menu pointers used by ConfigManager::Update().
+    Node root("root");
+    BuildBenchMenus(root, (size_t)state.range(0) / 100);
+    MenuIndex index;
+    index.Build(root);
+    Context context = GetBenchContext();
+
+    for (auto _ : state)
+    {
+      index.Update(context);
+      uint32_t next_command_id = index.AssignCommandIds(101);
+      benchmark::DoNotOptimize(next_command_id);
+    }
+  }
+  BENCHMARK(BM_MenuTreeUpdate)->Arg(5000)->Unit(benchmark::kMicrosecond);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_MenuTreeUpdateBaseline(benchmark::State & state)
+  {
+    // Same tree and context as BM_MenuTreeUpdate, updated with the recursive traversal of the baseline.
+    Node root("root");
+    BuildBenchMenus(root, (size_t)state.range(0) / 100);
+    Context context = GetBenchContext();
+
+    for (auto _ : state)
+    {
+      bool all_invisible = true;
+      UpdateMenusBaseline(root, context, all_invisible);
+      uint32_t next_command_id = AssignCommandIdsBaseline(root, 101);
+      benchmark::DoNotOptimize(next_command_id);
+    }
+  }
+  BENCHMARK(BM_MenuTreeUpdateBaseline)->Arg(5000)->Unit(benchmark::kMicrosecond);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ConfigManagerUpdate(benchmark::State & state)
+  {
+    // A full refresh of the menus before showing the context menu: visibility update and command ids.
+    LoadBenchConfiguration((size_t)state.range(0));
+    ConfigManager & cmgr = ConfigManager::GetInstance();
+    Context context = GetBenchContext();
+
+    for (auto _ : state)
+    {
+      cmgr.Update(context);
+      uint32_t next_command_id = cmgr.AssignCommandIds(101);
+      benchmark::DoNotOptimize(next_command_id);
+    }
+
+    cmgr.Clear();
+  }
+  BENCHMARK(BM_ConfigManagerUpdate)->Arg(5000)->Unit(benchmark::kMicrosecond);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ConfigManagerUpdateBaseline(benchmark::State & state)
+  {
+    // Same configuration and context as BM_ConfigManagerUpdate, updated with the recursive traversal of the baseline.
+    LoadBenchConfiguration((size_t)state.range(0));
+    ConfigManager & cmgr = ConfigManager::GetInstance();
+    Context context = GetBenchContext();
+
+    for (auto _ : state)
+    {
+      Configuration::ConfigurationPtrList configurations = cmgr.GetConfigurations();
+      uint32_t next_command_id = 101;
+      for(size_t i=0; i<configurations.size(); i++)
+      {
+        bool all_invisible = true;
+        UpdateMenusBaseline(*configurations[i], context, all_invisible);
+      }
+      for(size_t i=0; i<configurations.size(); i++)
+      {
+        next_command_id = AssignCommandIdsBaseline(*configurations[i], next_command_id);
+      }
+      benchmark::DoNotOptimize(next_command_id);
+    }
+
+    cmgr.Clear();
+  }
+  BENCHMARK(BM_ConfigManagerUpdateBaseline)->Arg(5000)->Unit(benchmark::kMicrosecond);
+  //--------------------------------------------------------------------------------------------------
+
+  // A file system where each query takes 100 microseconds, like a network share. All paths are files.
+  class SlowPathTypeProvider : public PathTypeProvider
+  {
+  public:
+    virtual PATH_TYPE GetPathType(const std::string & path)
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      return PATH_TYPE_FILE;
+    }
+  };
+
+  // Returns the xml content of a configuration file with 10 menus which check the existence of a distinct file.
+  std::string GetBenchSlowConfiguration(size_t config_index)
+  {
+    std::string xml;
+    xml += "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+    xml += "<root>\n";
+    xml += "  <shell>\n";
+    xml += "    <menu name=\"config " + ra::strings::ToString(config_index) + "\">\n";
+    for(size_t i=0; i<10; i++)
+    {
+      const std::string name = ra::strings::ToString(config_index) + "." + ra::strings::ToString(i);
+      xml += "      <menu name=\"menu " + name + "\">\n";
+      xml += "        <visibility exists=\"tool_" + name + ".exe\" />\n";
+      xml += "      </menu>\n";
+    }
+    xml += "    </menu>\n";
+    xml += "  </shell>\n";
+    xml += "</root>\n";
+    return xml;
+  }
+
+  // Loads the given number of configuration files with slow validators in the ConfigManager.
+  void LoadBenchSlowConfigurations(size_t num_configs)
+  {
+    static const std::string path_separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + path_separator + "shellanything_bench_slow_" + ra::strings::ToString(num_configs);
+    ra::filesystem::CreateDirectory(directory.c_str());
+    for(size_t i=0; i<num_configs; i++)
+    {
+      const std::string path = directory + path_separator + "config" + ra::strings::ToString(i) + ".xml";
+      if (!ra::filesystem::FileExists(path.c_str()))
+        ra::filesystem::WriteFile(path, GetBenchSlowConfiguration(i));
+    }
+
+    ConfigManager & cmgr = ConfigManager::GetInstance();
+    cmgr.ClearSearchPath();
+    cmgr.AddSearchPath(directory);
+    cmgr.Refresh();
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ConfigManagerUpdateSlowValidators(benchmark::State & state)
+  {
+    // 32 configuration files of 10 menus whose validators query a slow file system, updated by 1 or more threads.
+    LoadBenchSlowConfigurations(32);
+    ConfigManager & cmgr = ConfigManager::GetInstance();
+    cmgr.SetMaxUpdateThreads((size_t)state.range(0));
+
+    // Query the file system on each update
+    PathTypeCache & path_cache = PathTypeCache::GetInstance();
+    const uint32_t time_to_live = path_cache.GetTimeToLive();
+    path_cache.SetTimeToLive(0);
+    SlowPathTypeProvider provider;
+    SetPathTypeProvider(&provider);
+
+    Context context;
+    Context::ElementList elements;
+    elements.push_back(ra::filesystem::GetTemporaryDirectory() + ra::filesystem::GetPathSeparatorStr() + "foo.txt");
+    context.SetElements(elements);
+
+    for (auto _ : state)
+    {
+      cmgr.Update(context);
+      uint32_t next_command_id = cmgr.AssignCommandIds(101);
+      benchmark::DoNotOptimize(next_command_id);
+    }
+
+    SetPathTypeProvider(NULL);
+    path_cache.SetTimeToLive(time_to_live);
+    cmgr.SetMaxUpdateThreads(1);
+    cmgr.Clear();
+  }
+  BENCHMARK(BM_ConfigManagerUpdateSlowValidators)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace benchmarks
+} //namespace shellanything
@@ -0,0 +1,128 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "shellanything/Context.h"
+#include "PathType.h"
+
+#include "rapidassist/filesystem.h"
+#include "rapidassist/filesystem_utf8.h"
+#include "rapidassist/strings.h"
+
+namespace shellanything { namespace benchmarks
+{
+  // Returns a list of elements in a temporary directory: files, directories and missing elements.
+  // The directory is created once and reused by the next runs.
+  Context::ElementList GetBenchElements(size_t count)
+  {
+    static const std::string path_separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + path_separator + "shellanything_bench_" + ra::strings::ToString(count);
+    ra::filesystem::CreateDirectory(directory.c_str());
+
+    Context::ElementList elements;
+    for(size_t i=0; i<count; i++)
+    {
+      const std::string path = directory + path_separator + ra::strings::ToString(i);
+      switch(i % 3)
+      {
+      case 0:
+        if (!ra::filesystem::FileExistsUtf8(path.c_str()))
+          ra::filesystem::WriteFile(path, "bench");
+        break;
+      case 1:
+        ra::filesystem::CreateDirectory(path.c_str());
+        break;
+      default:
+        break; // missing element
+      };
+      elements.push_back(path);
+    }
+    return elements;
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ClassifyFileAndDirectoryExists(benchmark::State & state)
+  {
+    // Previous implementation of Context::SetElements(): two queries per element.
+    const Context::ElementList elements = GetBenchElements((size_t)state.range(0));
+
+    for (auto _ : state)
+    {
+      int num_files = 0;
+      int num_directories = 0;
+      for(size_t i=0; i<elements.size(); i++)
+      {
+        const std::string & element = elements[i];
+        if (ra::filesystem::FileExistsUtf8(element.c_str()))
+          num_files++;
+        if (ra::filesystem::DirectoryExistsUtf8(element.c_str()))
+          num_directories++;
+      }
+      benchmark::DoNotOptimize(num_files);
+      benchmark::DoNotOptimize(num_directories);
+    }
+  }
+  BENCHMARK(BM_ClassifyFileAndDirectoryExists)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ClassifyPathType(benchmark::State & state)
+  {
+    // A single query per element, from the current thread.
+    const Context::ElementList elements = GetBenchElements((size_t)state.range(0));
+
+    for (auto _ : state)
+    {
+      int num_files = 0;
+      int num_directories = 0;
+      for(size_t i=0; i<elements.size(); i++)
+      {
+        PATH_TYPE type = GetPathType(elements[i]);
+        if (type == PATH_TYPE_FILE)
+          num_files++;
+        else if (type == PATH_TYPE_DIRECTORY)
+          num_directories++;
+      }
+      benchmark::DoNotOptimize(num_files);
+      benchmark::DoNotOptimize(num_directories);
+    }
+  }
+  BENCHMARK(BM_ClassifyPathType)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ContextSetElements(benchmark::State & state)
+  {
+    // A single query per element, from multiple threads.
+    const Context::ElementList elements = GetBenchElements((size_t)state.range(0));
+
+    for (auto _ : state)
+    {
+      Context context;
+      context.SetElements(elements);
+      benchmark::DoNotOptimize(context.GetNumFiles());
+    }
+  }
+  BENCHMARK(BM_ContextSetElements)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace benchmarks
+} //namespace shellanything
@@ -0,0 +1,206 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "PropertyManager.h"
+
+#include "rapidassist/strings.h"
+
+#include <map>
+
+namespace shellanything { namespace benchmarks
+{
+  typedef std::map<std::string /*name*/, std::string /*value*/> PropertyMap;
+
+  // Previous implementation of PropertyManager::Expand(). Kept as a reference for comparison.
+  // Runs a search and replace on the whole string for each known property.
+  std::string ExpandPerProperty(const PropertyMap & properties, const std::string & value)
+  {
+    std::string output = value;
+
+    for (PropertyMap::const_iterator propertyIt = properties.begin(); propertyIt != properties.end(); propertyIt++)
+    {
+      const std::string & name  = propertyIt->first;
+      const std::string & value = propertyIt->second;
+
+      std::string token;
+      token.append("${");
+      token.append(name);
+      token.append("}");
+
+      ra::strings::Replace(output, token, value);
+    }
+
+    return output;
+  }
+
+  // A typical menu name with a few property references.
+  static const std::string MENU_NAME = "Open '${selection.filename}' from '${selection.parent.filename}' with ${bench.application}";
+
+  void RegisterBenchProperties(PropertyMap & properties, size_t count)
+  {
+    properties["selection.filename"]        = "notepad.exe";
+    properties["selection.parent.filename"] = "System32";
+    properties["bench.application"]         = "Notepad++";
+    for(size_t i=0; i<count; i++)
+    {
+      std::string name = "bench.property." + ra::strings::ToString(i);
+      properties[name] = "C:\\Program Files\\Bench\\" + ra::strings::ToString(i);
+    }
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ExpandPerProperty(benchmark::State & state)
+  {
+    PropertyMap properties;
+    RegisterBenchProperties(properties, (size_t)state.range(0));
+
+    for (auto _ : state)
+    {
+      std::string expanded = ExpandPerProperty(properties, MENU_NAME);
+      benchmark::DoNotOptimize(expanded);
+    }
+  }
+  BENCHMARK(BM_ExpandPerProperty)->Arg(10)->Arg(150)->Arg(1000);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_Expand(benchmark::State & state)
+  {
+    PropertyMap properties;
+    RegisterBenchProperties(properties, (size_t)state.range(0));
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.Clear();
+    for (PropertyMap::const_iterator propertyIt = properties.begin(); propertyIt != properties.end(); propertyIt++)
+    {
+      pmgr.SetProperty(propertyIt->first, propertyIt->second);
+    }
+
+    for (auto _ : state)
+    {
+      std::string expanded = pmgr.Expand(MENU_NAME);
+      benchmark::DoNotOptimize(expanded);
+    }
+
+    pmgr.Clear();
+  }
+  BENCHMARK(BM_Expand)->Arg(10)->Arg(150)->Arg(1000);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_LookupMap(benchmark::State & state)
+  {
+    // Previous implementation of the property storage: HasProperty() followed by GetProperty() on a std::map.
+    PropertyMap properties;
+    RegisterBenchProperties(properties, (size_t)state.range(0));
+    const std::string name = "bench.property." + ra::strings::ToString(state.range(0) / 2);
+
+    for (auto _ : state)
+    {
+      PropertyMap::const_iterator propertyIt = properties.find(name);
+      bool found = (propertyIt != properties.end());
+      benchmark::DoNotOptimize(found);
+      propertyIt = properties.find(name);
+      benchmark::DoNotOptimize(propertyIt->second);
+    }
+  }
+  BENCHMARK(BM_LookupMap)->Arg(100)->Arg(1000)->Arg(10000);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_LookupByName(benchmark::State & state)
+  {
+    PropertyMap properties;
+    RegisterBenchProperties(properties, (size_t)state.range(0));
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.Clear();
+    for (PropertyMap::const_iterator propertyIt = properties.begin(); propertyIt != properties.end(); propertyIt++)
+    {
+      pmgr.SetProperty(propertyIt->first, propertyIt->second);
+    }
+    const std::string name = "bench.property." + ra::strings::ToString(state.range(0) / 2);
+
+    for (auto _ : state)
+    {
+      bool found = pmgr.HasProperty(name);
+      benchmark::DoNotOptimize(found);
+      const std::string & value = pmgr.GetProperty(name);
+      benchmark::DoNotOptimize(value);
+    }
+
+    pmgr.Clear();
+  }
+  BENCHMARK(BM_LookupByName)->Arg(100)->Arg(1000)->Arg(10000);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_LookupById(benchmark::State & state)
+  {
+    PropertyMap properties;
+    RegisterBenchProperties(properties, (size_t)state.range(0));
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.Clear();
+    for (PropertyMap::const_iterator propertyIt = properties.begin(); propertyIt != properties.end(); propertyIt++)
+    {
+      pmgr.SetProperty(propertyIt->first, propertyIt->second);
+    }
+    const PropertyManager::PropertyId id = pmgr.GetPropertyId("bench.property." + ra::strings::ToString(state.range(0) / 2));
+
+    for (auto _ : state)
+    {
+      bool found = pmgr.HasProperty(id);
+      benchmark::DoNotOptimize(found);
+      const std::string & value = pmgr.GetProperty(id);
+      benchmark::DoNotOptimize(value);
+    }
+
+    pmgr.Clear();
+  }
+  BENCHMARK(BM_LookupById)->Arg(100)->Arg(1000)->Arg(10000);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_SetProperty(benchmark::State & state)
+  {
+    PropertyMap properties;
+    RegisterBenchProperties(properties, (size_t)state.range(0));
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.Clear();
+    for (PropertyMap::const_iterator propertyIt = properties.begin(); propertyIt != properties.end(); propertyIt++)
+    {
+      pmgr.SetProperty(propertyIt->first, propertyIt->second);
+    }
+    const std::string name = "bench.property." + ra::strings::ToString(state.range(0) / 2);
+    const std::string values[] = { "foo", "bar" };
+
+    // Each write publishes a new snapshot of the whole store.
+    size_t index = 0;
+    for (auto _ : state)
+    {
+      pmgr.SetProperty(name, values[index]);
+      index ^= 1;
+    }
+
+    pmgr.Clear();
+  }
+  BENCHMARK(BM_SetProperty)->Arg(100)->Arg(1000)->Arg(10000);
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace benchmarks
+} //namespace shellanything
@@ -0,0 +1,184 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "shellanything/WildcardPattern.h"
+#include "CaseFold.h"
+
+#include "rapidassist/strings.h"
+
+namespace shellanything { namespace benchmarks
+{
+  // Returns a list of paths with mixed case directories, filenames and file extensions.
+  std::vector<std::string> GetBenchPaths(size_t count)
+  {
+    static const char * directories[] = { "C:\\Program Files\\ShellAnything", "c:\\users\\bench\\Documents", "D:\\Projects\\Build\\Release", "\\\\server\\Shared\\Caf\xC3\xA9" };
+    static const char * extensions[] = { "txt", "TXT", "dll", "Exe", "xml", "jpeg" };
+    static const size_t num_directories = sizeof(directories) / sizeof(directories[0]);
+    static const size_t num_extensions = sizeof(extensions) / sizeof(extensions[0]);
+
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    for(size_t i=0; i<count; i++)
+    {
+      std::string path = directories[i % num_directories];
+      path += "\\File_" + ra::strings::ToString(i) + "." + extensions[i % num_extensions];
+      paths.push_back(path);
+    }
+    return paths;
+  }
+
+  // Returns the file extension of the given path, without the dot.
+  const char * GetBenchExtension(const std::string & path, size_t & length)
+  {
+    const size_t dot = path.rfind('.');
+    length = path.size() - dot - 1;
+    return path.c_str() + dot + 1;
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  static void BM_PatternUppercaseThenMatch(benchmark::State & state)
+  {
+    // Previous implementation: each path is copied in uppercase before being matched with an uppercase pattern.
+    const std::vector<std::string> paths = GetBenchPaths((size_t)state.range(0));
+    const WildcardPattern pattern(ra::strings::Uppercase("*\\Build\\*\\file_*.txt"));
+
+    for (auto _ : state)
+    {
+      size_t count = 0;
+      for(size_t i=0; i<paths.size(); i++)
+      {
+        const std::string path_uppercase = ra::strings::Uppercase(paths[i]);
+        if (pattern.Match(path_uppercase))
+          count++;
+      }
+      benchmark::DoNotOptimize(count);
+    }
+  }
+  BENCHMARK(BM_PatternUppercaseThenMatch)->Arg(100000)->Unit(benchmark::kMillisecond);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_PatternMatchNoCase(benchmark::State & state)
+  {
+    // The paths are compared in place by a case insensitive pattern.
+    const std::vector<std::string> paths = GetBenchPaths((size_t)state.range(0));
+    const WildcardPattern pattern("*\\Build\\*\\file_*.txt", false);
+
+    for (auto _ : state)
+    {
+      size_t count = 0;
+      for(size_t i=0; i<paths.size(); i++)
+      {
+        if (pattern.Match(paths[i]))
+          count++;
+      }
+      benchmark::DoNotOptimize(count);
+    }
+  }
+  BENCHMARK(BM_PatternMatchNoCase)->Arg(100000)->Unit(benchmark::kMillisecond);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ExtensionUppercaseThenCompare(benchmark::State & state)
+  {
+    // Previous implementation: each file extension is copied in uppercase before being compared.
+    const std::vector<std::string> paths = GetBenchPaths((size_t)state.range(0));
+    const std::string expected = "TXT";
+
+    for (auto _ : state)
+    {
+      size_t count = 0;
+      for(size_t i=0; i<paths.size(); i++)
+      {
+        size_t length = 0;
+        const char * extension = GetBenchExtension(paths[i], length);
+        if (ra::strings::Uppercase(std::string(extension, length)) == expected)
+          count++;
+      }
+      benchmark::DoNotOptimize(count);
+    }
+  }
+  BENCHMARK(BM_ExtensionUppercaseThenCompare)->Arg(100000)->Unit(benchmark::kMillisecond);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_ExtensionEqualsNoCase(benchmark::State & state)
+  {
+    // The file extensions are compared in place.
+    const std::vector<std::string> paths = GetBenchPaths((size_t)state.range(0));
+    const std::string expected = "TXT";
+
+    for (auto _ : state)
+    {
+      size_t count = 0;
+      for(size_t i=0; i<paths.size(); i++)
+      {
+        size_t length = 0;
+        const char * extension = GetBenchExtension(paths[i], length);
+        if (length == expected.size() && EqualsNoCase(extension, expected.c_str(), length))
+          count++;
+      }
+      benchmark::DoNotOptimize(count);
+    }
+  }
+  BENCHMARK(BM_ExtensionEqualsNoCase)->Arg(100000)->Unit(benchmark::kMillisecond);
+  //--------------------------------------------------------------------------------------------------
+
+  static void BM_PatternFlatMatch(benchmark::State & state)
+  {
+    // A pattern where '*' matches any character, including path separators.
+    const std::vector<std::string> paths = GetBenchPaths((size_t)state.range(0));
+    const WildcardPattern pattern("D:\\Projects\\*\\file_*.txt", false);
+
+    for (auto _ : state)
+    {
+      size_t count = 0;
+      for(size_t i=0; i<paths.size(); i++)
+      {
+        if (pattern.Match(paths[i]))
+          count++;
+      }
+      benchmark::DoNotOptimize(count);
+    }
+  }
+  BENCHMARK(BM_PatternFlatMatch)->Arg(100000)->Unit(benchmark::kMillisecond);
+  //--------------------------------------------------------------------------------------------------
+  static void BM_PatternGlobMatch(benchmark::State & state)
+  {
+    // The same rule as a path pattern, matched one path segment at a time.
+    const std::vector<std::string> paths = GetBenchPaths((size_t)state.range(0));
+    const WildcardPattern pattern("D:\\Projects\\**\\file_*.txt", false);
+
+    for (auto _ : state)
+    {
+      size_t count = 0;
+      for(size_t i=0; i<paths.size(); i++)
+      {
+        if (pattern.Match(paths[i]))
+          count++;
+      }
+      benchmark::DoNotOptimize(count);
+    }
+  }
+  BENCHMARK(BM_PatternGlobMatch)->Arg(100000)->Unit(benchmark::kMillisecond);
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace benchmarks
+} //namespace shellanything
@@ -26,6 +26,7 @@
 #define SA_ACTION_CLIPBOARD_H
 
 #include "shellanything/Action.h"
+#include "shellanything/PropertyTemplate.h"
 
 namespace shellanything
 {
@@ -57,7 +58,7 @@ namespace shellanything
     void SetValue(const std::string & iValue);
 
   private:
-    std::string mValue;
+    PropertyTemplate mValue;
   };
 
 } //namespace shellanything
@@ -26,6 +26,7 @@
 #define SA_ACTION_EXECUTE_H
 
 #include "shellanything/Action.h"
+#include "shellanything/PropertyTemplate.h"
 
 namespace shellanything
 {
@@ -77,9 +78,9 @@ namespace shellanything
     void SetArguments(const std::string & iArguments);
 
   private:
-    std::string mPath;
-    std::string mBaseDir;
-    std::string mArguments;
+    PropertyTemplate mPath;
+    PropertyTemplate mBaseDir;
+    PropertyTemplate mArguments;
   };
 
 } //namespace shellanything
@@ -26,6 +26,7 @@
 #define SA_ACTION_FILE_H
 
 #include "shellanything/Action.h"
+#include "shellanything/PropertyTemplate.h"
 
 namespace shellanything
 {
@@ -77,9 +78,9 @@ namespace shellanything
     void SetEncoding(const std::string & iEncoding);
 
   private:
-    std::string mPath;
-    std::string mText;
-    std::string mEncoding;
+    PropertyTemplate mPath;
+    PropertyTemplate mText;
+    PropertyTemplate mEncoding;
   };
 
 } //namespace shellanything
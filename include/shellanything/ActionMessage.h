@@ -26,6 +26,7 @@
 #define SA_ACTION_MESSAGE_H
 
 #include "shellanything/Action.h"
+#include "shellanything/PropertyTemplate.h"
 
 namespace shellanything
 {
@@ -77,9 +78,9 @@ namespace shellanything
     void SetIcon(const std::string & iIcon);
 
   private:
-    std::string mTitle;
-    std::string mCaption;
-    std::string mIcon;
+    PropertyTemplate mTitle;
+    PropertyTemplate mCaption;
+    PropertyTemplate mIcon;
   };
 
 } //namespace shellanything
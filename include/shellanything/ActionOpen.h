@@ -26,6 +26,7 @@
 #define SA_ACTION_OPEN_H
 
 #include "shellanything/Action.h"
+#include "shellanything/PropertyTemplate.h"
 
 namespace shellanything
 {
@@ -57,7 +58,7 @@ namespace shellanything
     void SetPath(const std::string & iPath);
 
   private:
-    std::string mPath;
+    PropertyTemplate mPath;
   };
 
 } //namespace shellanything
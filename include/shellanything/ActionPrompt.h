@@ -26,6 +26,7 @@
 #define SA_ACTION_PROMPT_H
 
 #include "shellanything/Action.h"
+#include "shellanything/PropertyTemplate.h"
 
 namespace shellanything
 {
@@ -120,9 +121,9 @@ namespace shellanything
 
   private:
     std::string mType;
-    std::string mName;
-    std::string mTitle;
-    std::string mDefault;
+    PropertyTemplate mName;
+    PropertyTemplate mTitle;
+    PropertyTemplate mDefault;
     std::string mValueYes;
     std::string mValueNo;
   };
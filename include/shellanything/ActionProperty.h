@@ -26,6 +26,7 @@
 #define SA_ACTION_PROPERTY_H
 
 #include "shellanything/Action.h"
+#include "shellanything/PropertyTemplate.h"
 
 namespace shellanything
 {
@@ -67,8 +68,8 @@ namespace shellanything
     void SetValue(const std::string & iValue);
 
   private:
-    std::string mName;
-    std::string mValue;
+    PropertyTemplate mName;
+    PropertyTemplate mValue;
   };
 
 
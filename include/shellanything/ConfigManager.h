@@ -60,6 +60,12 @@ namespace shellanything
     /// </summary>
     Configuration::ConfigurationPtrList GetConfigurations();
 
+    /// <summary>
+    /// Get a range over the Configuration pointers handled by the manager. The range does not allocate memory.
+    /// The range is invalidated by Clear() and Refresh().
+    /// </summary>
+    Configuration::ConfigurationRange GetConfigurationRange() const;
+
     /// <summary>
     /// Returns true if the given path is a Configuration loaded by the manager.
     /// </summary>
@@ -82,11 +88,29 @@ namespace shellanything
 
     /// <summary>
     /// Recursively calls Menu::update() on all menus loaded by the configuration manager.
+    /// The menus are validated by multiple threads if enabled with SetMaxUpdateThreads().
     /// </summary>
     void Update(const Context & c);
 
+    /// <summary>
+    /// Getter for the maximum number of threads that validate the menus in Update().
+    /// </summary>
+    size_t GetMaxUpdateThreads() const;
+
+    /// <summary>
+    /// Setter for the maximum number of threads that validate the menus in Update().
+    /// The validators of each menu are independent: the menus of all configurations are validated concurrently
+    /// and the visibility of the parent menus is resolved afterward, in order. The result is identical to a sequential update.
+    /// Useful when many validators query the file system. The default value is 1: the menus are validated by the calling thread.
+    /// The other threads are taken from a process-wide pool and are reused between updates.
+    /// </summary>
+    /// <param name="iMaxThreads">The maximum number of threads, including the calling thread. Set to 0 to use the number of hardware threads.</param>
+    void SetMaxUpdateThreads(size_t iMaxThreads);
+
     /// <summary>
     /// Finds a loaded Menu pointer that is assigned the command id iCommandId.
+    /// The lookup is resolved with the table built by the last call to AssignCommandIds().
+    /// The table is cleared when menus are added or removed: AssignCommandIds() must be called again.
     /// </summary>
     /// <param name="iCommandId">The search command id value.</param>
     /// <returns>Returns a Menu pointer if a match is found. Returns NULL otherwise.</returns>
@@ -94,6 +118,7 @@ namespace shellanything
 
     /// <summary>
     /// Assign unique command id to all menus loaded by the configuration manager.
+    /// Also builds the command id lookup table used by FindMenuByCommandId().
     /// </summary>
     /// <param name="iFirstCommandId">The first command id available.</param>
     /// <returns>Returns the next available command id. Returns iFirstCommandId if it failed assining command id.</returns>
@@ -111,9 +136,31 @@ namespace shellanything
     void AddSearchPath(const std::string & path);
 
   private:
+    /// <summary>
+    /// The parent node of the loaded configurations.
+    /// Clears the command id table of the manager when menus are added or removed, as the table may point to deleted menus.
+    /// </summary>
+    class ConfigurationRoot : public Node
+    {
+    public:
+      ConfigurationRoot();
+      void SetManager(ConfigManager * manager);
+    protected:
+      virtual void OnHierarchyChanged();
+    private:
+      ConfigManager * mManager;
+    };
+
+    void BuildCommandIdTable(const uint32_t & iFirstCommandId, const uint32_t & iNextCommandId);
+    void ClearCommandIdTable();
+    void UpdateParallel(const Context & c, size_t iNumThreads);
+
     //attributes
     PathList mPaths;
-    Node mConfigurations;
+    ConfigurationRoot mConfigurations;
+    uint32_t mFirstCommandId;
+    Menu::MenuPtrList mCommandIdTable; //indexed by (command_id - mFirstCommandId)
+    size_t mMaxUpdateThreads;
   };
 
 } //namespace shellanything
@@ -32,6 +32,7 @@
 
 namespace shellanything
 {
+  class MenuIndex;
 
   /// <summary>
   /// A configuration holds mutiple Menu instances.
@@ -44,6 +45,11 @@ namespace shellanything
     /// </summary>
     typedef std::vector<Configuration*> ConfigurationPtrList;
 
+    /// <summary>
+    /// A non-allocating range of Configuration pointers.
+    /// </summary>
+    typedef NodeRange<Configuration*> ConfigurationRange;
+
     Configuration();
     virtual ~Configuration();
 
@@ -89,7 +95,9 @@ namespace shellanything
     void SetFileModifiedDate(const uint64_t & iFileModifiedDate);
 
     /// <summary>
-    /// Recursively calls Menu::update() on all menus loaded by the configuration manager.
+    /// Updates all menus loaded by the configuration. Same as calling Menu::Update() on each menu.
+    /// The menus are updated with a linear sweep over a pre-order index of pointers to the menus.
+    /// A menu is only validated again if the properties or the facets of the context read by its validators changed since the previous update.
     /// </summary>
     void Update(const Context & c);
 
@@ -117,6 +125,11 @@ namespace shellanything
     /// </summary>
     Menu::MenuPtrList GetMenus();
 
+    /// <summary>
+    /// Get a range over the menus handled by the configuration. The range does not allocate memory.
+    /// </summary>
+    Menu::MenuRange GetMenuRange() const;
+
     /// <summary>
     /// Set a new DefaultSettings instance to the Configuration. The Configuration instance takes ownership of the instance.
     /// </summary>
@@ -129,8 +142,16 @@ namespace shellanything
     /// <returns>Returns the DefaultSettings instance of the Configuration. Returns NULL if no DefaultSettings is set.</returns>
     const DefaultSettings * GetDefaultSettings() const;
 
+  protected:
+    virtual void OnHierarchyChanged();
+
   private:
+    // The manager validates the menus of all configurations together. See ConfigManager::SetMaxUpdateThreads().
+    friend class ConfigManager;
+    MenuIndex & GetMenuIndex();
+
     DefaultSettings * mDefaults;
+    MenuIndex * mMenuIndex;
     uint64_t mFileModifiedDate;
     std::string mFilePath;
   };
@@ -30,9 +30,13 @@
 
 namespace shellanything
 {
+  class PropertyScope;
+  class SelectionIndex;
 
   /// <summary>
   /// A Context class holds a list of files and/or directories.
+  /// The 'selection.*' properties of the context are defined in a PropertyScope which overlays the global properties.
+  /// The value of a 'selection.*' property is computed when the property is first referenced and is cached by the context.
   /// </summary>
   class Context
   {
@@ -60,6 +64,8 @@ namespace shellanything
 
     /// <summary>
     /// Register a list of 'properties' based on the context elements.
+    /// The properties are registered globally. Prefer activating the scope returned by GetProperties()
+    /// which does not modify the global properties.
     /// </summary>
     void RegisterProperties() const;
 
@@ -68,6 +74,25 @@ namespace shellanything
     /// </summary>
     void UnregisterProperties() const;
 
+    /// <summary>
+    /// Get the scope which defines the 'selection.*' properties of the context.
+    /// Use PropertyManager::ActiveScope to resolve properties through the scope.
+    /// </summary>
+    const PropertyScope & GetProperties() const;
+
+    /// <summary>
+    /// Discards the cached values of the 'selection.*' properties of the context. The values are computed again on the next reference.
+    /// The separator of multiple selections is read from the property 'MULTI_SELECTION_SEPARATOR_PROPERTY_NAME' by this function:
+    /// the properties must be refreshed when the property is modified.
+    /// </summary>
+    void RefreshProperties() const;
+
+    /// <summary>
+    /// Get the precomputed information about the elements of the Context.
+    /// The information is computed once per list of elements and is shared by validators and properties.
+    /// </summary>
+    const SelectionIndex & GetSelectionIndex() const;
+
     /// <summary>
     /// Get the list of elements of the Context.
     /// </summary>
@@ -92,6 +117,8 @@ namespace shellanything
     ElementList mElements;
     int mNumFiles;
     int mNumDirectories;
+    SelectionIndex * mIndex;
+    PropertyScope * mProperties;
 
   };
 
@@ -25,6 +25,7 @@
 #ifndef SA_ICON_H
 #define SA_ICON_H
 
+#include "shellanything/PropertyTemplate.h"
 #include <string>
 #include <vector>
 
@@ -72,6 +73,11 @@ namespace shellanything
     /// </summary>
     void SetFileExtension(const std::string & iFileExtension);
 
+    /// <summary>
+    /// Get the compiled 'fileextension' parameter for property expansion.
+    /// </summary>
+    const PropertyTemplate & GetFileExtensionTemplate() const;
+
     /// <summary>
     /// Getter for the 'path' parameter.
     /// </summary>
@@ -82,6 +88,11 @@ namespace shellanything
     /// </summary>
     void SetPath(const std::string & iPath);
 
+    /// <summary>
+    /// Get the compiled 'path' parameter for property expansion.
+    /// </summary>
+    const PropertyTemplate & GetPathTemplate() const;
+
     /// <summary>
     /// Getter for the 'index' parameter.
     /// </summary>
@@ -93,8 +104,8 @@ namespace shellanything
     void SetIndex(const int & iIndex);
 
   private:
-    std::string mFileExtension;
-    std::string mPath;
+    PropertyTemplate mFileExtension;
+    PropertyTemplate mPath;
     int mIndex;
   };
 
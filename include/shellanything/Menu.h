@@ -29,12 +29,15 @@
 #include "shellanything/Icon.h"
 #include "shellanything/Validator.h"
 #include "shellanything/Action.h"
+#include "shellanything/PropertyTemplate.h"
 #include <string>
 #include <vector>
+#include <memory>
 #include <stdint.h>
 
 namespace shellanything
 {
+  class MenuIndex;
 
   /// <summary>
   /// The Menu class defines a displayed menu option.
@@ -47,6 +50,11 @@ namespace shellanything
     /// </summary>
     typedef std::vector<Menu*> MenuPtrList;
 
+    /// <summary>
+    /// A non-allocating range of Menu pointers.
+    /// </summary>
+    typedef NodeRange<Menu*> MenuRange;
+
     /// <summary>
     /// An invalid command id.
     /// </summary>
@@ -95,6 +103,11 @@ namespace shellanything
     /// </summary>
     void SetName(const std::string & iName);
 
+    /// <summary>
+    /// Get the compiled 'name' parameter for property expansion.
+    /// </summary>
+    const PropertyTemplate & GetNameTemplate() const;
+
     /// <summary>
     /// Getter for the 'max_length' parameter.
     /// </summary>
@@ -128,6 +141,11 @@ namespace shellanything
     /// </summary>
     void SetDescription(const std::string & iDescription);
 
+    /// <summary>
+    /// Get the compiled 'description' parameter for property expansion.
+    /// </summary>
+    const PropertyTemplate & GetDescriptionTemplate() const;
+
     /// <summary>
     /// Get this menu icon instance.
     /// </summary>
@@ -145,6 +163,13 @@ namespace shellanything
     /// <param name="c">The context used for updating the menu.</param>
     void Update(const Context & c);
 
+    /// <summary>
+    /// Updates the menu 'visible' and 'enabled' properties based on the given Context.
+    /// The submenus are not updated.
+    /// </summary>
+    /// <param name="c">The context used for updating the menu.</param>
+    void UpdateSelf(const Context & c);
+
     /// <summary>
     /// Searches this menu and submenus for a menu whose command id is iCommandId.
     /// </summary>
@@ -196,6 +221,7 @@ namespace shellanything
 
     /// <summary>
     /// Set the Validator for the 'validity' parameter.
+    /// Menus with identical validators share the same immutable instance.
     /// </summary>
     /// <param name="iValidity">Set the new Validator for the 'validity' parameter.</param>
     void SetValidity(const Validator & iValidity);
@@ -207,6 +233,7 @@ namespace shellanything
 
     /// <summary>
     /// Set the Validator for the 'visibility' parameter.
+    /// Menus with identical validators share the same immutable instance.
     /// </summary>
     /// <param name="iVisibility">Set the new Validator for the 'visibility' parameter.</param>
     void SetVisibility(const Validator & iVisibility);
@@ -227,17 +254,24 @@ namespace shellanything
     /// </summary>
     MenuPtrList GetSubMenus();
 
+    /// <summary>
+    /// Get a range over the submenus of the menu. The range does not allocate memory.
+    /// </summary>
+    MenuRange GetSubMenuRange() const;
+
   private:
+    friend class MenuIndex; // compares the validator instances of the menu
+
     Icon mIcon;
-    Validator mValidity;
-    Validator mVisibility;
+    std::shared_ptr<const Validator> mValidity;
+    std::shared_ptr<const Validator> mVisibility;
     bool mVisible;
     bool mEnabled;
     bool mSeparator;
     uint32_t mCommandId;
-    std::string mName;
+    PropertyTemplate mName;
     int mNameMaxLength;
-    std::string mDescription;
+    PropertyTemplate mDescription;
     Action::ActionPtrList mActions;
   };
 
@@ -27,9 +27,14 @@
 
 #include <string>
 #include <vector>
+#include <iterator>
+#include <cstddef>
 
 namespace shellanything
 {
+  template <typename T>
+  class NodeRange;
+
   /// <summary>
   /// A Node class for defining an object hierarchy
   /// </summary>
@@ -41,12 +46,29 @@ namespace shellanything
     /// </summary>
     typedef std::vector<Node*> NodePtrList;
 
+    /// <summary>
+    /// The kind of a node. Identifies the derived class of a node without comparing node-type strings.
+    /// </summary>
+    enum NODE_KIND
+    {
+      NODE_KIND_GENERIC,
+      NODE_KIND_MENU,
+      NODE_KIND_CONFIGURATION
+    };
+
     Node();
 
     /// <summary>
     /// Constructor for create a new Node instance with a 'type' node-type.
+    /// The kind of the node is NODE_KIND_GENERIC.
     /// </summary>
     Node(const std::string & type);
+
+    /// <summary>
+    /// Constructor for create a new Node instance with a 'type' node-type and a given kind.
+    /// Derived classes must use a kind that identifies their class.
+    /// </summary>
+    Node(const std::string & type, NODE_KIND kind);
     virtual ~Node();
 
   private:
@@ -60,6 +82,11 @@ namespace shellanything
     /// </summary>
     const std::string & GetNodeType() const;
 
+    /// <summary>
+    /// Getter for the kind of this node.
+    /// </summary>
+    NODE_KIND GetNodeKind() const;
+
     /// <summary>
     /// Get the parent of this node.
     /// </summary>
@@ -91,6 +118,23 @@ namespace shellanything
     /// <returns>Returns a list of Node pointer that matches the given node type.</returns>
     NodePtrList FindChildren(const std::string & type) const;
 
+    /// <summary>
+    /// Returns a range over the subnodes of the given kind. The range does not allocate memory.
+    /// T must be the pointer type of the class identified by the given kind.
+    /// The range is invalidated when subnodes are added or removed.
+    /// </summary>
+    /// <param name="kind">The given kind of node to iterate over.</param>
+    /// <returns>Returns a range of T pointers that matches the given node kind.</returns>
+    template <typename T>
+    NodeRange<T> GetChildren(NODE_KIND kind) const;
+
+    /// <summary>
+    /// Returns true if this node have at least one subnode of the given kind.
+    /// </summary>
+    /// <param name="kind">The given kind of node to search for.</param>
+    /// <returns>Returns true if a subnode matches the given node kind. Returns false otherwise.</returns>
+    bool HasChildren(NODE_KIND kind) const;
+
     /// <summary>
     /// Searches for the first node with a node-type 'type'.
     /// </summary>
@@ -156,12 +200,102 @@ namespace shellanything
     /// <returns>Returns the number of nodes (including itself) in this node's hierarchy.</returns>
     size_t Size() const;
 
+protected:
+    /// <summary>
+    /// Called when subnodes are added to or removed from this node or from one of its subnodes.
+    /// </summary>
+    virtual void OnHierarchyChanged();
+
+private:
+    void NotifyHierarchyChanged();
+
 protected:
     std::string mNodeType;
+    NODE_KIND mNodeKind;
     Node * mParent;
     NodePtrList mChildren;
   };
 
+  /// <summary>
+  /// A forward range over the subnodes of a node that are of a given kind.
+  /// The range only references the subnodes of the node, it does not copy or allocate.
+  /// </summary>
+  template <typename T>
+  class NodeRange
+  {
+  public:
+    typedef Node::NodePtrList::const_iterator NodePtrIterator;
+
+    class iterator
+    {
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef T value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const T * pointer;
+      typedef T reference;
+
+      iterator(NodePtrIterator it, NodePtrIterator end, Node::NODE_KIND kind) :
+        mIt(it),
+        mEnd(end),
+        mKind(kind)
+      {
+        SkipOtherKinds();
+      }
+
+      T operator*() const
+      {
+        //the kind of the node identifies its class
+        return static_cast<T>(*mIt);
+      }
+
+      iterator & operator++()
+      {
+        ++mIt;
+        SkipOtherKinds();
+        return (*this);
+      }
+
+      bool operator==(const iterator & other) const { return mIt == other.mIt; }
+      bool operator!=(const iterator & other) const { return mIt != other.mIt; }
+
+    private:
+      void SkipOtherKinds()
+      {
+        while(mIt != mEnd && (*mIt)->GetNodeKind() != mKind)
+        {
+          ++mIt;
+        }
+      }
+
+      NodePtrIterator mIt;
+      NodePtrIterator mEnd;
+      Node::NODE_KIND mKind;
+    };
+
+    NodeRange(const Node::NodePtrList & nodes, Node::NODE_KIND kind) :
+      mBegin(nodes.begin()),
+      mEnd(nodes.end()),
+      mKind(kind)
+    {
+    }
+
+    iterator begin() const { return iterator(mBegin, mEnd, mKind); }
+    iterator end()   const { return iterator(mEnd,   mEnd, mKind); }
+    bool empty() const { return begin() == end(); }
+
+  private:
+    NodePtrIterator mBegin;
+    NodePtrIterator mEnd;
+    Node::NODE_KIND mKind;
+  };
+
+  template <typename T>
+  inline NodeRange<T> Node::GetChildren(NODE_KIND kind) const
+  {
+    return NodeRange<T>(mChildren, kind);
+  }
+
   /// <summary>
   /// Utility fonctions for converting Node::NodePtrList to a vector of type T
   /// </summary>
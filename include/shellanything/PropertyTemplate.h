@@ -0,0 +1,126 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_PROPERTYTEMPLATE_H
+#define SA_PROPERTYTEMPLATE_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace shellanything
+{
+
+  /// <summary>
+  /// A PropertyTemplate holds a string value that may contain property references (`${variable-name}`).
+  /// The value is compiled once into a list of literal segments and property references.
+  /// Expanding a template is a simple concatenation of the segments: the value does not need to be scanned again.
+  /// The last expanded value is kept until one of the referenced properties is modified.
+  /// A template can be expanded by multiple threads at the same time.
+  /// </summary>
+  class PropertyTemplate
+  {
+  public:
+    PropertyTemplate();
+    PropertyTemplate(const std::string & value);
+    PropertyTemplate(const PropertyTemplate & t);
+    virtual ~PropertyTemplate();
+
+    /// <summary>
+    /// Copy operator
+    /// </summary>
+    const PropertyTemplate & operator =(const PropertyTemplate & t);
+
+    /// <summary>
+    /// Getter for the 'value' parameter. This is the string value before expansion.
+    /// </summary>
+    const std::string & GetValue() const;
+
+    /// <summary>
+    /// Setter for the 'value' parameter. The given value is compiled into segments.
+    /// </summary>
+    void SetValue(const std::string & iValue);
+
+    /// <summary>
+    /// Returns true if the template does not reference any property.
+    /// The expanded value of a literal template is always identical to its value.
+    /// </summary>
+    bool IsLiteral() const;
+
+    /// <summary>
+    /// Expands the template by replacing each property reference by the actual property's value.
+    /// The result is identical to calling PropertyManager::Expand() with the template's value.
+    /// The previous expanded value is returned if none of the referenced properties were modified since the last call.
+    /// </summary>
+    /// <returns>Returns a copy of the template's value with the property references expanded.</returns>
+    std::string Expand() const;
+
+    /// <summary>
+    /// Expands the template without allocating memory once the given buffer is large enough. See Expand().
+    /// A literal template returns its value without copying it.
+    /// </summary>
+    /// <param name="buffer">A buffer which receives the expanded value if the template references properties.</param>
+    /// <returns>Returns a reference to the expanded value: the template's value if the template is literal, the given buffer otherwise.
+    /// The reference is valid until the next call to SetValue() or until the buffer is modified.</returns>
+    const std::string & Expand(std::string & buffer) const;
+
+    /// <summary>
+    /// Get the names of the properties referenced by the template.
+    /// </summary>
+    /// <param name="names">The names of the referenced properties are appended to the list.</param>
+    void GetReferencedNames(std::vector<std::string> & names) const;
+
+  private:
+    void Compile();
+    bool IsExpandedValueOutdated(unsigned long long generation) const;
+    bool HasScopedReference() const;
+    void ExpandSegments(std::string & output) const;
+
+    /// <summary>
+    /// A part of the template's value. A segment is either a literal string or a property reference.
+    /// The offset and length of a segment are relative to the template's value.
+    /// For a property reference, the offset and length include the "${" and "}" characters.
+    /// </summary>
+    struct SEGMENT
+    {
+      size_t offset;
+      size_t length;
+      bool reference;
+      size_t id; // id of the referenced property. See PropertyManager::GetPropertyId().
+    };
+    typedef std::vector<SEGMENT> SegmentList;
+
+    std::string mValue;
+    SegmentList mSegments;
+
+    // Last expanded value and its generation number. See PropertyManager::GetGeneration().
+    // The expanded value is only used by a single thread at a time.
+    mutable std::mutex mExpandedMutex;
+    mutable std::string mExpandedValue;
+    mutable unsigned long long mExpandedGeneration;
+  };
+
+} //namespace shellanything
+
+#endif //SA_PROPERTYTEMPLATE_H
@@ -27,7 +27,10 @@
 
 #include "shellanything/Node.h"
 #include "shellanything/Context.h"
+#include "shellanything/PropertyTemplate.h"
+#include "shellanything/WildcardPattern.h"
 #include <string>
+#include <vector>
 
 namespace shellanything
 {
@@ -35,6 +38,22 @@ namespace shellanything
   class Validator
   {
   public:
+    typedef std::vector<size_t> PropertyIdList; // See PropertyManager::PropertyId
+
+    /// <summary>
+    /// The inputs read by Validate(). See GetDependencies().
+    /// </summary>
+    enum DEPENDENCY_FLAGS
+    {
+      DEPENDS_ON_COUNTS         = 0x01, // number of files and directories of the context
+      DEPENDS_ON_EXTENSIONS     = 0x02, // unique file extensions of the context
+      DEPENDS_ON_PATHS          = 0x04, // elements of the context
+      DEPENDS_ON_DRIVES         = 0x08, // drive letters, drive classes and number of elements of the context
+      DEPENDS_ON_PROPERTIES     = 0x10, // the properties listed by GetDependencies()
+      DEPENDS_ON_ALL_PROPERTIES = 0x20, // properties which are only known after expansion
+      DEPENDS_ON_FILESYSTEM     = 0x40, // files and directories which are not elements of the context
+    };
+
     Validator();
     Validator(const Validator & validator);
     virtual ~Validator();
@@ -145,22 +164,77 @@ namespace shellanything
     /// <returns>Returns true if the given context is valid against the set of constraints. Returns false otherwise.</returns>
     bool Validate(const Context & iContext) const;
 
+    /// <summary>
+    /// Get the inputs read by Validate(): the facets of the context and the properties.
+    /// The result of Validate() does not change as long as these inputs are not modified,
+    /// except for DEPENDS_ON_FILESYSTEM which depends on the current state of the file system.
+    /// </summary>
+    /// <param name="property_ids">The ids of the properties read by Validate() are appended to the list.</param>
+    /// <returns>Returns a combination of DEPENDENCY_FLAGS.</returns>
+    int GetDependencies(PropertyIdList & property_ids) const;
+
   private:
+    typedef std::vector<std::string> StringList;
+    typedef std::vector<size_t> PatternIdList; // See PatternSet::PatternId
+
+    /// <summary>
+    /// Flags of the attributes which are inversed. See IsInversed().
+    /// </summary>
+    enum INVERSE_FLAGS
+    {
+      INVERSE_MAXFILES        = 0x01,
+      INVERSE_MAXFOLDERS      = 0x02,
+      INVERSE_PROPERTIES      = 0x04,
+      INVERSE_FILEEXTENSIONS  = 0x08,
+      INVERSE_EXISTS          = 0x10,
+      INVERSE_CLASS           = 0x20,
+      INVERSE_PATTERN         = 0x40,
+    };
+
+    /// <summary>
+    /// The values of a 'class' attribute. The file extension filters ('.ext') are separated from the other classes.
+    /// </summary>
+    struct CLASS_LIST
+    {
+      StringList file_extensions; // uppercase, without the dot
+      StringList classes;
+    };
+
+    static void SplitList(const std::string & value, bool uppercase, StringList & values);
+    static void SplitPatterns(const std::string & value, WildcardPatternList & patterns);
+    static void SplitClass(const std::string & value, CLASS_LIST & class_list);
+    void UpdateInverseFlags();
+    static void AddPropertyDependencies(const StringList & names, int & dependencies, PropertyIdList & property_ids);
+
     bool ValidateProperties(const Context & context, const std::string & properties, bool inversed) const;
-    bool ValidateFileExtensions(const Context & context, const std::string & file_extensions, bool inversed) const;
-    bool ValidateExists(const Context & context, const std::string & file_exists, bool inversed) const;
-    bool ValidateClass(const Context & context, const std::string & class_, bool inversed) const;
+    bool ValidatePropertyIds(const PropertyIdList & ids, bool inversed) const;
+    bool ValidateFileExtensions(const Context & context, const StringList & file_extensions, bool inversed) const;
+    bool ValidateExists(const Context & context, const StringList & file_exists, bool inversed) const;
+    bool ValidateClass(const Context & context, const CLASS_LIST & class_list, bool inversed) const;
     bool ValidateClassSingle(const Context & context, const std::string & class_, bool inversed) const;
-    bool ValidatePattern(const Context & context, const std::string & pattern, bool inversed) const;
+    bool ValidatePattern(const Context & context, const WildcardPatternList & patterns, bool inversed) const;
+    bool ValidatePatternIds(const Context & context, const PatternIdList & ids, bool inversed) const;
 
   private:
+    // Compiled attributes, used on every validation.
+    // The lists of a literal attribute are split (and uppercased) once when the attribute is set.
+    // The lists of an attribute which references properties are built on each validation.
     int mMaxFiles;
     int mMaxDirectories;
-    std::string mProperties;
-    std::string mFileExtensions;
-    std::string mFileExists;
-    std::string mClass;
-    std::string mPattern;
+    int mInverseFlags; // See INVERSE_FLAGS
+    PropertyIdList mPropertyIds;
+    StringList mFileExtensionList;
+    StringList mFileExistsList;
+    CLASS_LIST mClassList;
+    WildcardPatternList mPatternList;
+    PatternIdList mPatternIds; // ids of mPatternList in the PatternSet, matched all at once per element
+
+    // Attribute values, as defined in the Configuration File
+    PropertyTemplate mProperties;
+    PropertyTemplate mFileExtensions;
+    PropertyTemplate mFileExists;
+    PropertyTemplate mClass;
+    PropertyTemplate mPattern;
     std::string mInverse;
   };
 
@@ -0,0 +1,141 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_WILDCARDPATTERN_H
+#define SA_WILDCARDPATTERN_H
+
+#include <string>
+#include <vector>
+
+namespace shellanything
+{
+
+  /// <summary>
+  /// A WildcardPattern holds a wildcard pattern (with '*' and '?' characters) compiled for matching many values.
+  /// The literal prefix, the literal suffix and the longest literal string of the pattern are identified once.
+  /// A value is rejected with simple comparisons of these literals before running the complete matcher.
+  /// For example, matching "*.TXT" is a comparison of the end of the value.
+  ///
+  /// A pattern which starts with the "glob:" prefix is a path pattern (glob) compiled into path segments, separated by '\\' or '/' characters:
+  /// a "**" segment matches any number of directories, '*' and '?' do not match a path separator
+  /// and "[abc]", "[a-z]" or "[!abc]" match a single character of a set.
+  /// A literal segment is compared with a single comparison to the corresponding segment of the value.
+  /// Other patterns keep the semantics of WildcardMatch(), where '[' is a literal character and "**" matches path separators.
+  /// </summary>
+  class WildcardPattern
+  {
+  public:
+    WildcardPattern();
+    WildcardPattern(const std::string & pattern);
+    WildcardPattern(const std::string & pattern, bool case_sensitive);
+    virtual ~WildcardPattern();
+
+    /// <summary>
+    /// Getter for the 'pattern' parameter. The pattern of a case insensitive WildcardPattern is in uppercase.
+    /// </summary>
+    const std::string & GetPattern() const;
+
+    /// <summary>
+    /// Setter for the 'pattern' parameter. The given pattern is compiled.
+    /// </summary>
+    void SetPattern(const std::string & iPattern);
+
+    /// <summary>
+    /// Returns true if the pattern is case sensitive.
+    /// A case insensitive pattern ignores the case of ASCII characters and compares the values in place, without uppercase copies.
+    /// </summary>
+    bool IsCaseSensitive() const;
+
+    /// <summary>
+    /// Returns true if the pattern is a path pattern (glob), which starts with the "glob:" prefix.
+    /// </summary>
+    bool IsGlob() const;
+
+    /// <summary>
+    /// Returns the longest string of literal characters which is found in every value matched by the pattern.
+    /// Returns an empty string if the pattern has no such string.
+    /// </summary>
+    std::string GetLongestLiteral() const;
+
+    /// <summary>
+    /// Returns true if the pattern matches the given value. The result is identical to WildcardMatch(), or WildcardMatchNoCase() if the pattern is not case sensitive.
+    /// </summary>
+    /// <param name="value">The value to match.</param>
+    /// <param name="length">The length of the value in bytes.</param>
+    /// <returns>Returns true if the pattern matches the given value. Returns false otherwise.</returns>
+    bool Match(const char * value, size_t length) const;
+
+    /// <summary>
+    /// Returns true if the pattern matches the given value. The result is identical to WildcardMatch(), or WildcardMatchNoCase() if the pattern is not case sensitive.
+    /// </summary>
+    bool Match(const std::string & value) const;
+
+  private:
+    /// <summary>
+    /// A path segment of a glob pattern.
+    /// </summary>
+    struct SEGMENT
+    {
+      enum KIND
+      {
+        SEGMENT_LITERAL,   // no wildcard characters
+        SEGMENT_WILDCARD,  // '*' or '?' characters
+        SEGMENT_SET,       // '[' characters, and maybe '*' or '?' characters
+        SEGMENT_GLOBSTAR,  // "**": any number of segments
+      };
+      KIND kind;
+      size_t offset;       // offset of the segment in the pattern
+      size_t length;       // length of the segment in the pattern, without the separator
+    };
+    typedef std::vector<SEGMENT> SegmentList;
+
+    void Compile();
+    void CompileGlob();
+    bool Equals(const char * a, const char * b, size_t length) const;
+    bool MatchGlob(const char * value, size_t length) const;
+    bool MatchSegment(const SEGMENT & segment, const char * value, size_t length) const;
+
+    std::string mPattern;
+    bool mCaseSensitive;
+    bool mWildcard;         // true if the pattern contains a wildcard character
+    bool mStar;             // true if the pattern contains a '*' character
+    bool mPrefixSuffixOnly; // true if the pattern is a literal prefix, a single '*' character and a literal suffix
+    size_t mMinLength;      // minimum length of a matching value: the number of characters which are not '*'
+    size_t mPrefixLength;   // length of the literal characters before the first wildcard character. For a glob pattern, length of the literal segments before the first wildcard character.
+    size_t mSuffixLength;   // length of the literal characters after the last wildcard character
+    size_t mLiteralOffset;  // offset of the longest literal string between the first and the last wildcard characters
+    size_t mLiteralLength;  // length of the longest literal string between the first and the last wildcard characters. 0 if none.
+    bool mGlob;             // true if the pattern is a path pattern
+    SegmentList mSegments;  // path segments of a glob pattern
+    size_t mLastGlobstar;   // index of the last "**" segment. (size_t)-1 if none.
+  };
+
+  /// <summary>
+  /// A list of WildcardPattern.
+  /// </summary>
+  typedef std::vector<WildcardPattern> WildcardPatternList;
+
+} //namespace shellanything
+
+#endif //SA_WILDCARDPATTERN_H
@@ -46,8 +46,7 @@ namespace shellanything
 
   bool ActionClipboard::Execute(const Context & iContext) const
   {
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-    std::string value = pmgr.Expand(mValue);
+    std::string value = mValue.Expand();
 
     //convert to windows unicode...
     std::wstring value_utf16 = ra::unicode::Utf8ToUnicode(value);
@@ -66,12 +65,12 @@ namespace shellanything
 
   const std::string & ActionClipboard::GetValue() const
   {
-    return mValue;
+    return mValue.GetValue();
   }
 
   void ActionClipboard::SetValue(const std::string & iValue)
   {
-    mValue = iValue;
+    mValue.SetValue(iValue);
   }
 
 } //namespace shellanything
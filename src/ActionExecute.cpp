@@ -47,10 +47,9 @@ namespace shellanything
 
   bool ActionExecute::Execute(const Context & iContext) const
   {
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-    std::string path = pmgr.Expand(mPath);
-    std::string basedir = pmgr.Expand(mBaseDir);
-    std::string arguments = pmgr.Expand(mArguments);
+    std::string path = mPath.Expand();
+    std::string basedir = mBaseDir.Expand();
+    std::string arguments = mArguments.Expand();
 
     bool basedir_missing = basedir.empty();
     bool arguments_missing = arguments.empty();
@@ -118,32 +117,32 @@ namespace shellanything
 
   const std::string & ActionExecute::GetPath() const
   {
-    return mPath;
+    return mPath.GetValue();
   }
 
   void ActionExecute::SetPath(const std::string & iPath)
   {
-    mPath = iPath;
+    mPath.SetValue(iPath);
   }
 
   const std::string & ActionExecute::GetBaseDir() const
   {
-    return mBaseDir;
+    return mBaseDir.GetValue();
   }
 
   void ActionExecute::SetBaseDir(const std::string & iBaseDir)
   {
-    mBaseDir = iBaseDir;
+    mBaseDir.SetValue(iBaseDir);
   }
 
   const std::string & ActionExecute::GetArguments() const
   {
-    return mArguments;
+    return mArguments.GetValue();
   }
 
   void ActionExecute::SetArguments(const std::string & iArguments)
   {
-    mArguments = iArguments;
+    mArguments.SetValue(iArguments);
   }
 
 } //namespace shellanything
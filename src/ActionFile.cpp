@@ -26,6 +26,7 @@
 #include "rapidassist/filesystem_utf8.h"
 #include "rapidassist/unicode.h"
 #include "PropertyManager.h"
+#include "PathTypeCache.h"
 
 #pragma warning( push )
 #pragma warning( disable: 4355 ) // glog\install_dir\include\glog/logging.h(1167): warning C4355: 'this' : used in base member initializer list
@@ -45,10 +46,9 @@ namespace shellanything
 
   bool ActionFile::Execute(const Context & iContext) const
   {
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-    const std::string path = pmgr.Expand(mPath);
-    std::string text = pmgr.Expand(mText);
-    const std::string encoding = pmgr.Expand(mEncoding);
+    const std::string path = mPath.Expand();
+    std::string text = mText.Expand();
+    const std::string encoding = mEncoding.Expand();
 
     //debug
     LOG(INFO) << "Writing file '" << path << "'.";
@@ -82,6 +82,7 @@ namespace shellanything
       write_ok = ra::filesystem::WriteTextFileUtf8(path, text);
     if (is_unicode)
       write_ok = ra::filesystem::WriteFileUtf8(path, text);
+    PathTypeCache::GetInstance().Invalidate(path);
     if (!write_ok)
     {
       LOG(ERROR) << "Failed writing content to file '" << path << "'.";
@@ -97,32 +98,32 @@ namespace shellanything
 
   const std::string & ActionFile::GetPath() const
   {
-    return mPath;
+    return mPath.GetValue();
   }
 
   void ActionFile::SetPath(const std::string & iPath)
   {
-    mPath = iPath;
+    mPath.SetValue(iPath);
   }
 
   const std::string & ActionFile::GetText() const
   {
-    return mText;
+    return mText.GetValue();
   }
 
   void ActionFile::SetText(const std::string & iText)
   {
-    mText = iText;
+    mText.SetValue(iText);
   }
 
   const std::string & ActionFile::GetEncoding() const
   {
-    return mEncoding;
+    return mEncoding.GetValue();
   }
 
   void ActionFile::SetEncoding(const std::string & iEncoding)
   {
-    mEncoding = iEncoding;
+    mEncoding.SetValue(iEncoding);
   }
 
 } //namespace shellanything
@@ -47,10 +47,9 @@ namespace shellanything
 
   bool ActionMessage::Execute(const Context & iContext) const
   {
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-    const std::string title = pmgr.Expand(mTitle);
-    const std::string caption = pmgr.Expand(mCaption);
-    const std::string icon = pmgr.Expand(mIcon);
+    const std::string title = mTitle.Expand();
+    const std::string caption = mCaption.Expand();
+    const std::string icon = mIcon.Expand();
 
     //convert to windows unicode...
     std::wstring title_utf16   = ra::unicode::Utf8ToUnicode(title);
@@ -88,32 +87,32 @@ namespace shellanything
 
   const std::string & ActionMessage::GetTitle() const
   {
-    return mTitle;
+    return mTitle.GetValue();
   }
 
   void ActionMessage::SetTitle(const std::string & iTitle)
   {
-    mTitle = iTitle;
+    mTitle.SetValue(iTitle);
   }
 
   const std::string & ActionMessage::GetCaption() const
   {
-    return mCaption;
+    return mCaption.GetValue();
   }
 
   void ActionMessage::SetCaption(const std::string & iCaption)
   {
-    mCaption = iCaption;
+    mCaption.SetValue(iCaption);
   }
 
   const std::string & ActionMessage::GetIcon() const
   {
-    return mIcon;
+    return mIcon.GetValue();
   }
 
   void ActionMessage::SetIcon(const std::string & iIcon)
   {
-    mIcon = iIcon;
+    mIcon.SetValue(iIcon);
   }
 
 } //namespace shellanything
@@ -78,8 +78,7 @@ namespace shellanything
 
   bool ActionOpen::Execute(const Context & iContext) const
   {
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-    std::string path = pmgr.Expand(mPath);
+    std::string path = mPath.Expand();
 
     //is path a file?
     if (ra::filesystem::FileExistsUtf8(path.c_str()))
@@ -112,12 +111,12 @@ namespace shellanything
 
   const std::string & ActionOpen::GetPath() const
   {
-    return mPath;
+    return mPath.GetValue();
   }
 
   void ActionOpen::SetPath(const std::string & iPath)
   {
-    mPath = iPath;
+    mPath.SetValue(iPath);
   }
 
 } //namespace shellanything
@@ -59,9 +59,9 @@ namespace shellanything
   bool ActionPrompt::Execute(const Context & iContext) const
   {
     PropertyManager & pmgr = PropertyManager::GetInstance();
-    const std::string name = pmgr.Expand(mName);
-    const std::string title = pmgr.Expand(mTitle);
-    const std::string default_value = pmgr.Expand(mDefault);
+    const std::string name = mName.Expand();
+    const std::string title = mTitle.Expand();
+    const std::string default_value = mDefault.Expand();
     const std::string & type = mType;
 
     static const char * caption = "Question / Prompt";
@@ -139,32 +139,32 @@ namespace shellanything
 
   const std::string & ActionPrompt::GetName() const
   {
-    return mName;
+    return mName.GetValue();
   }
 
   void ActionPrompt::SetName(const std::string & iName)
   {
-    mName = iName;
+    mName.SetValue(iName);
   }
 
   const std::string & ActionPrompt::GetTitle() const
   {
-    return mTitle;
+    return mTitle.GetValue();
   }
 
   void ActionPrompt::SetTitle(const std::string & iTitle)
   {
-    mTitle = iTitle;
+    mTitle.SetValue(iTitle);
   }
 
   const std::string & ActionPrompt::GetDefault() const
   {
-    return mDefault;
+    return mDefault.GetValue();
   }
 
   void ActionPrompt::SetDefault(const std::string & iDefault)
   {
-    mDefault = iDefault;
+    mDefault.SetValue(iDefault);
   }
 
   const std::string & ActionPrompt::GetValueYes() const
@@ -44,8 +44,8 @@ namespace shellanything
   bool ActionProperty::Execute(const Context & iContext) const
   {
     PropertyManager & pmgr = PropertyManager::GetInstance();
-    std::string name = pmgr.Expand(mName);
-    std::string value = pmgr.Expand(mValue);
+    std::string name = mName.Expand();
+    std::string value = mValue.Expand();
 
     //debug
     LOG(INFO) << "Setting property '" << name << "' to value '" << value << "'.";
@@ -56,7 +56,7 @@ namespace shellanything
     if (name == Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME)
     {
       // Force the context to rebuild selection.* properties.
-      iContext.RegisterProperties();
+      iContext.RefreshProperties();
     }
 
     return true;
@@ -64,22 +64,22 @@ namespace shellanything
 
   const std::string & ActionProperty::GetName() const
   {
-    return mName;
+    return mName.GetValue();
   }
 
   void ActionProperty::SetName(const std::string & iName)
   {
-    mName = iName;
+    mName.SetValue(iName);
   }
 
   const std::string & ActionProperty::GetValue() const
   {
-    return mValue;
+    return mValue.GetValue();
   }
 
   void ActionProperty::SetValue(const std::string & iValue)
   {
-    mValue = iValue;
+    mValue.SetValue(iValue);
   }
 
 } //namespace shellanything
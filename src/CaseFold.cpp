@@ -0,0 +1,110 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "CaseFold.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SA_CASEFOLD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace shellanything
+{
+
+#ifdef SA_CASEFOLD_SSE2
+  /// <summary>
+  /// Converts the ASCII lowercase characters of 16 bytes to uppercase.
+  /// </summary>
+  static inline __m128i ToUpperAscii16(__m128i value)
+  {
+    // Move 'a' to -128 (the lowest signed value). Then the lowercase characters are the 26 lowest signed values.
+    const __m128i shifted = _mm_add_epi8(value, _mm_set1_epi8((char)(0x80 - 'a')));
+    const __m128i lowercase = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(0x80 + ('z' - 'a' + 1))));
+    return _mm_sub_epi8(value, _mm_and_si128(lowercase, _mm_set1_epi8('a' - 'A')));
+  }
+#endif
+
+  std::string UppercaseAscii(const std::string & value)
+  {
+    std::string output = value;
+    for(size_t i=0; i<output.size(); i++)
+    {
+      output[i] = ToUpperAscii(output[i]);
+    }
+    return output;
+  }
+
+  bool EqualsNoCase(const char * a, const char * b, size_t length)
+  {
+    size_t i = 0;
+#ifdef SA_CASEFOLD_SSE2
+    for(; i+16 <= length; i+=16)
+    {
+      const __m128i a16 = ToUpperAscii16(_mm_loadu_si128((const __m128i *)(a + i)));
+      const __m128i b16 = ToUpperAscii16(_mm_loadu_si128((const __m128i *)(b + i)));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(a16, b16)) != 0xFFFF)
+        return false;
+    }
+#endif
+    for(; i<length; i++)
+    {
+      if (ToUpperAscii(a[i]) != ToUpperAscii(b[i]))
+        return false;
+    }
+    return true;
+  }
+
+  int CompareNoCase(const char * a, size_t a_length, const char * b, size_t b_length)
+  {
+    const size_t length = (a_length < b_length ? a_length : b_length);
+    for(size_t i=0; i<length; i++)
+    {
+      const unsigned char a_char = (unsigned char)ToUpperAscii(a[i]);
+      const unsigned char b_char = (unsigned char)ToUpperAscii(b[i]);
+      if (a_char != b_char)
+        return (a_char < b_char ? -1 : 1);
+    }
+    if (a_length == b_length)
+      return 0;
+    return (a_length < b_length ? -1 : 1);
+  }
+
+  bool HasLiteralNoCase(const char * value, size_t length, const char * literal, size_t literal_length)
+  {
+    if (literal_length == 0)
+      return true;
+    if (literal_length > length)
+      return false;
+
+    const char first = ToUpperAscii(literal[0]);
+    const size_t last = length - literal_length; // last position where the literal can start
+    for(size_t i=0; i<=last; i++)
+    {
+      if (ToUpperAscii(value[i]) == first && EqualsNoCase(value + i + 1, literal + 1, literal_length - 1))
+        return true;
+    }
+    return false;
+  }
+
+} //namespace shellanything
@@ -0,0 +1,75 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_CASEFOLD_H
+#define SA_CASEFOLD_H
+
+#include <string>
+
+namespace shellanything
+{
+  /// <summary>
+  /// Returns the uppercase value of an ASCII character.
+  /// Other characters, including the bytes of multi-byte utf-8 characters, are returned unchanged.
+  /// </summary>
+  inline char ToUpperAscii(char c)
+  {
+    if (c >= 'a' && c <= 'z')
+      return (char)(c - ('a' - 'A'));
+    return c;
+  }
+
+  /// <summary>
+  /// Returns a copy of the given string with the ASCII characters converted to uppercase.
+  /// The utf-8 encoded characters are unchanged, which keeps the string properly encoded.
+  /// </summary>
+  std::string UppercaseAscii(const std::string & value);
+
+  /// <summary>
+  /// Returns true if the given strings are equal, ignoring the case of ASCII characters.
+  /// The strings are compared in place, 16 bytes at a time when SSE2 is available.
+  /// </summary>
+  /// <param name="a">The first string.</param>
+  /// <param name="b">The second string.</param>
+  /// <param name="length">The length of both strings in bytes.</param>
+  bool EqualsNoCase(const char * a, const char * b, size_t length);
+
+  /// <summary>
+  /// Compares two strings, ignoring the case of ASCII characters.
+  /// </summary>
+  /// <returns>Returns a negative value if a is lower than b, 0 if the strings are equal and a positive value if a is greater than b.</returns>
+  int CompareNoCase(const char * a, size_t a_length, const char * b, size_t b_length);
+
+  /// <summary>
+  /// Returns true if the given literal string is found in the given value, ignoring the case of ASCII characters.
+  /// </summary>
+  /// <param name="value">The value to search.</param>
+  /// <param name="length">The length of the value in bytes.</param>
+  /// <param name="literal">The literal string to find.</param>
+  /// <param name="literal_length">The length of the literal string in bytes.</param>
+  bool HasLiteralNoCase(const char * value, size_t length, const char * literal, size_t literal_length);
+
+} //namespace shellanything
+
+#endif //SA_CASEFOLD_H
@@ -24,6 +24,9 @@
 
 #include "shellanything/ConfigManager.h"
 #include "shellanything/Menu.h"
+#include "ValidatorCache.h"
+#include "MenuIndex.h"
+#include "WorkerPool.h"
 
 #include "rapidassist/filesystem_utf8.h"
 #include "rapidassist/strings.h"
@@ -33,11 +36,34 @@
 #include <glog/logging.h>
 #pragma warning( pop )
 
+#include <thread>
+#include <atomic>
+
 namespace shellanything
 {
 
-  ConfigManager::ConfigManager()
+  ConfigManager::ConfigurationRoot::ConfigurationRoot() :
+    mManager(NULL)
+  {
+  }
+
+  void ConfigManager::ConfigurationRoot::SetManager(ConfigManager * manager)
+  {
+    mManager = manager;
+  }
+
+  void ConfigManager::ConfigurationRoot::OnHierarchyChanged()
+  {
+    //the table of command ids may point to removed menus
+    if (mManager)
+      mManager->ClearCommandIdTable();
+  }
+
+  ConfigManager::ConfigManager() :
+    mFirstCommandId(Menu::INVALID_COMMAND_ID),
+    mMaxUpdateThreads(1)
   {
+    mConfigurations.SetManager(this);
   }
 
   ConfigManager::~ConfigManager()
@@ -52,6 +78,7 @@ namespace shellanything
 
   void ConfigManager::Clear()
   {
+    ClearCommandIdTable();
     ClearSearchPath(); //remove all search path to make sure that a refresh wont find any other configuration file
     mConfigurations.RemoveChildren();
     Refresh(); //forces all loaded configurations to be unloaded
@@ -60,6 +87,9 @@ namespace shellanything
   void ConfigManager::Refresh()
   {
     LOG(INFO) << __FUNCTION__ << "()";
+
+    //configurations may be deleted or loaded, command ids must be assigned again
+    ClearCommandIdTable();
     
     //validate existing configurations
     Configuration::ConfigurationPtrList existing = GetConfigurations();
@@ -142,28 +172,124 @@ namespace shellanything
 
   void ConfigManager::Update(const Context & c)
   {
+    //evaluate identical validators once
+    ValidatorCache::UpdatePass update_pass;
+
+    size_t num_threads = mMaxUpdateThreads;
+    if (num_threads == 0)
+      num_threads = std::thread::hardware_concurrency();
+    if (num_threads > 1)
+    {
+      UpdateParallel(c, num_threads);
+      return;
+    }
+
     //for each child
-    Configuration::ConfigurationPtrList configurations = ConfigManager::GetConfigurations();
-    for(size_t i=0; i<configurations.size(); i++)
+    Configuration::ConfigurationRange configurations = GetConfigurationRange();
+    for(Configuration::ConfigurationRange::iterator configIt = configurations.begin(); configIt != configurations.end(); ++configIt)
     {
-      Configuration * config = configurations[i];
+      Configuration * config = (*configIt);
       config->Update(c);
     }
   }
 
-  Menu * ConfigManager::FindMenuByCommandId(const uint32_t & iCommandId)
+  /// <summary>
+  /// A menu to validate. See MenuIndex::ValidateMenu().
+  /// </summary>
+  struct UPDATE_TASK
   {
-    //for each child
-    Configuration::ConfigurationPtrList configurations = ConfigManager::GetConfigurations();
-    for(size_t i=0; i<configurations.size(); i++)
+    MenuIndex * index;
+    size_t position;
+  };
+  typedef std::vector<UPDATE_TASK> UpdateTaskList;
+
+  /// <summary>
+  /// Validates the menus of an update from multiple threads. See ConfigManager::UpdateParallel().
+  /// </summary>
+  class ValidateMenusJob : public WorkerPool::Job
+  {
+  public:
+    ValidateMenusJob(const UpdateTaskList & tasks, const Context & c) :
+      mTasks(tasks),
+      mContext(c),
+      mNext(0)
     {
-      Configuration * config = configurations[i];
-      Menu * match = config->FindMenuByCommandId(iCommandId);
-      if (match)
-        return match;
     }
- 
-    return NULL;
+
+    virtual void Execute()
+    {
+      // Each thread fetches the next menu until all menus are validated.
+      // The duration of the validators varies a lot between menus, idle threads take the remaining menus.
+      for(;;)
+      {
+        size_t i = mNext.fetch_add(1);
+        if (i >= mTasks.size())
+          return;
+        const UPDATE_TASK & task = mTasks[i];
+        task.index->ValidateMenu(task.position, mContext);
+      }
+    }
+
+  private:
+    const UpdateTaskList & mTasks;
+    const Context & mContext;
+    std::atomic<size_t> mNext;
+  };
+
+  void ConfigManager::UpdateParallel(const Context & c, size_t iNumThreads)
+  {
+    //find the outdated menus of all configurations
+    UpdateTaskList tasks;
+    Configuration::ConfigurationRange configurations = GetConfigurationRange();
+    for(Configuration::ConfigurationRange::iterator configIt = configurations.begin(); configIt != configurations.end(); ++configIt)
+    {
+      MenuIndex & index = (*configIt)->GetMenuIndex();
+      UPDATE_TASK task;
+      task.index = &index;
+      const size_t count = index.BeginUpdate(c);
+      for(task.position = 0; task.position < count; task.position++)
+      {
+        tasks.push_back(task);
+      }
+    }
+
+    size_t num_threads = iNumThreads;
+    if (num_threads > tasks.size())
+      num_threads = tasks.size();
+
+    //the current thread is also a worker.
+    //an exception thrown by a validator is thrown again here once all threads are done.
+    ValidateMenusJob job(tasks, c);
+    WorkerPool::GetInstance().Run(job, num_threads);
+
+    //resolve the visibility of the parent menus in order
+    for(Configuration::ConfigurationRange::iterator configIt = configurations.begin(); configIt != configurations.end(); ++configIt)
+    {
+      (*configIt)->GetMenuIndex().EndUpdate();
+    }
+  }
+
+  size_t ConfigManager::GetMaxUpdateThreads() const
+  {
+    return mMaxUpdateThreads;
+  }
+
+  void ConfigManager::SetMaxUpdateThreads(size_t iMaxThreads)
+  {
+    mMaxUpdateThreads = iMaxThreads;
+  }
+
+  Menu * ConfigManager::FindMenuByCommandId(const uint32_t & iCommandId)
+  {
+    if (iCommandId == Menu::INVALID_COMMAND_ID || iCommandId < mFirstCommandId)
+      return NULL;
+
+    //unsigned subtraction, ids before mFirstCommandId are rejected above
+    size_t index = (size_t)(iCommandId - mFirstCommandId);
+    if (index >= mCommandIdTable.size())
+      return NULL;
+
+    return mCommandIdTable[index];
   }
  
   uint32_t ConfigManager::AssignCommandIds(const uint32_t & iFirstCommandId)
@@ -171,22 +297,76 @@ namespace shellanything
     uint32_t nextCommandId = iFirstCommandId;
 
     //for each child
-    Configuration::ConfigurationPtrList configurations = ConfigManager::GetConfigurations();
-    for(size_t i=0; i<configurations.size(); i++)
+    Configuration::ConfigurationRange configurations = GetConfigurationRange();
+    for(Configuration::ConfigurationRange::iterator configIt = configurations.begin(); configIt != configurations.end(); ++configIt)
     {
-      Configuration * config = configurations[i];
+      Configuration * config = (*configIt);
       nextCommandId = config->AssignCommandIds(nextCommandId);
     }
+
+    BuildCommandIdTable(iFirstCommandId, nextCommandId);
  
     return nextCommandId;
   }
+
+  static void AddMenuCommandIds(Menu * menu, const uint32_t & iFirstCommandId, Menu::MenuPtrList & table)
+  {
+    //invisible menus and their submenus are not assigned a command id
+    const uint32_t & command_id = menu->GetCommandId();
+    if (command_id == Menu::INVALID_COMMAND_ID)
+      return;
+
+    size_t index = (size_t)(command_id - iFirstCommandId);
+    if (command_id >= iFirstCommandId && index < table.size())
+      table[index] = menu;
+
+    Menu::MenuRange subs = menu->GetSubMenuRange();
+    for(Menu::MenuRange::iterator subIt = subs.begin(); subIt != subs.end(); ++subIt)
+    {
+      AddMenuCommandIds((*subIt), iFirstCommandId, table);
+    }
+  }
+
+  void ConfigManager::BuildCommandIdTable(const uint32_t & iFirstCommandId, const uint32_t & iNextCommandId)
+  {
+    ClearCommandIdTable();
+    if (iFirstCommandId == Menu::INVALID_COMMAND_ID || iNextCommandId <= iFirstCommandId)
+      return;
+
+    mFirstCommandId = iFirstCommandId;
+    mCommandIdTable.resize(iNextCommandId - iFirstCommandId, NULL);
+
+    //for each child
+    Configuration::ConfigurationRange configurations = GetConfigurationRange();
+    for(Configuration::ConfigurationRange::iterator configIt = configurations.begin(); configIt != configurations.end(); ++configIt)
+    {
+      Menu::MenuRange menus = (*configIt)->GetMenuRange();
+      for(Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
+      {
+        AddMenuCommandIds((*menuIt), iFirstCommandId, mCommandIdTable);
+      }
+    }
+  }
+
+  void ConfigManager::ClearCommandIdTable()
+  {
+    //keep the allocated capacity, the table is rebuilt on every context menu query
+    mCommandIdTable.clear();
+    mFirstCommandId = Menu::INVALID_COMMAND_ID;
+  }
  
   Configuration::ConfigurationPtrList ConfigManager::GetConfigurations()
   {
-    Configuration::ConfigurationPtrList configurations = FilterNodes<Configuration*>(mConfigurations.FindChildren("Configuration"));
+    Configuration::ConfigurationRange range = GetConfigurationRange();
+    Configuration::ConfigurationPtrList configurations(range.begin(), range.end());
     return configurations;
   }
 
+  Configuration::ConfigurationRange ConfigManager::GetConfigurationRange() const
+  {
+    return mConfigurations.GetChildren<Configuration*>(Node::NODE_KIND_CONFIGURATION);
+  }
+
   void ConfigManager::ClearSearchPath()
   {
     mPaths.clear();
@@ -199,11 +379,11 @@ namespace shellanything
 
   bool ConfigManager::IsConfigFileLoaded(const std::string & path) const
   {
-    for(size_t i=0; i<mConfigurations.Size(); i++)
+    Configuration::ConfigurationRange configurations = GetConfigurationRange();
+    for(Configuration::ConfigurationRange::iterator configIt = configurations.begin(); configIt != configurations.end(); ++configIt)
     {
-      const Node * node = mConfigurations.GetChild(i);
-      const Configuration * config = dynamic_cast<const Configuration *>(node);
-      if (config != NULL && config->GetFilePath() == path)
+      const Configuration * config = (*configIt);
+      if (config->GetFilePath() == path)
         return true;
     }
     return false;
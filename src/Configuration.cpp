@@ -29,6 +29,7 @@
 #include "rapidassist/filesystem_utf8.h"
 #include "rapidassist/random.h"
 #include "ObjectFactory.h"
+#include "MenuIndex.h"
 
 #include "tinyxml2.h"
 
@@ -98,14 +99,17 @@ namespace shellanything
     return encoding;
   }
 
-  Configuration::Configuration() : Node("Configuration"),
+  Configuration::Configuration() : Node("Configuration", NODE_KIND_CONFIGURATION),
     mFileModifiedDate(0),
-    mDefaults(NULL)
+    mDefaults(NULL),
+    mMenuIndex(new MenuIndex())
   {
   }
 
   Configuration::~Configuration()
   {
+    delete mMenuIndex;
+    mMenuIndex = NULL;
   }
 
   Configuration * Configuration::LoadFile(const std::string & path, std::string & error)
@@ -282,13 +286,7 @@ namespace shellanything
 
   void Configuration::Update(const Context & c)
   {
-    //for each child
-    Menu::MenuPtrList children = GetMenus();
-    for(size_t i=0; i<children.size(); i++)
-    {
-      Menu * child = children[i];
-      child->Update(c);
-    }
+    GetMenuIndex().Update(c);
   }
 
   void Configuration::ApplyDefaultSettings()
@@ -330,40 +328,40 @@ namespace shellanything
 
   Menu * Configuration::FindMenuByCommandId(const uint32_t & iCommandId)
   {
-    //for each child
-    Menu::MenuPtrList children = GetMenus();
-    for(size_t i=0; i<children.size(); i++)
-    {
-      Menu * child = children[i];
-      Menu * match = child->FindMenuByCommandId(iCommandId);
-      if (match)
-        return match;
-    }
- 
-    return NULL;
+    return GetMenuIndex().FindMenuByCommandId(iCommandId);
   }
  
   uint32_t Configuration::AssignCommandIds(const uint32_t & iFirstCommandId)
   {
-    uint32_t nextCommandId = iFirstCommandId;
-
-    //for each child
-    Menu::MenuPtrList children = GetMenus();
-    for(size_t i=0; i<children.size(); i++)
-    {
-      Menu * child = children[i];
-      nextCommandId = child->AssignCommandIds(nextCommandId);
-    }
- 
+    uint32_t nextCommandId = GetMenuIndex().AssignCommandIds(iFirstCommandId);
     return nextCommandId;
   }
  
   Menu::MenuPtrList Configuration::GetMenus()
   {
-    Menu::MenuPtrList sub_menus = FilterNodes<Menu*>(this->FindChildren("Menu"));
+    Menu::MenuRange range = GetMenuRange();
+    Menu::MenuPtrList sub_menus(range.begin(), range.end());
     return sub_menus;
   }
 
+  Menu::MenuRange Configuration::GetMenuRange() const
+  {
+    return GetChildren<Menu*>(NODE_KIND_MENU);
+  }
+
+  MenuIndex & Configuration::GetMenuIndex()
+  {
+    //the index is built on first use after menus are added or removed
+    if (!mMenuIndex->IsValid())
+      mMenuIndex->Build(*this);
+    return (*mMenuIndex);
+  }
+
+  void Configuration::OnHierarchyChanged()
+  {
+    mMenuIndex->Invalidate();
+  }
+
   void Configuration::SetDefaultSettings(DefaultSettings * defaults)
   {
     if (mDefaults)
@@ -25,29 +25,153 @@
 #include "shellanything/Context.h"
 #include "shellanything/Validator.h"
 #include "PropertyManager.h"
+#include "PropertyScope.h"
 #include "DriveClass.h"
+#include "PathType.h"
+#include "SelectionIndex.h"
 
 #include "rapidassist/filesystem_utf8.h"
 #include "rapidassist/environment_utf8.h"
 
+#include <mutex>
+#include <atomic>
+
 namespace shellanything
 {
   const std::string Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME = "selection.multi.separator";
   const std::string Context::DEFAULT_MULTI_SELECTION_SEPARATOR = ra::environment::GetLineSeparator();
 
+  //${selection.path} is the full path of the clicked element
+  //${selection.parent.path} is the full path of the parent element
+  //${selection.parent.filename} is the filename of the parent element
+  //${selection.filename} is selection.filename (including file extension)
+  //${selection.filename_noext} is selection.filename without file extension
+  //${selection.filename.extension} is the file extension of the clicked element.
+  static std::string GetSelectionPath          (const SelectionIndex & index, size_t i, const std::string & element) { return element; }
+  static std::string GetSelectionParentPath    (const SelectionIndex & index, size_t i, const std::string & element) { return ra::filesystem::GetParentPath(element); }
+  static std::string GetSelectionParentFilename(const SelectionIndex & index, size_t i, const std::string & element) { return ra::filesystem::GetFilename(ra::filesystem::GetParentPath(element).c_str()); }
+  static std::string GetSelectionFilename      (const SelectionIndex & index, size_t i, const std::string & element) { return index.GetFilename(i); }
+  static std::string GetSelectionFilenameNoExt (const SelectionIndex & index, size_t i, const std::string & element) { return index.GetFilenameWithoutExtension(i); }
+  static std::string GetSelectionFilenameExt   (const SelectionIndex & index, size_t i, const std::string & element) { return index.GetFileExtension(i); }
+  static std::string GetSelectionDriveLetter   (const SelectionIndex & index, size_t i, const std::string & element) { return GetDriveLetter(element); }
+  static std::string GetSelectionDrivePath     (const SelectionIndex & index, size_t i, const std::string & element) { return GetDrivePath(element); }
+
+  // Properties defined by a context
+  typedef std::string (*SelectionFunction)(const SelectionIndex & index, size_t i, const std::string & element);
+  struct SELECTION_PROPERTY
+  {
+    const char * name;
+    SelectionFunction function; // computes the value of the property for a single element
+  };
+  static const SELECTION_PROPERTY SELECTION_PROPERTIES[] = {
+    {"selection.path"               , &GetSelectionPath          },
+    {"selection.parent.path"        , &GetSelectionParentPath    },
+    {"selection.parent.filename"    , &GetSelectionParentFilename},
+    {"selection.filename"           , &GetSelectionFilename      },
+    {"selection.filename.noext"     , &GetSelectionFilenameNoExt },
+    {"selection.filename.extension" , &GetSelectionFilenameExt   },
+    {"selection.drive.letter"       , &GetSelectionDriveLetter   },
+    {"selection.drive.path"         , &GetSelectionDrivePath     },
+  };
+  static const size_t NUM_SELECTION_PROPERTIES = sizeof(SELECTION_PROPERTIES)/sizeof(SELECTION_PROPERTIES[0]);
+
+  /// <summary>
+  /// Scope of the 'selection.*' properties of a Context.
+  /// The value of a property is computed when the property is first referenced and is cached until Invalidate() is called.
+  /// With a large selection, this prevents building the values of properties which are never referenced.
+  /// </summary>
+  class SelectionPropertyScope : public PropertyScope
+  {
+  public:
+    SelectionPropertyScope(const Context::ElementList & elements, const SelectionIndex & index) :
+      mElements(elements),
+      mIndex(index)
+    {
+      Invalidate(Context::DEFAULT_MULTI_SELECTION_SEPARATOR);
+    }
+
+    /// <summary>
+    /// Discards the computed values. Must not be called while another thread is using the scope.
+    /// </summary>
+    /// <param name="separator">The separator between the values of the elements of a multiple selection.</param>
+    void Invalidate(const std::string & separator)
+    {
+      // The separator is not read from the PropertyManager while a property is looked up.
+      mSeparator = separator;
+      for(size_t i=0; i<NUM_SELECTION_PROPERTIES; i++)
+      {
+        mValues[i].clear();
+        mComputed[i].store(false, std::memory_order_relaxed);
+      }
+    }
+
+  protected:
+    virtual const std::string * FindLocal(const char * name, size_t length) const
+    {
+      if (!mElements.empty())
+      {
+        for(size_t i=0; i<NUM_SELECTION_PROPERTIES; i++)
+        {
+          const char * selection_name = SELECTION_PROPERTIES[i].name;
+          if (strncmp(selection_name, name, length) == 0 && selection_name[length] == '\0')
+            return &GetValue(i);
+        }
+      }
+      return PropertyScope::FindLocal(name, length);
+    }
+
+  private:
+    const std::string & GetValue(size_t index) const
+    {
+      if (mComputed[index].load(std::memory_order_acquire))
+        return mValues[index];
+
+      // Multiple threads may reference the same property
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (!mComputed[index].load(std::memory_order_relaxed))
+      {
+        SelectionFunction function = SELECTION_PROPERTIES[index].function;
+        std::string & value = mValues[index];
+        for(size_t i=0; i<mElements.size(); i++)
+        {
+          // Add a separator between values
+          if (!value.empty())
+            value.append(mSeparator);
+          value.append(function(mIndex, i, mElements[i]));
+        }
+
+        mComputed[index].store(true, std::memory_order_release);
+      }
+      return mValues[index];
+    }
+
+    const Context::ElementList & mElements;
+    const SelectionIndex & mIndex;
+    std::string mSeparator;
+    mutable std::string mValues[NUM_SELECTION_PROPERTIES];
+    mutable std::atomic<bool> mComputed[NUM_SELECTION_PROPERTIES];
+    mutable std::mutex mMutex;
+  };
+
   Context::Context() :
     mNumFiles(0),
-    mNumDirectories(0)
+    mNumDirectories(0),
+    mIndex(new SelectionIndex(mElements)),
+    mProperties(new SelectionPropertyScope(mElements, *mIndex))
   {
   }
 
-  Context::Context(const Context & c)
+  Context::Context(const Context & c) :
+    mIndex(new SelectionIndex(mElements)),
+    mProperties(new SelectionPropertyScope(mElements, *mIndex))
   {
     (*this) = c;
   }
 
   Context::~Context()
   {
+    delete mProperties;
+    delete mIndex;
   }
 
   const Context & Context::operator =(const Context & c)
@@ -57,6 +181,9 @@ namespace shellanything
       mElements       = c.mElements;
       mNumFiles       = c.mNumFiles;
       mNumDirectories = c.mNumDirectories;
+      (*mProperties)  = (*c.mProperties);
+      mIndex->Invalidate();
+      RefreshProperties();
     }
     return (*this);
   }
@@ -65,87 +192,44 @@ namespace shellanything
   {
     PropertyManager & pmgr = PropertyManager::GetInstance();
    
-    const Context::ElementList & elements = GetElements();
- 
-    if (elements.empty())
+    if (mElements.empty())
       return; // Nothing to register
- 
-    std::string selection_path           ;
-    std::string selection_parent_path    ;
-    std::string selection_parent_filename;
-    std::string selection_filename       ;
-    std::string selection_filename_noext ;
-    std::string selection_filename_ext   ;
-    std::string selection_drive_letter   ;
-    std::string selection_drive_path     ;
-
-    // Get the separator string for multiple selection 
-    const std::string & selection_multi_separator = pmgr.GetProperty(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME);
-
-    // For each element
-    for(size_t i=0; i<elements.size(); i++)
+
+    // Make sure the properties are built with the current separator
+    RefreshProperties();
+
+    for(size_t i=0; i<NUM_SELECTION_PROPERTIES; i++)
     {
-      const std::string & element = elements[i];
- 
-      //${selection.path} is the full path of the clicked element
-      //${selection.parent.path} is the full path of the parent element
-      //${selection.parent.filename} is the filename of the parent element
-      //${selection.filename} is selection.filename (including file extension)
-      //${selection.filename_noext} is selection.filename without file extension
-      //${selection.filename.extension} is the file extension of the clicked element.
- 
-      //build properties for this specific element
-      std::string element_selection_path            = element;
-      std::string element_selection_parent_path     = ra::filesystem::GetParentPath(element_selection_path);
-      std::string element_selection_parent_filename = ra::filesystem::GetFilename(element_selection_parent_path.c_str());
-      std::string element_selection_filename        = ra::filesystem::GetFilename(element_selection_path.c_str());
-      std::string element_selection_filename_noext  = ra::filesystem::GetFilenameWithoutExtension(element_selection_path.c_str());
-      std::string element_selection_filename_ext    = ra::filesystem::GetFileExtention(element_selection_filename);
-      std::string element_selection_drive_letter    = GetDriveLetter(element);
-      std::string element_selection_drive_path      = GetDrivePath(element);
- 
-      // Add a separator between values
-      if (!selection_path           .empty()) selection_path            .append( selection_multi_separator );
-      if (!selection_parent_path    .empty()) selection_parent_path     .append( selection_multi_separator );
-      if (!selection_parent_filename.empty()) selection_parent_filename .append( selection_multi_separator );
-      if (!selection_filename       .empty()) selection_filename        .append( selection_multi_separator );
-      if (!selection_filename_noext .empty()) selection_filename_noext  .append( selection_multi_separator );
-      if (!selection_filename_ext   .empty()) selection_filename_ext    .append( selection_multi_separator );
-      if (!selection_drive_letter   .empty()) selection_drive_letter    .append( selection_multi_separator );
-      if (!selection_drive_path     .empty()) selection_drive_path      .append( selection_multi_separator );
-
-      // Append this specific element properties to the global property string
-      selection_path           .append( element_selection_path            );
-      selection_parent_path    .append( element_selection_parent_path     );
-      selection_parent_filename.append( element_selection_parent_filename );
-      selection_filename       .append( element_selection_filename        );
-      selection_filename_noext .append( element_selection_filename_noext  );
-      selection_filename_ext   .append( element_selection_filename_ext    );
-      selection_drive_letter   .append( element_selection_drive_letter    );
-      selection_drive_path     .append( element_selection_drive_path      );
+      const std::string name = SELECTION_PROPERTIES[i].name;
+      pmgr.SetProperty(name, mProperties->GetProperty(name));
     }
- 
-    pmgr.SetProperty("selection.path"               , selection_path           );
-    pmgr.SetProperty("selection.parent.path"        , selection_parent_path    );
-    pmgr.SetProperty("selection.parent.filename"    , selection_parent_filename);
-    pmgr.SetProperty("selection.filename"           , selection_filename       );
-    pmgr.SetProperty("selection.filename.noext"     , selection_filename_noext );
-    pmgr.SetProperty("selection.filename.extension" , selection_filename_ext   );
-    pmgr.SetProperty("selection.drive.letter"       , selection_drive_letter   );
-    pmgr.SetProperty("selection.drive.path"         , selection_drive_path     );
   }
  
   void Context::UnregisterProperties() const
   {
     PropertyManager & pmgr = PropertyManager::GetInstance();
-    pmgr.ClearProperty("selection.path"               );
-    pmgr.ClearProperty("selection.parent.path"        );
-    pmgr.ClearProperty("selection.parent.filename"    );
-    pmgr.ClearProperty("selection.filename"           );
-    pmgr.ClearProperty("selection.filename.noext"     );
-    pmgr.ClearProperty("selection.filename.extension" );
-    pmgr.ClearProperty("selection.drive.letter"       );
-    pmgr.ClearProperty("selection.drive.path"         );
+    for(size_t i=0; i<NUM_SELECTION_PROPERTIES; i++)
+    {
+      pmgr.ClearProperty(SELECTION_PROPERTIES[i].name);
+    }
+  }
+
+  const PropertyScope & Context::GetProperties() const
+  {
+    return (*mProperties);
+  }
+
+  void Context::RefreshProperties() const
+  {
+    // The values are computed again on the next reference, with the current separator
+    const std::string separator = PropertyManager::GetInstance().GetProperty(MULTI_SELECTION_SEPARATOR_PROPERTY_NAME);
+    SelectionPropertyScope * scope = static_cast<SelectionPropertyScope *>(mProperties);
+    scope->Invalidate(separator);
+  }
+
+  const SelectionIndex & Context::GetSelectionIndex() const
+  {
+    return (*mIndex);
   }
  
   const Context::ElementList & Context::GetElements() const
@@ -160,17 +244,19 @@ namespace shellanything
     mNumFiles = 0;
     mNumDirectories = 0;
 
-    // Update stats
-    for(size_t i=0; i<elements.size(); i++)
+    // Update stats. A single query per element, from multiple threads for large selections.
+    PathTypeList types;
+    GetPathTypes(elements, types);
+    for(size_t i=0; i<types.size(); i++)
     {
-      const std::string & element = elements[i];
-      bool isFile = ra::filesystem::FileExistsUtf8(element.c_str());
-      bool isDir  = ra::filesystem::DirectoryExistsUtf8(element.c_str());
-      if (isFile)
+      if (types[i] == PATH_TYPE_FILE)
         mNumFiles++;
-      if (isDir)
+      else if (types[i] == PATH_TYPE_DIRECTORY)
         mNumDirectories++;
     }
+
+    mIndex->Invalidate();
+    RefreshProperties();
   }
 
   int Context::GetNumFiles() const
@@ -24,8 +24,15 @@
 
 #include "DriveClass.h"
 #include "shellanything/Validator.h"
+#include "rapidassist/strings.h"
 
+#ifdef _WIN32
 #include <Windows.h>
+#endif
+
+#include <map>
+#include <mutex>
+#include <chrono>
 
 namespace shellanything
 {
@@ -76,6 +83,107 @@ namespace shellanything
     return false;
   }
 
+  /// <summary>
+  /// Queries the drive class from the operating system.
+  /// </summary>
+  class SystemDriveClassProvider : public DriveClassProvider
+  {
+  public:
+    virtual DRIVE_CLASS GetDriveClass(const std::string & path)
+    {
+#ifdef _WIN32
+      UINT dwDriveType = GetDriveTypeA(path.c_str());
+      switch(dwDriveType)
+      {
+      case DRIVE_REMOVABLE:
+        return DRIVE_CLASS_REMOVABLE;
+      case DRIVE_FIXED:
+        return DRIVE_CLASS_FIXED;
+      case DRIVE_REMOTE:
+        return DRIVE_CLASS_NETWORK;
+      case DRIVE_CDROM:
+        return DRIVE_CLASS_OPTICAL;
+      case DRIVE_RAMDISK:
+        return DRIVE_CLASS_RAMDISK;
+
+      default:
+        // The function GetDriveTypeA() returns DRIVE_NO_ROOT_DIR on a path that does not exist,
+        // if the given path is a file, or if the given path is a directory that is not the root directory.
+        return DRIVE_CLASS_UNKNOWN;
+      };
+#else
+      return DRIVE_CLASS_UNKNOWN;
+#endif
+    }
+  };
+
+  const uint32_t DRIVE_CLASS_DEFAULT_TIME_TO_LIVE = 5000;
+
+  typedef std::chrono::steady_clock DriveClassClock;
+
+  /// <summary>
+  /// A known drive class.
+  /// </summary>
+  struct DRIVE_CLASS_ENTRY
+  {
+    DRIVE_CLASS type;
+    DriveClassClock::time_point expiration;
+  };
+  typedef std::map<std::string, DRIVE_CLASS_ENTRY> DriveClassMap;
+
+  /// <summary>
+  /// Known drive classes, indexed by uppercase drive root path.
+  /// A drive letter may be remapped or a removable drive may be swapped: the classes are only remembered for a limited time.
+  /// </summary>
+  struct DRIVE_CLASS_CACHE
+  {
+    DRIVE_CLASS_CACHE() : provider(&system_provider), time_to_live(DRIVE_CLASS_DEFAULT_TIME_TO_LIVE) {}
+
+    std::mutex mutex;
+    DriveClassMap classes;
+    SystemDriveClassProvider system_provider;
+    DriveClassProvider * provider;
+    uint32_t time_to_live;
+  };
+
+  static DRIVE_CLASS_CACHE & GetDriveClassCache()
+  {
+    static DRIVE_CLASS_CACHE _cache;
+    return _cache;
+  }
+
+  void SetDriveClassProvider(DriveClassProvider * provider)
+  {
+    DRIVE_CLASS_CACHE & cache = GetDriveClassCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.provider = (provider != NULL ? provider : &cache.system_provider);
+    cache.classes.clear();
+  }
+
+  uint32_t GetDriveClassTimeToLive()
+  {
+    DRIVE_CLASS_CACHE & cache = GetDriveClassCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.time_to_live;
+  }
+
+  void SetDriveClassTimeToLive(uint32_t milliseconds)
+  {
+    DRIVE_CLASS_CACHE & cache = GetDriveClassCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.time_to_live = milliseconds;
+
+    // The known classes may have been queried with a longer time to live
+    cache.classes.clear();
+  }
+
+  void ClearDriveClassCache()
+  {
+    DRIVE_CLASS_CACHE & cache = GetDriveClassCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.classes.clear();
+  }
+
   DRIVE_CLASS GetDriveClassFromPath(const std::string & path)
   {
     // Patch for DRIVE_CLASS_NETWORK.
@@ -87,43 +195,49 @@ namespace shellanything
     if (IsNetworkPath(path))
       return DRIVE_CLASS_NETWORK;
 
-    UINT dwDriveType = GetDriveTypeA(path.c_str());
-    switch(dwDriveType)
+    DRIVE_CLASS_CACHE & cache = GetDriveClassCache();
+
+    // The function GetDriveTypeA() only identifies root paths. The drive class of a path is the drive class of its root path.
+    // The function also returns DRIVE_NO_ROOT_DIR for a non-existing path even if the drive letter is a CD-ROM or DVD-Drive.
+    std::string root_path = GetDrivePath(path);
+    if (root_path.empty())
     {
-    case DRIVE_NO_ROOT_DIR:
+      // There is nothing to share with other paths.
+      DriveClassProvider * provider = NULL;
       {
-        // The function GetDriveTypeA() returns DRIVE_NO_ROOT_DIR on a path that does not exist,
-        // if the given path is a file, or if the given path is a directory that is not the root directory.
-        // The functions returns DRIVE_NO_ROOT_DIR even if the drive letter, of the given non-existing path, is a CD-ROM or DVD-Drive.
-        // However, the function will return DRIVE_CDROM is the root path of the same path is used, even if there are no disk in the optical drive.
-        // To work around these issues, try to resolve with the root path of the drive.
-        std::string root_path = GetDrivePath(path);
-        if (root_path.empty() || // We may be dealing with a network path
-            root_path == path  ) // We are already using a root drive path
-        {
-          // There is nothing we can do.
-          return DRIVE_CLASS_UNKNOWN;
-        }
-        
-        // Try to resolve with the root path instead
-        DRIVE_CLASS resolved = GetDriveClassFromPath(root_path);
-        return resolved;
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        provider = cache.provider;
       }
-      break;
-    case DRIVE_REMOVABLE:
-      return DRIVE_CLASS_REMOVABLE;
-    case DRIVE_FIXED:
-      return DRIVE_CLASS_FIXED;
-    case DRIVE_REMOTE:
-      return DRIVE_CLASS_NETWORK;
-    case DRIVE_CDROM:
-      return DRIVE_CLASS_OPTICAL;
-    case DRIVE_RAMDISK:
-      return DRIVE_CLASS_RAMDISK;
+      return provider->GetDriveClass(path);
+    }
 
-    default:
-      return DRIVE_CLASS_UNKNOWN;
-    };
+    // Query each drive once per time to live
+    root_path = ra::strings::Uppercase(root_path);
+    DriveClassClock::time_point now = DriveClassClock::now();
+    DriveClassProvider * provider = NULL;
+    uint32_t time_to_live = 0;
+    {
+      std::lock_guard<std::mutex> lock(cache.mutex);
+      DriveClassMap::const_iterator classIt = cache.classes.find(root_path);
+      if (classIt != cache.classes.end() && now < classIt->second.expiration)
+        return classIt->second.type;
+      provider = cache.provider;
+      time_to_live = cache.time_to_live;
+    }
+
+    // Do not hold the lock while querying the operating system
+    DRIVE_CLASS resolved = provider->GetDriveClass(root_path);
+    if (time_to_live == 0)
+      return resolved;
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.provider == provider) // the provider may have been replaced while querying
+    {
+      DRIVE_CLASS_ENTRY & entry = cache.classes[root_path];
+      entry.type = resolved;
+      entry.expiration = now + std::chrono::milliseconds(time_to_live);
+    }
+    return resolved;
   }
 
   DRIVE_CLASS GetDriveClassFromString(const std::string & value)
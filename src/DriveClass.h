@@ -26,6 +26,7 @@
 #define SA_DRIVETYPES_H
 
 #include <string>
+#include <stdint.h>
 
 namespace shellanything
 {
@@ -66,11 +67,58 @@ namespace shellanything
 
   /// <summary>
   /// Returns the drive class based on the given path.
+  /// The class of a drive is queried once per drive root (for example "C:\") and is shared by all the paths of the same drive.
+  /// Network paths are identified without any query.
   /// </summary>
   /// <param name="path">The path to a valid file or directory.</param>
   /// <returns>Returns the drive class based on the given path. Returns DRIVE_CLASS_UNKNOWN if drive class cannot be found.</returns>
   DRIVE_CLASS GetDriveClassFromPath(const std::string & path);
 
+  /// <summary>
+  /// Abstract class which queries the drive class of a path from the operating system.
+  /// </summary>
+  class DriveClassProvider
+  {
+  public:
+    virtual ~DriveClassProvider() {}
+
+    /// <summary>
+    /// Returns the drive class of the given path.
+    /// </summary>
+    /// <param name="path">A drive root path (for example "C:\") or a path which is not mapped to a drive.</param>
+    /// <returns>Returns the drive class of the given path. Returns DRIVE_CLASS_UNKNOWN if drive class cannot be found.</returns>
+    virtual DRIVE_CLASS GetDriveClass(const std::string & path) = 0;
+  };
+
+  /// <summary>
+  /// Set the provider used by GetDriveClassFromPath() to query the operating system.
+  /// The provider is not owned and must outlive its use. The known drive classes are forgotten.
+  /// </summary>
+  /// <param name="provider">The new provider. Set to NULL to restore the operating system provider.</param>
+  void SetDriveClassProvider(DriveClassProvider * provider);
+
+  /// <summary>
+  /// Default time, in milliseconds, for which the class of a drive is remembered by GetDriveClassFromPath().
+  /// </summary>
+  extern const uint32_t DRIVE_CLASS_DEFAULT_TIME_TO_LIVE;
+
+  /// <summary>
+  /// Getter for the time, in milliseconds, for which the class of a drive is remembered by GetDriveClassFromPath().
+  /// </summary>
+  uint32_t GetDriveClassTimeToLive();
+
+  /// <summary>
+  /// Setter for the time, in milliseconds, for which the class of a drive is remembered by GetDriveClassFromPath().
+  /// A drive letter may be remapped, or a removable or network drive may be swapped, while the process is running.
+  /// A value of 0 disables the cache. The known drive classes are forgotten.
+  /// </summary>
+  void SetDriveClassTimeToLive(uint32_t milliseconds);
+
+  /// <summary>
+  /// Forgets the known drive classes. Must be called when a drive is mounted or unmounted.
+  /// </summary>
+  void ClearDriveClassCache();
+
   /// <summary>
   /// Returns the drive class based on the given string.
   /// The given string value must match one of the values returned by the ToString() function.
@@ -60,9 +60,9 @@ namespace shellanything
 
   bool Icon::IsValid() const
   {
-    if (!mFileExtension.empty())
+    if (!mFileExtension.GetValue().empty())
       return true;
-    if (mPath.empty() || mIndex == Icon::INVALID_ICON_INDEX)
+    if (mPath.GetValue().empty() || mIndex == Icon::INVALID_ICON_INDEX)
       return false;
     return true;
   }
@@ -70,8 +70,7 @@ namespace shellanything
   void Icon::ResolveFileExtensionIcon()
   {
     //is this menu have a file extension ?
-    shellanything::PropertyManager & pmgr = shellanything::PropertyManager::GetInstance();
-    std::string file_extension = pmgr.Expand(mFileExtension);
+    std::string file_extension = mFileExtension.Expand();
     if (!file_extension.empty())
     {
       //try to find the path to the icon module for the given file extension.
@@ -81,9 +80,9 @@ namespace shellanything
         //found the icon for the file extension
         //replace this menu's icon with the new information
         LOG(INFO) << "Resolving icon for file extension '" << file_extension << "' to file '" << resolved_icon.path << "' with index '" << resolved_icon.index << "'";
-        mPath = resolved_icon.path;
+        mPath.SetValue(resolved_icon.path);
         mIndex = resolved_icon.index;
-        mFileExtension = "";
+        mFileExtension.SetValue("");
       }
       else
       {
@@ -91,31 +90,41 @@ namespace shellanything
         //using the default "unknown" icon
         Win32Registry::REGISTRY_ICON unknown_file_icon = Win32Registry::GetUnknownFileTypeIcon();
         LOG(WARNING) << "Failed to find icon for file extension '" << file_extension << "'. Resolving icon with default icon for unknown file type '" << unknown_file_icon.path << "' with index '" << unknown_file_icon.index << "'";
-        mPath = unknown_file_icon.path;
+        mPath.SetValue(unknown_file_icon.path);
         mIndex = unknown_file_icon.index;
-        mFileExtension = "";
+        mFileExtension.SetValue("");
       }
     }
   }
 
   const std::string & Icon::GetFileExtension() const
   {
-    return mFileExtension;
+    return mFileExtension.GetValue();
   }
 
   void Icon::SetFileExtension(const std::string & iFileExtension)
   {
-    mFileExtension = iFileExtension;
+    mFileExtension.SetValue(iFileExtension);
+  }
+
+  const PropertyTemplate & Icon::GetFileExtensionTemplate() const
+  {
+    return mFileExtension;
   }
 
   const std::string & Icon::GetPath() const
   {
-    return mPath;
+    return mPath.GetValue();
   }
 
   void Icon::SetPath(const std::string & iPath)
   {
-    mPath = iPath;
+    mPath.SetValue(iPath);
+  }
+
+  const PropertyTemplate & Icon::GetPathTemplate() const
+  {
+    return mPath;
   }
 
   const int & Icon::GetIndex() const
@@ -23,6 +23,8 @@
  *********************************************************************************/
 
 #include "shellanything/Menu.h"
+#include "PropertyManager.h"
+#include "ValidatorCache.h"
 #include "Unicode.h"
 
 namespace shellanything
@@ -30,12 +32,14 @@ namespace shellanything
   const uint32_t Menu::INVALID_COMMAND_ID = 0;
   const int Menu::DEFAULT_NAME_MAX_LENGTH = 250;
 
-  Menu::Menu() : Node("Menu"),
+  Menu::Menu() : Node("Menu", NODE_KIND_MENU),
     mNameMaxLength(DEFAULT_NAME_MAX_LENGTH),
     mSeparator(false),
     mCommandId(INVALID_COMMAND_ID),
     mVisible(true),
-    mEnabled(true)
+    mEnabled(true),
+    mValidity(ValidatorCache::GetInstance().Intern(Validator())),
+    mVisibility(mValidity)
   {
   }
 
@@ -61,19 +65,23 @@ namespace shellanything
 
   bool Menu::IsParentMenu() const
   {
-    Menu::MenuPtrList sub_menus = FilterNodes<Menu*>(this->FindChildren("Menu"));
-    bool parent_menu = (sub_menus.size() != 0);
+    bool parent_menu = HasChildren(NODE_KIND_MENU);
     return parent_menu;
   }
 
   const std::string & Menu::GetName() const
   {
-    return mName;
+    return mName.GetValue();
   }
 
   void Menu::SetName(const std::string & iName)
   {
-    mName = iName;
+    mName.SetValue(iName);
+  }
+
+  const PropertyTemplate & Menu::GetNameTemplate() const
+  {
+    return mName;
   }
 
   const int & Menu::GetNameMaxLength() const
@@ -114,12 +122,17 @@ namespace shellanything
 
   const std::string & Menu::GetDescription() const
   {
-    return mDescription;
+    return mDescription.GetValue();
   }
 
   void Menu::SetDescription(const std::string & iDescription)
   {
-    mDescription = iDescription;
+    mDescription.SetValue(iDescription);
+  }
+
+  const PropertyTemplate & Menu::GetDescriptionTemplate() const
+  {
+    return mDescription;
   }
 
   const Icon & Menu::GetIcon() const
@@ -135,19 +148,17 @@ namespace shellanything
   void Menu::Update(const Context & c)
   {
     //update current menu
-    bool visible = mVisibility.Validate(c);
-    bool enabled = mValidity.Validate(c);
-    SetVisible(visible);
-    SetEnabled(enabled);
+    UpdateSelf(c);
+    bool visible = mVisible;
 
     //update children
     bool all_invisible_children = true;
 
     //for each child
-    Menu::MenuPtrList children = GetSubMenus();
-    for(size_t i=0; i<children.size(); i++)
+    Menu::MenuRange children = GetSubMenuRange();
+    for(Menu::MenuRange::iterator childIt = children.begin(); childIt != children.end(); ++childIt)
     {
-      Menu * child = children[i];
+      Menu * child = (*childIt);
       child->Update(c);
 
       //refresh the flag
@@ -156,23 +167,36 @@ namespace shellanything
 
     //Issue #4 - Parent menu with no children.
     //if all the direct children of this menu are invisible
-    if (IsParentMenu() && visible && all_invisible_children)
+    if (!children.empty() && visible && all_invisible_children)
     {
       //force this node as invisible.
       SetVisible(false);
     }
   }
 
+  void Menu::UpdateSelf(const Context & c)
+  {
+    //resolve properties through the context's scope
+    PropertyManager::ActiveScope active_scope(c.GetProperties());
+
+    //identical validators are evaluated once per update
+    ValidatorCache & cache = ValidatorCache::GetInstance();
+    bool visible = cache.Validate(*mVisibility, c);
+    bool enabled = cache.Validate(*mValidity, c);
+    SetVisible(visible);
+    SetEnabled(enabled);
+  }
+
   Menu * Menu::FindMenuByCommandId(const uint32_t & iCommandId)
   {
     if (mCommandId == iCommandId)
       return this;
  
     //for each child
-    Menu::MenuPtrList children = GetSubMenus();
-    for(size_t i=0; i<children.size(); i++)
+    Menu::MenuRange children = GetSubMenuRange();
+    for(Menu::MenuRange::iterator childIt = children.begin(); childIt != children.end(); ++childIt)
     {
-      Menu * child = children[i];
+      Menu * child = (*childIt);
       Menu * match = child->FindMenuByCommandId(iCommandId);
       if (match)
         return match;
@@ -198,10 +222,10 @@ namespace shellanything
     }
 
     //for each child
-    Menu::MenuPtrList children = GetSubMenus();
-    for(size_t i=0; i<children.size(); i++)
+    Menu::MenuRange children = GetSubMenuRange();
+    for(Menu::MenuRange::iterator childIt = children.begin(); childIt != children.end(); ++childIt)
     {
-      Menu * child = children[i];
+      Menu * child = (*childIt);
 
       if (mCommandId == INVALID_COMMAND_ID)
         child->AssignCommandIds(INVALID_COMMAND_ID); //also assign invalid ids to sub menus
@@ -244,30 +268,36 @@ namespace shellanything
 
   const Validator & Menu::GetValidity()
   {
-    return mValidity;
+    return (*mValidity);
   }
 
   void Menu::SetValidity(const Validator & iValidity)
   {
-    mValidity = iValidity;
+    mValidity = ValidatorCache::GetInstance().Intern(iValidity);
   }
 
   const Validator & Menu::GetVisibility()
   {
-    return mVisibility;
+    return (*mVisibility);
   }
 
   void Menu::SetVisibility(const Validator & iVisibility)
   {
-    mVisibility = iVisibility;
+    mVisibility = ValidatorCache::GetInstance().Intern(iVisibility);
   }
 
   Menu::MenuPtrList Menu::GetSubMenus()
   {
-    Menu::MenuPtrList sub_menus = FilterNodes<Menu*>(this->FindChildren("Menu"));
+    Menu::MenuRange range = GetSubMenuRange();
+    Menu::MenuPtrList sub_menus(range.begin(), range.end());
     return sub_menus;
   }
 
+  Menu::MenuRange Menu::GetSubMenuRange() const
+  {
+    return GetChildren<Menu*>(NODE_KIND_MENU);
+  }
+
   void Menu::AddAction(Action * action)
   {
     mActions.push_back(action);
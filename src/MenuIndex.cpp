@@ -0,0 +1,365 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "MenuIndex.h"
+#include "DriveClass.h"
+
+namespace shellanything
+{
+
+  MenuIndex::MenuIndex() :
+    mValid(false),
+    mDependencies(0),
+    mNumValidated(0),
+    mUpdating(false),
+    mGeneration(PropertyManager::INVALID_GENERATION)
+  {
+    mSelection.facets = 0;
+    mSelection.num_files = 0;
+    mSelection.num_directories = 0;
+    mSelection.num_elements = 0;
+    mSelection.num_drive_letters = 0;
+  }
+
+  MenuIndex::~MenuIndex()
+  {
+  }
+
+  void MenuIndex::Build(const Node & root)
+  {
+    Invalidate();
+
+    Menu::MenuRange menus = root.GetChildren<Menu*>(Node::NODE_KIND_MENU);
+    for(Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
+    {
+      AddMenu(*menuIt);
+    }
+
+    //remember the inputs of all validators
+    mStates.resize(mEntries.size());
+    for(size_t i=0; i<mEntries.size(); i++)
+    {
+      ResetState(i);
+    }
+
+    mValid = true;
+  }
+
+  size_t MenuIndex::AddMenu(Menu * menu)
+  {
+    //add the menu before its submenus
+    size_t index = mEntries.size();
+    ENTRY entry;
+    entry.menu = menu;
+    entry.size = 1;
+    mEntries.push_back(entry);
+
+    size_t size = 1;
+    Menu::MenuRange subs = menu->GetSubMenuRange();
+    for(Menu::MenuRange::iterator subIt = subs.begin(); subIt != subs.end(); ++subIt)
+    {
+      size += AddMenu(*subIt);
+    }
+
+    //push_back() may have moved the entries
+    mEntries[index].size = size;
+    return size;
+  }
+
+  void MenuIndex::ResetState(size_t index)
+  {
+    Menu * menu = mEntries[index].menu;
+    STATE & state = mStates[index];
+    state.visibility = menu->mVisibility;
+    state.validity = menu->mValidity;
+    state.first_property = mPropertyIds.size();
+    state.dependencies  = state.visibility->GetDependencies(mPropertyIds);
+    state.dependencies |= state.validity->GetDependencies(mPropertyIds);
+    state.num_properties = mPropertyIds.size() - state.first_property;
+    state.generation = PropertyManager::INVALID_GENERATION;
+    state.evaluated = false;
+    state.visible = false;
+    state.enabled = false;
+    state.final_visible = false;
+
+    mDependencies |= state.dependencies;
+  }
+
+  void MenuIndex::Invalidate()
+  {
+    mValid = false;
+    mEntries.clear();
+    mStates.clear();
+    mPropertyIds.clear();
+    mDependencies = 0;
+    mSelection.facets = 0;
+    mUpdating = false;
+  }
+
+  bool MenuIndex::IsValid() const
+  {
+    return mValid;
+  }
+
+  const MenuIndex::EntryList & MenuIndex::GetEntries() const
+  {
+    return mEntries;
+  }
+
+  size_t MenuIndex::GetNumValidated() const
+  {
+    return mNumValidated;
+  }
+
+  int MenuIndex::UpdateSelection(const Context & c)
+  {
+    //only remember the facets which are read by the validators
+    const SelectionIndex & index = c.GetSelectionIndex();
+    const int facets = mDependencies & (Validator::DEPENDS_ON_COUNTS | Validator::DEPENDS_ON_EXTENSIONS | Validator::DEPENDS_ON_PATHS | Validator::DEPENDS_ON_DRIVES);
+    int changed = (facets & ~mSelection.facets);
+
+    if (facets & Validator::DEPENDS_ON_COUNTS)
+    {
+      if (mSelection.num_files != c.GetNumFiles() || mSelection.num_directories != c.GetNumDirectories())
+        changed |= Validator::DEPENDS_ON_COUNTS;
+      mSelection.num_files = c.GetNumFiles();
+      mSelection.num_directories = c.GetNumDirectories();
+    }
+
+    if (facets & Validator::DEPENDS_ON_EXTENSIONS)
+    {
+      const SelectionIndex::ExtensionList & extensions = index.GetUniqueExtensions();
+      bool equals = (mSelection.extensions.size() == extensions.size());
+      for(size_t i=0; equals && i<extensions.size(); i++)
+      {
+        equals = (mSelection.extensions[i].count == extensions[i].count && mSelection.extensions[i].name == extensions[i].name);
+      }
+      if (!equals)
+      {
+        changed |= Validator::DEPENDS_ON_EXTENSIONS;
+        mSelection.extensions = extensions;
+      }
+    }
+
+    if (facets & Validator::DEPENDS_ON_PATHS)
+    {
+      if (mSelection.elements != c.GetElements())
+      {
+        changed |= Validator::DEPENDS_ON_PATHS;
+        mSelection.elements = c.GetElements();
+      }
+    }
+
+    if (facets & Validator::DEPENDS_ON_DRIVES)
+    {
+      static const size_t NUM_DRIVE_CLASSES = DRIVE_CLASS_RAMDISK + 1;
+      mSelection.drive_class_counts.resize(NUM_DRIVE_CLASSES, 0);
+
+      //the drive classes are compared to the number of elements
+      bool equals = (mSelection.num_elements == index.GetCount() && mSelection.num_drive_letters == index.GetNumDriveLetters());
+      mSelection.num_elements = index.GetCount();
+      mSelection.num_drive_letters = index.GetNumDriveLetters();
+      for(size_t i=0; i<NUM_DRIVE_CLASSES; i++)
+      {
+        size_t count = index.GetNumDriveClass((DRIVE_CLASS)i);
+        equals = equals && (mSelection.drive_class_counts[i] == count);
+        mSelection.drive_class_counts[i] = count;
+      }
+      if (!equals)
+        changed |= Validator::DEPENDS_ON_DRIVES;
+    }
+
+    mSelection.facets = facets;
+    return changed;
+  }
+
+  bool MenuIndex::IsOutdated(size_t index, int changed_facets) const
+  {
+    const STATE & state = mStates[index];
+    if (!state.evaluated)
+      return true;
+
+    //the file system may have changed since the previous update
+    if (state.dependencies & (changed_facets | Validator::DEPENDS_ON_FILESYSTEM))
+      return true;
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    if ((state.dependencies & Validator::DEPENDS_ON_ALL_PROPERTIES) && pmgr.GetGeneration() != state.generation)
+      return true;
+    for(size_t i=0; i<state.num_properties; i++)
+    {
+      if (pmgr.HasChanged(mPropertyIds[state.first_property + i], state.generation))
+        return true;
+    }
+
+    return false;
+  }
+
+  void MenuIndex::Update(const Context & c)
+  {
+    const size_t count = BeginUpdate(c);
+    for(size_t i=0; i<count; i++)
+    {
+      ValidateMenu(i, c);
+    }
+    EndUpdate();
+  }
+
+  size_t MenuIndex::BeginUpdate(const Context & c)
+  {
+    //the previous update was interrupted. Some menus were validated with a context that is not remembered.
+    if (mUpdating)
+    {
+      for(size_t i=0; i<mStates.size(); i++)
+      {
+        mStates[i].evaluated = false;
+      }
+    }
+    mUpdating = true;
+
+    const int changed_facets = UpdateSelection(c);
+
+    //properties modified while validating are seen as modified on the next update
+    mGeneration = PropertyManager::GetInstance().GetGeneration();
+
+    //validators do not depend on other menus, find the outdated ones in order
+    mOutdated.clear();
+    mChanged.assign(mEntries.size(), 0);
+    for(size_t i=0; i<mEntries.size(); i++)
+    {
+      Menu * menu = mEntries[i].menu;
+      STATE & state = mStates[i];
+
+      //the validators of the menu were replaced
+      if (state.visibility != menu->mVisibility || state.validity != menu->mValidity)
+        ResetState(i);
+
+      if (IsOutdated(i, changed_facets))
+        mOutdated.push_back(i);
+      else
+        menu->SetEnabled(state.enabled);
+    }
+
+    mNumValidated = mOutdated.size();
+    return mOutdated.size();
+  }
+
+  void MenuIndex::ValidateMenu(size_t position, const Context & c)
+  {
+    const size_t index = mOutdated[position];
+    Menu * menu = mEntries[index].menu;
+    STATE & state = mStates[index];
+
+    menu->UpdateSelf(c);
+    mChanged[index] = (!state.evaluated || state.visible != menu->IsVisible());
+    state.visible = menu->IsVisible();
+    state.enabled = menu->IsEnabled();
+    state.generation = mGeneration;
+    state.evaluated = true;
+  }
+
+  void MenuIndex::EndUpdate()
+  {
+    //Issue #4 - Parent menu with no children.
+    //sweep backward so that submenus are resolved before their parent.
+    //a menu is resolved again only if its own result or the visibility of one of its submenus changed.
+    size_t lowest_changed = mEntries.size(); //lowest index whose final visibility changed
+    for(size_t i=mEntries.size(); i>0; i--)
+    {
+      const size_t index = i-1;
+      const ENTRY & entry = mEntries[index];
+      STATE & state = mStates[index];
+
+      if (mChanged[index] || lowest_changed < index + entry.size)
+      {
+        bool visible = state.visible;
+        if (visible && entry.size > 1)
+        {
+          //if all the direct children of this menu are invisible
+          bool all_invisible_children = true;
+          const size_t end = index + entry.size;
+          for(size_t child = index + 1; child < end && all_invisible_children; child += mEntries[child].size)
+          {
+            all_invisible_children = !mStates[child].final_visible;
+          }
+
+          //force this node as invisible.
+          if (all_invisible_children)
+            visible = false;
+        }
+
+        if (mChanged[index] || visible != state.final_visible)
+          lowest_changed = index;
+        state.final_visible = visible;
+      }
+
+      entry.menu->SetVisible(state.final_visible);
+    }
+
+    mUpdating = false;
+  }
+
+  uint32_t MenuIndex::AssignCommandIds(const uint32_t & iFirstCommandId)
+  {
+    uint32_t nextCommandId = iFirstCommandId;
+
+    size_t i = 0;
+    while(i < mEntries.size())
+    {
+      const ENTRY & entry = mEntries[i];
+
+      //Issue #5 - ConfigManager::AssignCommandIds() should skip invisible menus
+      if (!entry.menu->IsVisible() || nextCommandId == Menu::INVALID_COMMAND_ID)
+      {
+        //invalidate this menu's command id and its submenus
+        const size_t end = i + entry.size;
+        for(; i < end; i++)
+        {
+          mEntries[i].menu->SetCommandId(Menu::INVALID_COMMAND_ID);
+        }
+      }
+      else
+      {
+        //assign a command id to this menu
+        entry.menu->SetCommandId(nextCommandId);
+        nextCommandId++;
+        i++;
+      }
+    }
+
+    return nextCommandId;
+  }
+
+  Menu * MenuIndex::FindMenuByCommandId(const uint32_t & iCommandId) const
+  {
+    for(size_t i=0; i<mEntries.size(); i++)
+    {
+      Menu * menu = mEntries[i].menu;
+      if (menu->GetCommandId() == iCommandId)
+        return menu;
+    }
+    return NULL;
+  }
+
+} //namespace shellanything
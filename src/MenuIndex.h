@@ -0,0 +1,199 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_MENUINDEX_H
+#define SA_MENUINDEX_H
+
+#include "shellanything/Menu.h"
+#include "shellanything/Context.h"
+#include "PropertyManager.h"
+#include "SelectionIndex.h"
+#include <vector>
+#include <stdint.h>
+
+namespace shellanything
+{
+  /// <summary>
+  /// A pre-order index of pointers to the menus of a node.
+  /// Each entry knows the size of its subtree: the submenus of the entry at index i are referenced at
+  /// [i+1, i+size) and the next sibling of the entry is referenced at i+size.
+  /// Menus are updated and assigned command ids with linear sweeps over the index instead of recursive calls.
+  /// The index does not own the menus: they stay heap objects owned by their parent node and are deleted one by one with it.
+  /// The index must be built again when menus are added or removed.
+  /// Updates are incremental: the index remembers the results of the validators of each menu and the inputs
+  /// they read (see Validator::GetDependencies()). A menu is only validated again when one of its inputs changed
+  /// since the previous update.
+  /// </summary>
+  class MenuIndex
+  {
+  public:
+    /// <summary>
+    /// A menu and the number of menus in its subtree, including itself.
+    /// </summary>
+    struct ENTRY
+    {
+      Menu * menu;
+      size_t size;
+    };
+    typedef std::vector<ENTRY> EntryList;
+
+    MenuIndex();
+    virtual ~MenuIndex();
+
+  private:
+    // Disable copy constructor and copy operator
+    MenuIndex(const MenuIndex&);
+    MenuIndex& operator=(const MenuIndex&);
+  public:
+
+    /// <summary>
+    /// Builds the index with all the menus (and their submenus) of the given node.
+    /// </summary>
+    /// <param name="root">The node that owns the menus.</param>
+    void Build(const Node & root);
+
+    /// <summary>
+    /// Marks the index as out of date. The entries are released.
+    /// </summary>
+    void Invalidate();
+
+    /// <summary>
+    /// Returns true if the index was built and was not invalidated since.
+    /// </summary>
+    bool IsValid() const;
+
+    /// <summary>
+    /// Get the entries of the index, in pre-order.
+    /// </summary>
+    const EntryList & GetEntries() const;
+
+    /// <summary>
+    /// Updates the 'visible' and 'enabled' properties of all indexed menus based on the given Context.
+    /// Produces the same result as calling Menu::Update() on each root menu.
+    /// Only the menus whose validators read a modified input are validated.
+    /// </summary>
+    /// <param name="c">The context used for updating the menus.</param>
+    void Update(const Context & c);
+
+    /// <summary>
+    /// Starts an update of the indexed menus in three steps which allows the menus to be validated by multiple threads.
+    /// Finds the menus which must be validated with the given context. The other menus keep their previous results.
+    /// Update() is the same as calling BeginUpdate(), ValidateMenu() for each position and EndUpdate().
+    /// </summary>
+    /// <param name="c">The context used for updating the menus. Must outlive EndUpdate().</param>
+    /// <returns>Returns the number of menus that must be validated by ValidateMenu().</returns>
+    size_t BeginUpdate(const Context & c);
+
+    /// <summary>
+    /// Validates a menu found by BeginUpdate(). Only the state of the given menu is modified:
+    /// distinct positions can be validated concurrently from multiple threads.
+    /// </summary>
+    /// <param name="position">The position of the menu, between 0 and the value returned by BeginUpdate().</param>
+    /// <param name="c">The context given to BeginUpdate().</param>
+    void ValidateMenu(size_t position, const Context & c);
+
+    /// <summary>
+    /// Completes the update started by BeginUpdate() once all the menus are validated.
+    /// Hides the parent menus with no visible submenus (issue #4).
+    /// If an update is not completed, for example because a validator has thrown, the next update validates all the menus.
+    /// </summary>
+    void EndUpdate();
+
+    /// <summary>
+    /// Assign unique command id to all visible indexed menus.
+    /// Produces the same result as calling Menu::AssignCommandIds() on each root menu.
+    /// </summary>
+    /// <param name="iFirstCommandId">The first command id available.</param>
+    /// <returns>Returns the next available command id.</returns>
+    uint32_t AssignCommandIds(const uint32_t & iFirstCommandId);
+
+    /// <summary>
+    /// Finds the indexed menu that is assigned the command id iCommandId.
+    /// </summary>
+    /// <param name="iCommandId">The search command id value.</param>
+    /// <returns>Returns a Menu pointer if a match is found. Returns NULL otherwise.</returns>
+    Menu * FindMenuByCommandId(const uint32_t & iCommandId) const;
+
+    /// <summary>
+    /// Returns the number of menus which were validated by the last call to Update().
+    /// </summary>
+    size_t GetNumValidated() const;
+
+  private:
+    /// <summary>
+    /// The remembered state of an indexed menu.
+    /// </summary>
+    struct STATE
+    {
+      std::shared_ptr<const Validator> visibility; // validators which the dependencies were computed for. Kept alive so that their address is not reused.
+      std::shared_ptr<const Validator> validity;
+      int dependencies;             // See Validator::DEPENDENCY_FLAGS
+      size_t first_property;        // properties of the validators in mPropertyIds
+      size_t num_properties;
+      PropertyManager::Generation generation; // generation of the properties when the validators were evaluated
+      bool evaluated;
+      bool visible;                 // result of the validators
+      bool enabled;
+      bool final_visible;           // visibility once the issue #4 rule is applied
+    };
+    typedef std::vector<STATE> StateList;
+
+    /// <summary>
+    /// The facets of the context of the previous update. See Validator::DEPENDENCY_FLAGS.
+    /// </summary>
+    struct SELECTION
+    {
+      int facets; // facets which are remembered
+      int num_files;
+      int num_directories;
+      SelectionIndex::ExtensionList extensions;
+      Context::ElementList elements;
+      size_t num_elements;
+      size_t num_drive_letters;
+      std::vector<size_t> drive_class_counts;
+    };
+
+    size_t AddMenu(Menu * menu);
+    void ResetState(size_t index);
+    bool IsOutdated(size_t index, int changed_facets) const;
+    int UpdateSelection(const Context & c);
+
+    bool mValid;
+    EntryList mEntries;
+    StateList mStates;
+    Validator::PropertyIdList mPropertyIds;
+    int mDependencies; // dependencies of all the indexed menus
+    SELECTION mSelection;
+    size_t mNumValidated;
+
+    //the update in progress
+    bool mUpdating;                 // true between BeginUpdate() and EndUpdate()
+    std::vector<size_t> mOutdated;  // indexes of the menus to validate
+    std::vector<char> mChanged;     // true if the result of the validators changed, per menu. Written by multiple threads.
+    PropertyManager::Generation mGeneration;
+  };
+
+} //namespace shellanything
+
+#endif //SA_MENUINDEX_H
@@ -30,11 +30,20 @@ namespace shellanything
 {
 
   Node::Node() :
+    mNodeKind(NODE_KIND_GENERIC),
     mParent(NULL)
   {
   }
 
   Node::Node(const std::string & type) :
+    mNodeKind(NODE_KIND_GENERIC),
+    mParent(NULL)
+  {
+    mNodeType = type;
+  }
+
+  Node::Node(const std::string & type, NODE_KIND kind) :
+    mNodeKind(kind),
     mParent(NULL)
   {
     mNodeType = type;
@@ -57,6 +66,11 @@ namespace shellanything
     return mNodeType;
   }
 
+  Node::NODE_KIND Node::GetNodeKind() const
+  {
+    return mNodeKind;
+  }
+
   Node * Node::GetParent() const
   {
     return mParent;
@@ -71,6 +85,7 @@ namespace shellanything
 
     child->mParent = this;
     mChildren.push_back(child);
+    NotifyHierarchyChanged();
 
     return child;
   }
@@ -84,6 +99,7 @@ namespace shellanything
       Node * node = (*it);
       mChildren.erase(it);
       delete node;
+      NotifyHierarchyChanged();
       return true;
     }
     return false;
@@ -106,6 +122,17 @@ namespace shellanything
     return nodes;
   }
 
+  bool Node::HasChildren(NODE_KIND kind) const
+  {
+    for(size_t i=0; i<mChildren.size(); i++) 
+    {
+      Node * n = mChildren[i];
+      if (n->mNodeKind == kind)
+        return true;
+    }
+    return false;
+  }
+
   Node * Node::FindFirst(const std::string & type) const
   {
     for(size_t i=0; i<mChildren.size(); i++) 
@@ -139,6 +166,7 @@ namespace shellanything
       Node * node = mChildren[index];
       mChildren.erase(mChildren.begin() + index);
       delete node;
+      NotifyHierarchyChanged();
       return true;
     }
     return false;
@@ -199,4 +227,17 @@ namespace shellanything
     return total;
   }
 
+  void Node::OnHierarchyChanged()
+  {
+  }
+
+  void Node::NotifyHierarchyChanged()
+  {
+    //notify this node and all its ancestors
+    for(Node * node = this; node != NULL; node = node->mParent)
+    {
+      node->OnHierarchyChanged();
+    }
+  }
+
 } //namespace shellanything
@@ -0,0 +1,136 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "PathType.h"
+#include "WorkerPool.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include "rapidassist/unicode.h"
+#else
+#include <sys/stat.h>
+#endif
+
+#include <thread>
+#include <atomic>
+
+namespace shellanything
+{
+  // Maximum number of threads used by GetPathTypes(), including the calling thread
+  static const size_t MAX_PATH_TYPE_THREADS = 8;
+
+  // Number of paths queried by a worker before fetching more work
+  static const size_t PATH_TYPE_BATCH_SIZE = 32;
+
+  static std::atomic<PathTypeProvider *> & GetPathTypeProvider()
+  {
+    // NULL selects the file system
+    static std::atomic<PathTypeProvider *> _provider(NULL);
+    return _provider;
+  }
+
+  void SetPathTypeProvider(PathTypeProvider * provider)
+  {
+    GetPathTypeProvider().store(provider);
+  }
+
+  PATH_TYPE GetPathType(const std::string & path)
+  {
+    PathTypeProvider * provider = GetPathTypeProvider().load();
+    if (provider != NULL)
+      return provider->GetPathType(path);
+
+#ifdef _WIN32
+    std::wstring path_utf16 = ra::unicode::Utf8ToUnicode(path);
+    DWORD attributes = GetFileAttributesW(path_utf16.c_str());
+    if (attributes == INVALID_FILE_ATTRIBUTES)
+      return PATH_TYPE_MISSING;
+    if (attributes & FILE_ATTRIBUTE_DIRECTORY)
+      return PATH_TYPE_DIRECTORY;
+    return PATH_TYPE_FILE;
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+      return PATH_TYPE_MISSING;
+    if (S_ISDIR(info.st_mode))
+      return PATH_TYPE_DIRECTORY;
+    if (S_ISREG(info.st_mode))
+      return PATH_TYPE_FILE;
+    return PATH_TYPE_MISSING;
+#endif
+  }
+
+  /// <summary>
+  /// Queries the type of paths by batches from multiple threads. See GetPathTypes().
+  /// </summary>
+  class PathTypesJob : public WorkerPool::Job
+  {
+  public:
+    PathTypesJob(const std::vector<std::string> & paths, PathTypeList & types) :
+      mPaths(paths),
+      mTypes(types),
+      mNext(0)
+    {
+    }
+
+    virtual void Execute()
+    {
+      // Each thread fetches batches of paths until all paths are queried
+      for(;;)
+      {
+        size_t first = mNext.fetch_add(PATH_TYPE_BATCH_SIZE);
+        if (first >= mPaths.size())
+          return;
+        size_t last = first + PATH_TYPE_BATCH_SIZE;
+        if (last > mPaths.size())
+          last = mPaths.size();
+        for(size_t i=first; i<last; i++)
+        {
+          mTypes[i] = GetPathType(mPaths[i]);
+        }
+      }
+    }
+
+  private:
+    const std::vector<std::string> & mPaths;
+    PathTypeList & mTypes;
+    std::atomic<size_t> mNext;
+  };
+
+  void GetPathTypes(const std::vector<std::string> & paths, PathTypeList & types)
+  {
+    types.assign(paths.size(), PATH_TYPE_MISSING);
+
+    size_t num_threads = std::thread::hardware_concurrency();
+    if (num_threads > MAX_PATH_TYPE_THREADS)
+      num_threads = MAX_PATH_TYPE_THREADS;
+    if (paths.size() < PATH_TYPE_PARALLEL_THRESHOLD)
+      num_threads = 1;
+
+    // The current thread is also a worker
+    PathTypesJob job(paths, types);
+    WorkerPool::GetInstance().Run(job, num_threads);
+  }
+
+} //namespace shellanything
@@ -0,0 +1,88 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_PATHTYPE_H
+#define SA_PATHTYPE_H
+
+#include <string>
+#include <vector>
+
+namespace shellanything
+{
+
+  enum PATH_TYPE
+  {
+    PATH_TYPE_MISSING,
+    PATH_TYPE_FILE,
+    PATH_TYPE_DIRECTORY
+  };
+  typedef std::vector<PATH_TYPE> PathTypeList;
+
+  /// <summary>
+  /// Minimum number of paths for GetPathTypes() to query the paths from multiple threads.
+  /// </summary>
+  static const size_t PATH_TYPE_PARALLEL_THRESHOLD = 256;
+
+  /// <summary>
+  /// Returns the type of the given path with a single query of the file system metadata.
+  /// </summary>
+  /// <param name="path">The path to a file or directory, encoded in utf-8.</param>
+  /// <returns>Returns PATH_TYPE_FILE or PATH_TYPE_DIRECTORY if the path exists. Returns PATH_TYPE_MISSING otherwise.</returns>
+  PATH_TYPE GetPathType(const std::string & path);
+
+  /// <summary>
+  /// Returns the type of each given path. See GetPathType().
+  /// When the number of paths is at least PATH_TYPE_PARALLEL_THRESHOLD, the paths are also queried by the threads of the WorkerPool.
+  /// This reduces the total latency of the queries, especially on network shares.
+  /// </summary>
+  /// <param name="paths">The paths to files or directories, encoded in utf-8.</param>
+  /// <param name="types">The output type of each path. The list is resized to the number of paths.</param>
+  void GetPathTypes(const std::vector<std::string> & paths, PathTypeList & types);
+
+  /// <summary>
+  /// Abstract class which queries the type of a path from the file system.
+  /// </summary>
+  class PathTypeProvider
+  {
+  public:
+    virtual ~PathTypeProvider() {}
+
+    /// <summary>
+    /// Returns the type of the given path. Must be thread safe.
+    /// </summary>
+    /// <param name="path">The path to a file or directory, encoded in utf-8.</param>
+    /// <returns>Returns PATH_TYPE_FILE or PATH_TYPE_DIRECTORY if the path exists. Returns PATH_TYPE_MISSING otherwise.</returns>
+    virtual PATH_TYPE GetPathType(const std::string & path) = 0;
+  };
+
+  /// <summary>
+  /// Set the provider used by GetPathType() to query the file system.
+  /// The provider is not owned and must outlive its use.
+  /// </summary>
+  /// <param name="provider">The new provider. Set to NULL to restore the file system provider.</param>
+  void SetPathTypeProvider(PathTypeProvider * provider);
+
+} //namespace shellanything
+
+#endif //SA_PATHTYPE_H
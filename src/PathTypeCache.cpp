@@ -0,0 +1,146 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "PathTypeCache.h"
+
+namespace shellanything
+{
+  const uint32_t PathTypeCache::DEFAULT_TIME_TO_LIVE = 5000;
+  const size_t PathTypeCache::MAX_ENTRIES = 4096;
+
+  PathTypeCache & PathTypeCache::GetInstance()
+  {
+    static PathTypeCache _instance;
+    return _instance;
+  }
+
+  PathTypeCache::PathTypeCache() :
+    mTimeToLive(DEFAULT_TIME_TO_LIVE),
+    mEpoch(0),
+    mHits(0),
+    mMisses(0)
+  {
+  }
+
+  PathTypeCache::~PathTypeCache()
+  {
+  }
+
+  PATH_TYPE PathTypeCache::GetPathType(const std::string & path)
+  {
+    Clock::time_point now = Clock::now();
+    uint32_t time_to_live = 0;
+    uint64_t epoch = 0;
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      time_to_live = mTimeToLive;
+      epoch = mEpoch;
+
+      EntryMap::const_iterator entryIt = mEntries.find(path);
+      if (entryIt != mEntries.end() && now < entryIt->second.expiration)
+      {
+        mHits++;
+        return entryIt->second.type;
+      }
+      mMisses++;
+    }
+
+    // Do not hold the lock while querying the file system
+    PATH_TYPE type = shellanything::GetPathType(path);
+    if (time_to_live == 0)
+      return type;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // The cache was invalidated during the query, the type may be stale
+    if (mEpoch != epoch)
+      return type;
+
+    if (mEntries.size() >= MAX_ENTRIES)
+      RemoveExpiredEntries(now);
+    if (mEntries.size() >= MAX_ENTRIES)
+      mEntries.clear();
+
+    ENTRY & entry = mEntries[path];
+    entry.type = type;
+    entry.expiration = now + std::chrono::milliseconds(time_to_live);
+
+    return type;
+  }
+
+  bool PathTypeCache::Exists(const std::string & path)
+  {
+    return GetPathType(path) != PATH_TYPE_MISSING;
+  }
+
+  void PathTypeCache::Invalidate(const std::string & path)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEntries.erase(path);
+    mEpoch++;
+  }
+
+  void PathTypeCache::Clear()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEntries.clear();
+    mEpoch++;
+  }
+
+  uint32_t PathTypeCache::GetTimeToLive()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mTimeToLive;
+  }
+
+  void PathTypeCache::SetTimeToLive(uint32_t milliseconds)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTimeToLive = milliseconds;
+
+    // The remembered types may have been queried with a longer time to live
+    mEntries.clear();
+    mEpoch++;
+  }
+
+  void PathTypeCache::GetStatistics(size_t & hits, size_t & misses)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    hits = mHits;
+    misses = mMisses;
+  }
+
+  void PathTypeCache::RemoveExpiredEntries(const Clock::time_point & now)
+  {
+    for(EntryMap::iterator entryIt = mEntries.begin(); entryIt != mEntries.end(); )
+    {
+      if (entryIt->second.expiration <= now)
+        entryIt = mEntries.erase(entryIt);
+      else
+        entryIt++;
+    }
+  }
+
+} //namespace shellanything
@@ -0,0 +1,129 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_PATHTYPECACHE_H
+#define SA_PATHTYPECACHE_H
+
+#include "PathType.h"
+#include <string>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <stdint.h>
+
+namespace shellanything
+{
+  /// <summary>
+  /// Process-wide cache of the type of paths. See GetPathType().
+  /// Validators probe the same paths (for example, the path of an installed tool) on every right-click.
+  /// The type of a path is remembered for a limited time, including the paths that do not exist.
+  /// The cache must be invalidated when a path is known to be modified. The cache is thread safe.
+  /// </summary>
+  class PathTypeCache
+  {
+  public:
+    static PathTypeCache & GetInstance();
+  private:
+    PathTypeCache();
+    ~PathTypeCache();
+
+    // Disable copy constructor and copy operator
+    PathTypeCache(const PathTypeCache&);
+    PathTypeCache& operator=(const PathTypeCache&);
+
+  public:
+    /// <summary>
+    /// Default time, in milliseconds, for which the type of a path is remembered.
+    /// </summary>
+    static const uint32_t DEFAULT_TIME_TO_LIVE;
+
+    /// <summary>
+    /// Maximum number of remembered paths.
+    /// </summary>
+    static const size_t MAX_ENTRIES;
+
+    /// <summary>
+    /// Returns the type of the given path. The file system is queried if the path is not remembered or if the remembered type is expired.
+    /// </summary>
+    /// <param name="path">The path to a file or directory, encoded in utf-8.</param>
+    /// <returns>Returns PATH_TYPE_FILE or PATH_TYPE_DIRECTORY if the path exists. Returns PATH_TYPE_MISSING otherwise.</returns>
+    PATH_TYPE GetPathType(const std::string & path);
+
+    /// <summary>
+    /// Returns true if the given path is an existing file or directory. See GetPathType().
+    /// </summary>
+    bool Exists(const std::string & path);
+
+    /// <summary>
+    /// Forgets the type of the given path. Must be called when the given path is created or deleted.
+    /// A query of the file system which is running concurrently does not remember its result.
+    /// </summary>
+    void Invalidate(const std::string & path);
+
+    /// <summary>
+    /// Forgets the type of all paths.
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// Getter for the time, in milliseconds, for which the type of a path is remembered.
+    /// </summary>
+    uint32_t GetTimeToLive();
+
+    /// <summary>
+    /// Setter for the time, in milliseconds, for which the type of a path is remembered. A value of 0 disables the cache.
+    /// </summary>
+    void SetTimeToLive(uint32_t milliseconds);
+
+    /// <summary>
+    /// Returns the number of queries answered by the cache and the number of queries of the file system.
+    /// </summary>
+    void GetStatistics(size_t & hits, size_t & misses);
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    /// <summary>
+    /// A remembered path type.
+    /// </summary>
+    struct ENTRY
+    {
+      PATH_TYPE type;
+      Clock::time_point expiration;
+    };
+    typedef std::map<std::string, ENTRY> EntryMap;
+
+    void RemoveExpiredEntries(const Clock::time_point & now);
+
+    std::mutex mMutex;
+    EntryMap mEntries;
+    uint32_t mTimeToLive;
+    uint64_t mEpoch; // incremented when remembered types are forgotten. A query which overlaps an invalidation is not remembered.
+    size_t mHits;
+    size_t mMisses;
+  };
+
+} //namespace shellanything
+
+#endif //SA_PATHTYPECACHE_H
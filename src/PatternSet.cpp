@@ -0,0 +1,201 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "PatternSet.h"
+#include "CaseFold.h"
+
+#include <deque>
+
+namespace shellanything
+{
+  const PatternSet::PatternId PatternSet::INVALID_PATTERN_ID = (PatternSet::PatternId)-1;
+
+  PatternSet::Matcher::Matcher(const WildcardPatternList & patterns) :
+    mPatterns(patterns),
+    mNumWords((patterns.size() + 63) / 64)
+  {
+    // Build the trie of the literals. State 0 is the root.
+    static const uint32_t NO_STATE = (uint32_t)-1;
+    mTransitions.assign(ALPHABET_SIZE, NO_STATE);
+    mOutputs.resize(1);
+    for(size_t id=0; id<mPatterns.size(); id++)
+    {
+      const std::string literal = mPatterns[id].GetLongestLiteral();
+      if (literal.empty())
+      {
+        mUnconditional.push_back(id);
+        continue;
+      }
+
+      uint32_t state = 0;
+      for(size_t i=0; i<literal.size(); i++)
+      {
+        const unsigned char c = (unsigned char)literal[i];
+        uint32_t & next = mTransitions[state*ALPHABET_SIZE + c];
+        if (next == NO_STATE)
+        {
+          next = (uint32_t)mOutputs.size();
+          mOutputs.resize(mOutputs.size() + 1);
+          mTransitions.resize(mTransitions.size() + ALPHABET_SIZE, NO_STATE);
+        }
+        state = mTransitions[state*ALPHABET_SIZE + c];
+      }
+      mOutputs[state].push_back(id);
+    }
+
+    // Compute the failure links in breadth-first order and complete the transitions into a deterministic automaton
+    StateList failures(mOutputs.size(), 0);
+    std::deque<uint32_t> queue;
+    for(size_t c=0; c<ALPHABET_SIZE; c++)
+    {
+      uint32_t & next = mTransitions[c];
+      if (next == NO_STATE)
+      {
+        next = 0;
+      }
+      else
+      {
+        failures[next] = 0;
+        queue.push_back(next);
+      }
+    }
+    while (!queue.empty())
+    {
+      const uint32_t state = queue.front();
+      queue.pop_front();
+
+      // A literal which ends at the failure state also ends at this state
+      const PatternIdList & inherited = mOutputs[failures[state]];
+      mOutputs[state].insert(mOutputs[state].end(), inherited.begin(), inherited.end());
+
+      for(size_t c=0; c<ALPHABET_SIZE; c++)
+      {
+        uint32_t & next = mTransitions[state*ALPHABET_SIZE + c];
+        const uint32_t fallback = mTransitions[failures[state]*ALPHABET_SIZE + c];
+        if (next == NO_STATE)
+        {
+          next = fallback;
+        }
+        else
+        {
+          failures[next] = fallback;
+          queue.push_back(next);
+        }
+      }
+    }
+  }
+
+  size_t PatternSet::Matcher::GetCount() const
+  {
+    return mPatterns.size();
+  }
+
+  size_t PatternSet::Matcher::GetNumWords() const
+  {
+    return mNumWords;
+  }
+
+  void PatternSet::Matcher::Match(const char * value, size_t length, uint64_t * bits) const
+  {
+    std::vector<uint64_t> tested(mNumWords);
+    Match(value, length, bits, (mNumWords > 0 ? &tested[0] : NULL));
+  }
+
+  void PatternSet::Matcher::Match(const char * value, size_t length, uint64_t * bits, uint64_t * tested) const
+  {
+    for(size_t i=0; i<mNumWords; i++)
+    {
+      bits[i] = 0;
+      tested[i] = 0;
+    }
+
+    // Find the candidate patterns whose literal is found in the value.
+    // Each candidate is fully matched once, even if its literal is found many times in the value.
+    uint32_t state = 0;
+    for(size_t i=0; i<length; i++)
+    {
+      state = mTransitions[state*ALPHABET_SIZE + (unsigned char)ToUpperAscii(value[i])]; // the literals are uppercase
+
+      const PatternIdList & outputs = mOutputs[state];
+      for(size_t j=0; j<outputs.size(); j++)
+      {
+        const PatternId id = outputs[j];
+        const uint64_t mask = (uint64_t)1 << (id % 64);
+        uint64_t & tested_word = tested[id / 64];
+        if (tested_word & mask)
+          continue;
+        tested_word |= mask;
+        if (mPatterns[id].Match(value, length))
+          bits[id / 64] |= mask;
+      }
+    }
+
+    for(size_t j=0; j<mUnconditional.size(); j++)
+    {
+      const PatternId id = mUnconditional[j];
+      if (mPatterns[id].Match(value, length))
+        bits[id / 64] |= (uint64_t)1 << (id % 64);
+    }
+  }
+
+  PatternSet & PatternSet::GetInstance()
+  {
+    static PatternSet _instance;
+    return _instance;
+  }
+
+  PatternSet::PatternSet()
+  {
+  }
+
+  PatternSet::~PatternSet()
+  {
+  }
+
+  PatternSet::PatternId PatternSet::Add(const std::string & pattern)
+  {
+    const WildcardPattern compiled(pattern, false);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    PatternIdMap::const_iterator idIt = mIds.find(compiled.GetPattern());
+    if (idIt != mIds.end())
+      return idIt->second;
+
+    PatternId id = mPatterns.size();
+    mPatterns.push_back(compiled);
+    mIds[compiled.GetPattern()] = id;
+    mMatcher.reset(); // the automaton must be built again
+    return id;
+  }
+
+  PatternSet::MatcherPtr PatternSet::GetMatcher()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mMatcher)
+      mMatcher.reset(new Matcher(mPatterns));
+    return mMatcher;
+  }
+
+} //namespace shellanything
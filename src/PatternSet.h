@@ -0,0 +1,142 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_PATTERNSET_H
+#define SA_PATTERNSET_H
+
+#include "shellanything/WildcardPattern.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+namespace shellanything
+{
+  /// <summary>
+  /// Process-wide set of the wildcard patterns of all validators.
+  /// The patterns are compiled into a single Aho-Corasick automaton over the longest literal of each pattern.
+  /// A single pass of the automaton over a value finds the patterns which may match the value.
+  /// The patterns are not case sensitive: the automaton folds the ASCII characters of the value while reading it.
+  /// Only these candidate patterns are fully matched against the value.
+  /// The set is thread safe.
+  /// </summary>
+  class PatternSet
+  {
+  public:
+    static PatternSet & GetInstance();
+  private:
+    PatternSet();
+    ~PatternSet();
+
+    // Disable copy constructor and copy operator
+    PatternSet(const PatternSet&);
+    PatternSet& operator=(const PatternSet&);
+
+  public:
+    typedef size_t PatternId;
+    typedef std::vector<PatternId> PatternIdList;
+
+    /// <summary>
+    /// Invalid pattern id. No pattern is identified by this id.
+    /// </summary>
+    static const PatternId INVALID_PATTERN_ID;
+
+    /// <summary>
+    /// An immutable compiled automaton of the patterns known when the automaton was built.
+    /// </summary>
+    class Matcher
+    {
+    public:
+      /// <summary>
+      /// Builds the automaton of the given patterns. The patterns must not be case sensitive.
+      /// </summary>
+      Matcher(const WildcardPatternList & patterns);
+
+      /// <summary>
+      /// Returns the number of patterns of the automaton.
+      /// </summary>
+      size_t GetCount() const;
+
+      /// <summary>
+      /// Returns the number of 64 bits words required for storing a bit for each pattern.
+      /// </summary>
+      size_t GetNumWords() const;
+
+      /// <summary>
+      /// Finds all the patterns which matches the given value, regardless of the case of ASCII characters.
+      /// Allocates the temporary bitset of the candidate patterns.
+      /// </summary>
+      /// <param name="value">The value to match.</param>
+      /// <param name="length">The length of the value in bytes.</param>
+      /// <param name="bits">The output bitset. Must contain GetNumWords() words. The bit of each matching pattern id is set.</param>
+      void Match(const char * value, size_t length, uint64_t * bits) const;
+
+      /// <summary>
+      /// Finds all the patterns which matches the given value, regardless of the case of ASCII characters.
+      /// Uses the given buffer for remembering the candidate patterns which were already matched. The buffer can be reused for many values.
+      /// </summary>
+      /// <param name="value">The value to match.</param>
+      /// <param name="length">The length of the value in bytes.</param>
+      /// <param name="bits">The output bitset. Must contain GetNumWords() words. The bit of each matching pattern id is set.</param>
+      /// <param name="tested">A temporary bitset. Must contain GetNumWords() words.</param>
+      void Match(const char * value, size_t length, uint64_t * bits, uint64_t * tested) const;
+
+    private:
+      static const size_t ALPHABET_SIZE = 256;
+      typedef std::vector<uint32_t> StateList;
+
+      WildcardPatternList mPatterns;
+      size_t mNumWords;
+      std::vector<uint32_t> mTransitions;  // next state of each state and byte: mTransitions[state*ALPHABET_SIZE + byte]
+      std::vector<PatternIdList> mOutputs; // patterns whose literal ends at each state, including the literals of the suffix states
+      PatternIdList mUnconditional;        // patterns without literal characters, which are candidates for any value
+    };
+    typedef std::shared_ptr<const Matcher> MatcherPtr;
+
+    /// <summary>
+    /// Adds a pattern to the set. The patterns are not case sensitive.
+    /// </summary>
+    /// <param name="pattern">The wildcard pattern.</param>
+    /// <returns>Returns the id of the pattern. Adding the same pattern again returns the same id.</returns>
+    PatternId Add(const std::string & pattern);
+
+    /// <summary>
+    /// Returns the automaton of all added patterns. The automaton is built again if patterns were added since the last call.
+    /// </summary>
+    MatcherPtr GetMatcher();
+
+  private:
+    typedef std::map<std::string, PatternId> PatternIdMap;
+
+    std::mutex mMutex;
+    PatternIdMap mIds;
+    WildcardPatternList mPatterns;
+    MatcherPtr mMatcher; // automaton of all patterns. NULL if patterns were added since it was built.
+  };
+
+} //namespace shellanything
+
+#endif //SA_PATTERNSET_H
@@ -31,15 +31,32 @@
 
 namespace shellanything
 {
+  const PropertyManager::PropertyId PropertyManager::INVALID_PROPERTY_ID = (PropertyManager::PropertyId)-1;
+  const PropertyManager::Generation PropertyManager::INVALID_GENERATION = 0;
 
-  PropertyManager::PropertyManager()
+  PropertyManager::PropertyManager() :
+    version(0),
+    snapshot_mode(false)
   {
-    RegisterEnvironmentVariables();
-    RegisterDefaultProperties();
+    resolvers.push_back(new EnvironmentPropertyResolver());
+
+    SNAPSHOT * snapshot = new SNAPSHOT();
+    snapshot->generation = INVALID_GENERATION;
+    snapshot->resolution_epoch = INVALID_GENERATION + 1;
+    RegisterDefaultProperties(*snapshot);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Publish(snapshot, false);
   }
 
   PropertyManager::~PropertyManager()
   {
+    for(size_t i=0; i<resolvers.size(); i++)
+    {
+      PropertyResolver * resolver = resolvers[i];
+      delete resolver;
+    }
+    resolvers.clear();
   }
 
   PropertyManager & PropertyManager::GetInstance()
@@ -48,104 +65,526 @@ namespace shellanything
     return _instance;
   }
 
+  PropertyManager::ScopedSnapshot::ScopedSnapshot()
+  {
+    THREAD_STATE & state = GetThreadState();
+    if (state.scopes == 0)
+      PropertyManager::GetInstance().GetSnapshot(); //start from the latest snapshot
+    state.scopes++;
+  }
+
+  PropertyManager::ScopedSnapshot::~ScopedSnapshot()
+  {
+    THREAD_STATE & state = GetThreadState();
+    state.scopes--;
+    if (state.scopes == 0)
+      state.retained.clear();
+  }
+
+  PropertyManager::THREAD_STATE & PropertyManager::GetThreadState()
+  {
+    static thread_local THREAD_STATE state = { SnapshotPtr(), 0, 0, NULL, std::vector<SnapshotPtr>() };
+    return state;
+  }
+
+  PropertyManager::ActiveScope::ActiveScope(const PropertyScope & scope)
+  {
+    THREAD_STATE & state = GetThreadState();
+    previous = state.scope;
+    state.scope = &scope;
+  }
+
+  PropertyManager::ActiveScope::~ActiveScope()
+  {
+    THREAD_STATE & state = GetThreadState();
+    state.scope = previous;
+  }
+
+  const PropertyScope * PropertyManager::GetActiveScope()
+  {
+    return GetThreadState().scope;
+  }
+
+  const PropertyManager::SNAPSHOT * PropertyManager::GetSnapshot(bool force_update) const
+  {
+    // Each thread keeps a reference to the last snapshot it has used.
+    // The lock is only required to get a newer snapshot after a modification.
+    THREAD_STATE & state = GetThreadState();
+    bool update = (force_update || state.scopes == 0 || !state.snapshot);
+    if (update && state.version != version.load(std::memory_order_acquire))
+    {
+      // Within a ScopedSnapshot, the caller may still hold pointers to the previous snapshot
+      if (state.scopes > 0 && state.snapshot)
+        state.retained.push_back(state.snapshot);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      state.snapshot = current;
+      state.version = version.load(std::memory_order_relaxed);
+    }
+    return state.snapshot.get();
+  }
+
+  void PropertyManager::Publish(SNAPSHOT * snapshot, bool resolve) const
+  {
+    // Must be called with the lock.
+
+    // Resolved properties are resolved again for each generation.
+    // They are only marked as stale, each one is resolved again on its next lookup.
+    if (resolve && !snapshot_mode && current && snapshot->generation != current->generation)
+      snapshot->resolution_epoch++;
+
+    current.reset(snapshot);
+    version.fetch_add(1, std::memory_order_release);
+  }
+
   void PropertyManager::Clear()
   {
-    properties.clear();
-    RegisterEnvironmentVariables();
-    RegisterDefaultProperties();
+    std::lock_guard<std::mutex> lock(mutex);
+    SNAPSHOT * snapshot = new SNAPSHOT(*current);
+
+    //delete all properties which were set
+    const PropertyStore & store = snapshot->properties; // do not copy unmodified pages
+    for(PropertyId id=0; id<store.GetCount(); id++)
+    {
+      if (store.Get(id).defined && !store.Get(id).resolved)
+      {
+        PropertyStore::PROPERTY & p = snapshot->properties.Get(id);
+        p.defined = false;
+        p.value.clear();
+        SetModified(*snapshot, id);
+      }
+    }
+
+    RegisterDefaultProperties(*snapshot);
+    Publish(snapshot, true);
+  }
+
+  void PropertyManager::RegisterResolver(PropertyResolver * resolver)
+  {
+    if (resolver == NULL)
+      return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    resolvers.push_back(resolver);
+  }
+
+  void PropertyManager::SetSnapshotMode(bool enabled)
+  {
+    snapshot_mode = enabled;
+  }
+
+  bool PropertyManager::IsSnapshotMode() const
+  {
+    return snapshot_mode;
+  }
+
+  void PropertyManager::RefreshResolvedProperties()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    SNAPSHOT * snapshot = new SNAPSHOT(*current);
+    snapshot->resolution_epoch++;
+    Publish(snapshot, false);
   }
 
   void PropertyManager::ClearProperty(const std::string & name)
   {
-    PropertyMap::const_iterator propertyIt = properties.find(name);
-    bool found = (propertyIt != properties.end());
+    std::lock_guard<std::mutex> lock(mutex);
+
+    PropertyId id = current->properties.Find(name);
+    if (id == INVALID_PROPERTY_ID)
+      return;
+
+    const PropertyStore::PROPERTY & p = current->properties.Get(id);
+    bool found = (p.defined && !p.resolved);
     if (found)
     {
-      properties.erase(propertyIt);
+      SNAPSHOT * snapshot = new SNAPSHOT(*current);
+      PropertyStore::PROPERTY & deleted = snapshot->properties.Get(id);
+      deleted.defined = false;
+      deleted.value.clear();
+      SetModified(*snapshot, id);
+      Publish(snapshot, true);
     }
   }
 
   bool PropertyManager::HasProperty(const std::string & name) const
   {
-    PropertyMap::const_iterator propertyIt = properties.find(name);
-    bool found = (propertyIt != properties.end());
-    return found;
+    const SNAPSHOT * snapshot = GetSnapshot();
+    return (Lookup(snapshot, name.c_str(), name.size()) != NULL);
   }
 
   void PropertyManager::SetProperty(const std::string & name, const std::string & value)
   {
-    //overwrite previous property
-    properties[name] = value;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    PropertyId id = current->properties.Find(name);
+    if (id != INVALID_PROPERTY_ID)
+    {
+      const PropertyStore::PROPERTY & p = current->properties.Get(id);
+      if (p.defined && !p.resolved && p.value == value)
+        return; //unchanged
+    }
+
+    SNAPSHOT * snapshot = new SNAPSHOT(*current);
+    id = snapshot->properties.Intern(name);
+    SetProperty(*snapshot, id, value);
+    Publish(snapshot, true);
+  }
+
+  std::string PropertyManager::GetProperty(const std::string & name) const
+  {
+    const SNAPSHOT * snapshot = GetSnapshot();
+    const std::string * value = Lookup(snapshot, name.c_str(), name.size());
+    if (value)
+      return (*value);
+    return std::string();
+  }
+
+  bool PropertyManager::AppendProperty(const std::string & name, std::string & output) const
+  {
+    const SNAPSHOT * snapshot = GetSnapshot();
+    const std::string * value = Lookup(snapshot, name.c_str(), name.size());
+    if (value)
+      output.append(*value);
+    return (value != NULL);
+  }
+
+  PropertyManager::PropertyId PropertyManager::GetPropertyId(const std::string & name)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    PropertyId id = current->properties.Find(name);
+    if (id != INVALID_PROPERTY_ID)
+      return id;
+
+    SNAPSHOT * snapshot = new SNAPSHOT(*current);
+    id = snapshot->properties.Intern(name);
+    Publish(snapshot, false);
+    return id;
+  }
+
+  PropertyManager::PropertyId PropertyManager::FindPropertyId(const std::string & name) const
+  {
+    const SNAPSHOT * snapshot = GetSnapshot();
+    return FindPropertyId(snapshot, name.c_str(), name.size());
+  }
+
+  PropertyManager::PropertyId PropertyManager::FindPropertyId(const SNAPSHOT *& snapshot, const char * name, size_t length) const
+  {
+    PropertyId id = snapshot->properties.Find(name, length);
+    if (id == INVALID_PROPERTY_ID && FindResolver(name, length) != NULL)
+    {
+      //the property may be resolved
+      snapshot = ResolveProperty(std::string(name, length));
+      id = snapshot->properties.Find(name, length);
+    }
+    return id;
+  }
+
+  const PropertyResolver * PropertyManager::FindResolver(const char * name, size_t length) const
+  {
+    for(size_t i=0; i<resolvers.size(); i++)
+    {
+      const PropertyResolver * resolver = resolvers[i];
+      const std::string & prefix = resolver->GetPrefix();
+      if (length >= prefix.size() && prefix.compare(0, prefix.size(), name, prefix.size()) == 0)
+        return resolver;
+    }
+    return NULL;
+  }
+
+  bool PropertyManager::IsResolutionRequired(const SNAPSHOT & snapshot, PropertyId id) const
+  {
+    if (id >= snapshot.properties.GetCount())
+      return false;
+
+    const PropertyStore::PROPERTY & p = snapshot.properties.Get(id);
+    if (p.defined && !p.resolved)
+      return false; //the property is set
+    if (p.resolved && p.resolution == snapshot.resolution_epoch)
+      return false; //already resolved
+    return (FindResolver(p.name.c_str(), p.name.size()) != NULL);
+  }
+
+  const PropertyManager::SNAPSHOT * PropertyManager::ResolveProperty(const std::string & name) const
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      // Another thread may have resolved the property already
+      PropertyId id = current->properties.Find(name);
+      if (id == INVALID_PROPERTY_ID || IsResolutionRequired(*current, id))
+      {
+        SNAPSHOT * snapshot = new SNAPSHOT(*current);
+        id = snapshot->properties.Intern(name);
+        Resolve(*snapshot, id);
+        Publish(snapshot, false);
+      }
+    }
+
+    // The resolved property must be visible even within a ScopedSnapshot
+    return GetSnapshot(true);
+  }
+
+  void PropertyManager::Resolve(SNAPSHOT & snapshot, PropertyId id) const
+  {
+    PropertyStore::PROPERTY & p = snapshot.properties.Get(id);
+    if (p.defined && !p.resolved)
+      return; //the property is set
+
+    const PropertyResolver * resolver = FindResolver(p.name.c_str(), p.name.size());
+    if (resolver == NULL)
+      return;
+
+    std::string value;
+    bool found = resolver->Resolve(p.name.substr(resolver->GetPrefix().size()), value);
+    bool modified = (found != p.defined || value != p.value);
+
+    p.value = value;
+    p.defined = found;
+    p.resolved = true;
+    if (modified)
+      SetModified(snapshot, id);
+    p.resolution = snapshot.resolution_epoch;
+  }
+
+  const std::string * PropertyManager::Lookup(const SNAPSHOT *& snapshot, const char * name, size_t length) const
+  {
+    // The active scope overlays the global properties
+    const PropertyScope * scope = GetThreadState().scope;
+    if (scope)
+    {
+      const std::string * value = scope->Find(name, length);
+      if (value)
+        return value;
+    }
+
+    PropertyId id = FindPropertyId(snapshot, name, length);
+    return LookupGlobal(snapshot, id);
   }
 
-  const std::string & PropertyManager::GetProperty(const std::string & name) const
+  const std::string * PropertyManager::Lookup(const SNAPSHOT *& snapshot, PropertyId id) const
   {
-    PropertyMap::const_iterator propertyIt = properties.find(name);
-    bool found = (propertyIt != properties.end());
+    // The active scope overlays the global properties
+    const PropertyScope * scope = GetThreadState().scope;
+    if (scope && id < snapshot->properties.GetCount())
+    {
+      const std::string & name = snapshot->properties.Get(id).name;
+      const std::string * value = scope->Find(name.c_str(), name.size());
+      if (value)
+        return value;
+    }
+
+    return LookupGlobal(snapshot, id);
+  }
+
+  const std::string * PropertyManager::LookupGlobal(const SNAPSHOT *& snapshot, PropertyId id) const
+  {
+    if (IsResolutionRequired(*snapshot, id))
+    {
+      std::string name = snapshot->properties.Get(id).name;
+      snapshot = ResolveProperty(name);
+    }
+
+    bool found = snapshot->properties.IsDefined(id);
     if (found)
     {
-      const std::string & value = propertyIt->second;
-      return value;
+      const std::string & value = snapshot->properties.Get(id).value;
+      return &value;
     }
+    return NULL;
+  }
 
-    static std::string EMPTY_VALUE;
-    return EMPTY_VALUE;
+  bool PropertyManager::HasProperty(PropertyId id) const
+  {
+    const SNAPSHOT * snapshot = GetSnapshot();
+    return (Lookup(snapshot, id) != NULL);
+  }
+
+  void PropertyManager::SetProperty(PropertyId id, const std::string & value)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (id >= current->properties.GetCount())
+      return; //invalid id
+
+    const PropertyStore::PROPERTY & p = current->properties.Get(id);
+    if (p.defined && !p.resolved && p.value == value)
+      return; //unchanged
+
+    SNAPSHOT * snapshot = new SNAPSHOT(*current);
+    SetProperty(*snapshot, id, value);
+    Publish(snapshot, true);
+  }
+
+  void PropertyManager::SetProperty(SNAPSHOT & snapshot, PropertyId id, const std::string & value)
+  {
+    PropertyStore::PROPERTY & p = snapshot.properties.Get(id);
+    bool modified = (!p.defined || p.value != value);
+
+    //overwrite previous property
+    p.value = value;
+    p.defined = true;
+    p.resolved = false;
+    if (modified)
+      SetModified(snapshot, id);
+  }
+
+  std::string PropertyManager::GetProperty(PropertyId id) const
+  {
+    const SNAPSHOT * snapshot = GetSnapshot();
+    const std::string * value = Lookup(snapshot, id);
+    if (value)
+      return (*value);
+    return std::string();
+  }
+
+  bool PropertyManager::AppendProperty(PropertyId id, std::string & output) const
+  {
+    const SNAPSHOT * snapshot = GetSnapshot();
+    const std::string * value = Lookup(snapshot, id);
+    if (value)
+      output.append(*value);
+    return (value != NULL);
+  }
+
+  bool PropertyManager::FindNextPropertyReference(const std::string & value, size_t offset, size_t & reference_offset, size_t & name_length)
+  {
+    size_t open_pos = value.find("${", offset);
+    if (open_pos == std::string::npos)
+      return false;
+
+    size_t close_pos = value.find('}', open_pos + 2);
+    if (close_pos == std::string::npos)
+      return false; // the reference is never closed
+
+    // If another reference starts before the closing character, the innermost one is the actual reference.
+    // ie: "${foo${bar}}" references property "bar".
+    open_pos = value.rfind("${", close_pos);
+
+    reference_offset = open_pos;
+    name_length = close_pos - (open_pos + 2);
+    return true;
   }
 
   std::string PropertyManager::Expand(const std::string & value) const
   {
-    std::string output = value;
+    std::string output;
+    output.reserve(value.size());
+
+    // Expand all references from the same snapshot.
+    // The snapshot must stay alive while property resolutions move the thread to a newer snapshot.
+    ScopedSnapshot scoped_snapshot;
+    const SNAPSHOT * snapshot = GetSnapshot();
 
-    //for each properties
-    for (PropertyMap::const_iterator propertyIt = properties.begin(); propertyIt != properties.end(); propertyIt++)
+    size_t offset = 0;
+    size_t reference_offset = 0;
+    size_t name_length = 0;
+    while (FindNextPropertyReference(value, offset, reference_offset, name_length))
     {
-      const std::string & name  = propertyIt->first;
-      const std::string & value = propertyIt->second;
+      // Copy the text found before the reference
+      output.append(value, offset, reference_offset - offset);
 
-      //generate the search token
-      std::string token;
-      token.append("${");
-      token.append(name);
-      token.append("}");
+      // Search the property name directly in the given value to prevent an allocation per reference
+      const size_t reference_length = name_length + 3; // "${" + name + "}"
+      const std::string * property_value = Lookup(snapshot, value.c_str() + reference_offset + 2, name_length);
+      if (property_value)
+        output.append(*property_value);
+      else
+        output.append(value, reference_offset, reference_length); // unknown property, keep the reference as is
 
-      //process with search and replace
-      ra::strings::Replace(output, token, value);
+      // Next reference
+      offset = reference_offset + reference_length;
     }
 
+    // Copy the remaining text
+    output.append(value, offset, std::string::npos);
+
     return output;
   }
 
-  void PropertyManager::RegisterEnvironmentVariables()
+  PropertyManager::Generation PropertyManager::GetGeneration() const
+  {
+    const SNAPSHOT * snapshot = GetSnapshot();
+    return snapshot->generation;
+  }
+
+  PropertyManager::Generation PropertyManager::GetPropertyGeneration(const std::string & name) const
   {
-    //Work around for https://github.com/end2endzone/RapidAssist/issues/54
-    ra::environment::GetEnvironmentVariableUtf8("foo");
+    return GetPropertyGeneration(FindPropertyId(name));
+  }
 
-    //register all environment variables
-    ra::strings::StringVector vars = ra::environment::GetEnvironmentVariablesUtf8();
-    for(size_t i=0; i<vars.size(); i++)
-    {
-      const std::string & var = vars[i];
+  PropertyManager::Generation PropertyManager::GetPropertyGeneration(PropertyId id) const
+  {
+    ScopedSnapshot scoped_snapshot;
+    const SNAPSHOT * snapshot = GetSnapshot();
+    if (id >= snapshot->properties.GetCount())
+      return INVALID_GENERATION;
 
-      std::string name = "env." + var;
-      std::string value = ra::environment::GetEnvironmentVariableUtf8(var.c_str());
-      
-      //register the variable as a valid property
-      SetProperty(name, value);
+    // Make sure the property is resolved
+    LookupGlobal(snapshot, id);
+
+    return snapshot->properties.Get(id).generation;
+  }
+
+  bool PropertyManager::HasChanged(const std::string & name, Generation generation) const
+  {
+    return GetPropertyGeneration(name) > generation;
+  }
+
+  bool PropertyManager::HasChanged(PropertyId id, Generation generation) const
+  {
+    return GetPropertyGeneration(id) > generation;
+  }
+
+  bool PropertyManager::HasChanged(const std::vector<std::string> & names, Generation generation) const
+  {
+    //nothing was modified since the given generation
+    if (generation >= GetGeneration())
+      return false;
+
+    for(size_t i=0; i<names.size(); i++)
+    {
+      if (HasChanged(names[i], generation))
+        return true;
     }
+    return false;
+  }
+
+  bool PropertyManager::IsScopedProperty(PropertyId id) const
+  {
+    const PropertyScope * scope = GetThreadState().scope;
+    if (scope == NULL)
+      return false;
+
+    // The name is read from the snapshot while the scope is searched
+    ScopedSnapshot scoped_snapshot;
+    const SNAPSHOT * snapshot = GetSnapshot();
+    if (id >= snapshot->properties.GetCount())
+      return false;
+
+    const std::string & name = snapshot->properties.Get(id).name;
+    return (scope->Find(name.c_str(), name.size()) != NULL);
+  }
+
+  void PropertyManager::SetModified(SNAPSHOT & snapshot, PropertyId id)
+  {
+    snapshot.generation++;
+    snapshot.properties.Get(id).generation = snapshot.generation;
   }
 
-  void PropertyManager::RegisterDefaultProperties()
+  void PropertyManager::RegisterDefaultProperties(SNAPSHOT & snapshot)
   {
     //define global properties
     std::string prop_path_separator         = ra::filesystem::GetPathSeparatorStr();
     std::string prop_line_separator         = ra::environment::GetLineSeparator();
 
-    SetProperty("path.separator"       , prop_path_separator       );
-    SetProperty("line.separator"       , prop_line_separator       );
-    SetProperty("newline"              , prop_line_separator       );
+    SetProperty(snapshot, snapshot.properties.Intern("path.separator"       ), prop_path_separator       );
+    SetProperty(snapshot, snapshot.properties.Intern("line.separator"       ), prop_line_separator       );
+    SetProperty(snapshot, snapshot.properties.Intern("newline"              ), prop_line_separator       );
 
     // Set default property for multi selection. Issue #52.
-    SetProperty(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME, Context::DEFAULT_MULTI_SELECTION_SEPARATOR);
+    SetProperty(snapshot, snapshot.properties.Intern(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME), Context::DEFAULT_MULTI_SELECTION_SEPARATOR);
   }
 
 } //namespace shellanything
@@ -25,13 +25,23 @@
 #ifndef SA_PROPERTYMANAGER_H
 #define SA_PROPERTYMANAGER_H
 
+#include "PropertyStore.h"
+#include "PropertyResolver.h"
+#include "PropertyScope.h"
 #include <string>
-#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
 
 namespace shellanything
 {
   /// <summary>
   /// Manages the property system
+  /// The manager is thread safe. The properties are stored in immutable snapshots.
+  /// Each modification creates and publishes a new snapshot. Readers use the latest published
+  /// snapshot without locking: a reader only waits for a lock when it needs a newer snapshot.
+  /// A PropertyScope can be activated on a thread to overlay the global properties without modifying them.
   /// </summary>
   class PropertyManager
   {
@@ -50,7 +60,62 @@ namespace shellanything
     //------------------------
     // Typedef
     //------------------------
-    typedef std::map<std::string /*name*/, std::string /*value*/> PropertyMap;
+    typedef PropertyStore::PropertyId PropertyId;
+    typedef PropertyStore::Generation Generation;
+
+    /// <summary>
+    /// Invalid property id. No property is identified by this id.
+    /// </summary>
+    static const PropertyId INVALID_PROPERTY_ID;
+
+    /// <summary>
+    /// Keeps the current thread on the same snapshot of the properties for the lifetime of the object.
+    /// Modifications made by other threads are not visible to the current thread until the object is destroyed.
+    /// This allows reading multiple properties that are consistent with each other.
+    /// The snapshots used by the thread are kept alive until the object is destroyed, even if a property resolution
+    /// moves the thread to a newer snapshot.
+    /// </summary>
+    class ScopedSnapshot
+    {
+    public:
+      ScopedSnapshot();
+      ~ScopedSnapshot();
+
+    private:
+      // Disable copy constructor and copy operator
+      ScopedSnapshot(const ScopedSnapshot&);
+      ScopedSnapshot& operator=(const ScopedSnapshot&);
+    };
+
+    /// <summary>
+    /// Activates a PropertyScope on the current thread for the lifetime of the object.
+    /// While the scope is active, the properties of the scope (and its parents) are searched before the global properties.
+    /// The global properties are not modified which allows multiple threads to use different scopes at the same time.
+    /// The previously active scope is restored when the object is destroyed.
+    /// </summary>
+    class ActiveScope
+    {
+    public:
+      ActiveScope(const PropertyScope & scope);
+      ~ActiveScope();
+
+    private:
+      // Disable copy constructor and copy operator
+      ActiveScope(const ActiveScope&);
+      ActiveScope& operator=(const ActiveScope&);
+
+      const PropertyScope * previous;
+    };
+
+    /// <summary>
+    /// Returns the scope which is active on the current thread. Returns NULL if no scope is active.
+    /// </summary>
+    static const PropertyScope * GetActiveScope();
+
+    /// <summary>
+    /// Invalid generation number. No modification of the properties is identified by this generation.
+    /// </summary>
+    static const Generation INVALID_GENERATION;
 
     /// <summary>
     /// Clears all the registered properties.
@@ -58,8 +123,37 @@ namespace shellanything
     /// </summary>
     void Clear();
 
+    /// <summary>
+    /// Registers a resolver for the properties of a namespace. The manager takes ownership of the given resolver.
+    /// A property of the resolver's namespace is resolved on demand, when the property is not set.
+    /// The resolved value is kept until the generation number changes. See GetGeneration().
+    /// By default, a resolver for environment variables (namespace "env.") is registered.
+    /// Resolvers must be registered before the manager is used by multiple threads.
+    /// </summary>
+    /// <param name="resolver">The resolver to register.</param>
+    void RegisterResolver(PropertyResolver * resolver);
+
+    /// <summary>
+    /// Enables or disables the snapshot mode of resolved properties.
+    /// In snapshot mode, a resolved value is kept until RefreshResolvedProperties() is called
+    /// instead of being resolved again on its first lookup after each generation.
+    /// </summary>
+    /// <param name="enabled">True to enable the snapshot mode, false to disable it.</param>
+    void SetSnapshotMode(bool enabled);
+
+    /// <summary>
+    /// Returns true if the snapshot mode of resolved properties is enabled.
+    /// </summary>
+    bool IsSnapshotMode() const;
+
+    /// <summary>
+    /// Discards the resolved values of all properties. The values are resolved again on the next lookup.
+    /// </summary>
+    void RefreshResolvedProperties();
+
     /// <summary>
     /// Delete the given property.
+    /// A property of a resolver's namespace which is deleted is resolved again on the next lookup.
     /// </summary>
     /// <param name="name">The name of the property to delete.</param>
     void ClearProperty(const std::string & name);
@@ -84,21 +178,184 @@ namespace shellanything
     /// </summary>
     /// <param name="name">The name of the property to get.</param>
     /// <returns>Returns value of the property if the property is set. Returns an empty string otherwise.</returns>
-    const std::string & GetProperty(const std::string & name) const;
+    std::string GetProperty(const std::string & name) const;
+
+    /// <summary>
+    /// Appends the value of the given property name to the given string.
+    /// </summary>
+    /// <param name="name">The name of the property to get.</param>
+    /// <param name="output">The string where the value of the property is appended.</param>
+    /// <returns>Returns true if the property is set. Returns false otherwise and the given string is left untouched.</returns>
+    bool AppendProperty(const std::string & name, std::string & output) const;
+
+    /// <summary>
+    /// Returns the id of the given property name.
+    /// The id of a property never changes and can be kept to look up the property without searching for its name.
+    /// A new id is assigned to names that are unknown to the manager. The property is not set by this function.
+    /// </summary>
+    /// <param name="name">The name of the property.</param>
+    /// <returns>Returns the id of the given property name.</returns>
+    PropertyId GetPropertyId(const std::string & name);
+
+    /// <summary>
+    /// Returns the id of the given property name, if known.
+    /// The names of the resolvers' namespaces are always known.
+    /// </summary>
+    /// <param name="name">The name of the property.</param>
+    /// <returns>Returns the id of the given property name. Returns INVALID_PROPERTY_ID if the name is unknown to the manager.</returns>
+    PropertyId FindPropertyId(const std::string & name) const;
+
+    /// <summary>
+    /// Check if a property have been set.
+    /// </summary>
+    /// <param name="id">The id of the property to check. See GetPropertyId().</param>
+    /// <returns>Returns true if the property is set. Returns false otherwise.</returns>
+    bool HasProperty(PropertyId id) const;
+
+    /// <summary>
+    /// Sets the value of the given property.
+    /// </summary>
+    /// <param name="id">The id of the property to set. See GetPropertyId().</param>
+    /// <param name="value">The new value of the property.</param>
+    void SetProperty(PropertyId id, const std::string & value);
+
+    /// <summary>
+    /// Gets the value of the given property.
+    /// </summary>
+    /// <param name="id">The id of the property to get. See GetPropertyId().</param>
+    /// <returns>Returns value of the property if the property is set. Returns an empty string otherwise.</returns>
+    std::string GetProperty(PropertyId id) const;
+
+    /// <summary>
+    /// Appends the value of the given property to the given string.
+    /// </summary>
+    /// <param name="id">The id of the property to get. See GetPropertyId().</param>
+    /// <param name="output">The string where the value of the property is appended.</param>
+    /// <returns>Returns true if the property is set. Returns false otherwise and the given string is left untouched.</returns>
+    bool AppendProperty(PropertyId id, std::string & output) const;
 
     /// <summary>
     /// Expands the given string by replacing property variable reference by the actual variable's value.
     /// The syntax of a property variable reference is the following: `${variable-name}` where `variable-name` is the name of a variable.
+    /// The string is scanned once from left to right. Each reference is looked up directly by name
+    /// and references to unknown properties are left untouched.
+    /// All references are expanded from the same snapshot of the properties.
     /// </summary>
     /// <param name="value">The given value to expand.</param>
     /// <returns>Returns a copy of the given value with the property references expanded.</returns>
     std::string Expand(const std::string & value) const;
 
+    /// <summary>
+    /// Searches the given string for the next property reference (`${variable-name}`) starting at the given offset.
+    /// If references are nested, the innermost one is returned. For example, `${bar}` is returned from `${foo${bar}}`.
+    /// </summary>
+    /// <param name="value">The string to search.</param>
+    /// <param name="offset">The offset in 'value' where the search begins.</param>
+    /// <param name="reference_offset">The offset of the '$' character of the reference, if found.</param>
+    /// <param name="name_length">The length of the variable name of the reference, if found.</param>
+    /// <returns>Returns true if a property reference is found. Returns false otherwise.</returns>
+    static bool FindNextPropertyReference(const std::string & value, size_t offset, size_t & reference_offset, size_t & name_length);
+
+    /// <summary>
+    /// Gets the global generation number of the properties.
+    /// The generation number is incremented each time a property is set to a new value or deleted.
+    /// Setting a property to its current value does not change the generation number.
+    /// </summary>
+    /// <returns>Returns the generation number of the last modification of the properties.</returns>
+    Generation GetGeneration() const;
+
+    /// <summary>
+    /// Gets the generation number of the last modification of the given property.
+    /// </summary>
+    /// <param name="name">The name of the property.</param>
+    /// <returns>Returns the generation number of the last modification of the property. Returns INVALID_GENERATION if the property was never set.</returns>
+    Generation GetPropertyGeneration(const std::string & name) const;
+
+    /// <summary>
+    /// Gets the generation number of the last modification of the given property.
+    /// </summary>
+    /// <param name="id">The id of the property. See GetPropertyId().</param>
+    /// <returns>Returns the generation number of the last modification of the property. Returns INVALID_GENERATION if the property was never set.</returns>
+    Generation GetPropertyGeneration(PropertyId id) const;
+
+    /// <summary>
+    /// Check if the given property was set or deleted since the given generation.
+    /// </summary>
+    /// <param name="name">The name of the property to check.</param>
+    /// <param name="generation">The generation number to compare with. See GetGeneration().</param>
+    /// <returns>Returns true if the property was modified after the given generation. Returns false otherwise.</returns>
+    bool HasChanged(const std::string & name, Generation generation) const;
+
+    /// <summary>
+    /// Check if the given property was set or deleted since the given generation.
+    /// </summary>
+    /// <param name="id">The id of the property to check. See GetPropertyId().</param>
+    /// <param name="generation">The generation number to compare with. See GetGeneration().</param>
+    /// <returns>Returns true if the property was modified after the given generation. Returns false otherwise.</returns>
+    bool HasChanged(PropertyId id, Generation generation) const;
+
+    /// <summary>
+    /// Check if any of the given properties was set or deleted since the given generation.
+    /// </summary>
+    /// <param name="names">The names of the properties to check.</param>
+    /// <param name="generation">The generation number to compare with. See GetGeneration().</param>
+    /// <returns>Returns true if at least one property was modified after the given generation. Returns false otherwise.</returns>
+    bool HasChanged(const std::vector<std::string> & names, Generation generation) const;
+
+    /// <summary>
+    /// Check if the given property is defined by the scope which is active on the current thread.
+    /// The generation numbers only track the global properties: the value of a scoped property may differ between threads.
+    /// </summary>
+    /// <param name="id">The id of the property to check. See GetPropertyId().</param>
+    /// <returns>Returns true if the active scope defines the property. Returns false otherwise.</returns>
+    bool IsScopedProperty(PropertyId id) const;
+
   private:
+    typedef std::vector<PropertyResolver*> ResolverList;
+
+    /// <summary>
+    /// An immutable copy of the properties.
+    /// </summary>
+    struct SNAPSHOT
+    {
+      PropertyStore properties;
+      Generation generation;
+      Generation resolution_epoch; // resolved values of an older epoch are stale and resolved again on their next lookup
+    };
+    typedef std::shared_ptr<const SNAPSHOT> SnapshotPtr;
+
+    /// <summary>
+    /// The snapshot used by a thread.
+    /// </summary>
+    struct THREAD_STATE
+    {
+      SnapshotPtr snapshot;
+      unsigned long long version;
+      size_t scopes; // number of ScopedSnapshot instances
+      const PropertyScope * scope; // active scope, see ActiveScope
+      std::vector<SnapshotPtr> retained; // snapshots replaced while a ScopedSnapshot is active
+    };
+
+    static THREAD_STATE & GetThreadState();
+    const SNAPSHOT * GetSnapshot(bool force_update = false) const;
+    const SNAPSHOT * ResolveProperty(const std::string & name) const;
+    void Publish(SNAPSHOT * snapshot, bool resolve) const;
+    PropertyId FindPropertyId(const SNAPSHOT *& snapshot, const char * name, size_t length) const;
+    const std::string * Lookup(const SNAPSHOT *& snapshot, const char * name, size_t length) const;
+    const std::string * Lookup(const SNAPSHOT *& snapshot, PropertyId id) const;
+    const std::string * LookupGlobal(const SNAPSHOT *& snapshot, PropertyId id) const;
+    const PropertyResolver * FindResolver(const char * name, size_t length) const;
+    bool IsResolutionRequired(const SNAPSHOT & snapshot, PropertyId id) const;
+    void Resolve(SNAPSHOT & snapshot, PropertyId id) const;
+    static void SetProperty(SNAPSHOT & snapshot, PropertyId id, const std::string & value);
+    static void SetModified(SNAPSHOT & snapshot, PropertyId id);
+    static void RegisterDefaultProperties(SNAPSHOT & snapshot);
 
-    void RegisterEnvironmentVariables();
-    void RegisterDefaultProperties();
-    PropertyMap properties;
+    mutable std::mutex mutex;       // serializes the modifications
+    mutable SnapshotPtr current;    // latest published snapshot, guarded by mutex
+    mutable std::atomic<unsigned long long> version; // incremented each time a snapshot is published
+    ResolverList resolvers;
+    std::atomic<bool> snapshot_mode;
   };
 
 } //namespace shellanything
@@ -0,0 +1,60 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "PropertyResolver.h"
+
+#include "rapidassist/environment_utf8.h"
+
+namespace shellanything
+{
+
+  PropertyResolver::PropertyResolver()
+  {
+  }
+
+  PropertyResolver::~PropertyResolver()
+  {
+  }
+
+  EnvironmentPropertyResolver::EnvironmentPropertyResolver()
+  {
+  }
+
+  EnvironmentPropertyResolver::~EnvironmentPropertyResolver()
+  {
+  }
+
+  const std::string & EnvironmentPropertyResolver::GetPrefix() const
+  {
+    static const std::string ENVIRONMENT_PREFIX = "env.";
+    return ENVIRONMENT_PREFIX;
+  }
+
+  bool EnvironmentPropertyResolver::Resolve(const std::string & name, std::string & value) const
+  {
+    value = ra::environment::GetEnvironmentVariableUtf8(name.c_str());
+    return !value.empty();
+  }
+
+} //namespace shellanything
@@ -0,0 +1,88 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_PROPERTYRESOLVER_H
+#define SA_PROPERTYRESOLVER_H
+
+#include <string>
+
+namespace shellanything
+{
+  /// <summary>
+  /// Abstract class that resolves the value of the properties of a namespace on demand.
+  /// A namespace is identified by the prefix of the property names. For example, "env.".
+  /// </summary>
+  class PropertyResolver
+  {
+  public:
+    PropertyResolver();
+    virtual ~PropertyResolver();
+
+  private:
+    // Disable copy constructor and copy operator
+    PropertyResolver(const PropertyResolver&);
+    PropertyResolver& operator=(const PropertyResolver&);
+
+  public:
+    /// <summary>
+    /// Getter for the 'prefix' parameter. This is the namespace of the properties resolved by this resolver.
+    /// </summary>
+    virtual const std::string & GetPrefix() const = 0;
+
+    /// <summary>
+    /// Resolves the value of a property of the namespace.
+    /// </summary>
+    /// <param name="name">The name of the property without the namespace prefix.</param>
+    /// <param name="value">The resolved value of the property.</param>
+    /// <returns>Returns true if the property is defined. Returns false otherwise.</returns>
+    virtual bool Resolve(const std::string & name, std::string & value) const = 0;
+  };
+
+  /// <summary>
+  /// Resolves the 'env.*' properties from the environment variables of the process.
+  /// </summary>
+  class EnvironmentPropertyResolver : public PropertyResolver
+  {
+  public:
+    EnvironmentPropertyResolver();
+    virtual ~EnvironmentPropertyResolver();
+
+    /// <summary>
+    /// Returns the namespace of environment variable properties: "env.".
+    /// </summary>
+    virtual const std::string & GetPrefix() const;
+
+    /// <summary>
+    /// Resolves the value of the given environment variable.
+    /// Environment variables with an empty value are considered undefined.
+    /// </summary>
+    /// <param name="name">The name of the environment variable.</param>
+    /// <param name="value">The value of the environment variable.</param>
+    /// <returns>Returns true if the environment variable is defined. Returns false otherwise.</returns>
+    virtual bool Resolve(const std::string & name, std::string & value) const;
+  };
+
+} //namespace shellanything
+
+#endif //SA_PROPERTYRESOLVER_H
@@ -0,0 +1,119 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "PropertyScope.h"
+
+namespace shellanything
+{
+
+  PropertyScope::PropertyScope() :
+    mParent(NULL)
+  {
+  }
+
+  PropertyScope::PropertyScope(const PropertyScope & scope)
+  {
+    (*this) = scope;
+  }
+
+  PropertyScope::~PropertyScope()
+  {
+  }
+
+  const PropertyScope & PropertyScope::operator =(const PropertyScope & scope)
+  {
+    if (this != &scope)
+    {
+      mParent     = scope.mParent;
+      mProperties = scope.mProperties;
+    }
+    return (*this);
+  }
+
+  const PropertyScope * PropertyScope::GetParent() const
+  {
+    return mParent;
+  }
+
+  void PropertyScope::SetParent(const PropertyScope * parent)
+  {
+    mParent = parent;
+  }
+
+  void PropertyScope::Clear()
+  {
+    mProperties = PropertyStore();
+  }
+
+  void PropertyScope::SetProperty(const std::string & name, const std::string & value)
+  {
+    PropertyStore::PROPERTY & p = mProperties.Get(mProperties.Intern(name));
+    p.value = value;
+    p.defined = true;
+  }
+
+  void PropertyScope::ClearProperty(const std::string & name)
+  {
+    PropertyStore::PropertyId id = mProperties.Find(name);
+    if (id == PropertyStore::INVALID_PROPERTY_ID)
+      return;
+
+    PropertyStore::PROPERTY & p = mProperties.Get(id);
+    p.value.clear();
+    p.defined = false;
+  }
+
+  bool PropertyScope::HasProperty(const std::string & name) const
+  {
+    return (Find(name.c_str(), name.size()) != NULL);
+  }
+
+  std::string PropertyScope::GetProperty(const std::string & name) const
+  {
+    const std::string * value = Find(name.c_str(), name.size());
+    if (value)
+      return (*value);
+    return std::string();
+  }
+
+  const std::string * PropertyScope::Find(const char * name, size_t length) const
+  {
+    for(const PropertyScope * scope = this; scope != NULL; scope = scope->mParent)
+    {
+      const std::string * value = scope->FindLocal(name, length);
+      if (value)
+        return value;
+    }
+    return NULL;
+  }
+
+  const std::string * PropertyScope::FindLocal(const char * name, size_t length) const
+  {
+    PropertyStore::PropertyId id = mProperties.Find(name, length);
+    if (mProperties.IsDefined(id))
+      return &mProperties.Get(id).value;
+    return NULL;
+  }
+
+} //namespace shellanything
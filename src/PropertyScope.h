@@ -0,0 +1,120 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_PROPERTYSCOPE_H
+#define SA_PROPERTYSCOPE_H
+
+#include "PropertyStore.h"
+#include <string>
+
+namespace shellanything
+{
+  /// <summary>
+  /// A layer of properties which is searched before the global properties of the PropertyManager.
+  /// A scope may have a parent scope which is searched when a property is not defined by the scope.
+  /// For example, the properties of a Context are defined in a scope which overlays the global properties.
+  /// A scope is activated on the current thread with PropertyManager::ActiveScope.
+  /// A scope must not be modified while another thread is using it.
+  /// </summary>
+  class PropertyScope
+  {
+  public:
+    PropertyScope();
+    PropertyScope(const PropertyScope & scope);
+    virtual ~PropertyScope();
+
+    /// <summary>
+    /// Copy operator
+    /// </summary>
+    const PropertyScope & operator =(const PropertyScope & scope);
+
+    /// <summary>
+    /// Returns the parent of the scope. Returns NULL if the scope have no parent.
+    /// </summary>
+    const PropertyScope * GetParent() const;
+
+    /// <summary>
+    /// Sets the parent of the scope. The parent must outlive the scope.
+    /// </summary>
+    /// <param name="parent">The parent scope. Use NULL to remove the parent.</param>
+    void SetParent(const PropertyScope * parent);
+
+    /// <summary>
+    /// Deletes all the properties of the scope. The properties of the parent are not modified.
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// Sets the value of the given property name in this scope.
+    /// </summary>
+    /// <param name="name">The name of the property to set.</param>
+    /// <param name="value">The new value of the property.</param>
+    void SetProperty(const std::string & name, const std::string & value);
+
+    /// <summary>
+    /// Deletes the given property from this scope.
+    /// </summary>
+    /// <param name="name">The name of the property to delete.</param>
+    void ClearProperty(const std::string & name);
+
+    /// <summary>
+    /// Check if a property is defined by this scope or by one of its parents.
+    /// </summary>
+    /// <param name="name">The name of the property to check.</param>
+    /// <returns>Returns true if the property is defined. Returns false otherwise.</returns>
+    bool HasProperty(const std::string & name) const;
+
+    /// <summary>
+    /// Gets the value of the given property name from this scope or from one of its parents.
+    /// </summary>
+    /// <param name="name">The name of the property to get.</param>
+    /// <returns>Returns value of the property if the property is defined. Returns an empty string otherwise.</returns>
+    std::string GetProperty(const std::string & name) const;
+
+    /// <summary>
+    /// Searches the value of the given property name in this scope and then in its parents.
+    /// </summary>
+    /// <param name="name">The name of the property. The name does not need to be null terminated.</param>
+    /// <param name="length">The length of the name in bytes.</param>
+    /// <returns>Returns a pointer to the value of the property if the property is defined. Returns NULL otherwise.</returns>
+    const std::string * Find(const char * name, size_t length) const;
+
+  protected:
+    /// <summary>
+    /// Searches the value of the given property name in this scope only.
+    /// A derived scope may override this function to compute the value of some properties on demand.
+    /// </summary>
+    /// <param name="name">The name of the property. The name does not need to be null terminated.</param>
+    /// <param name="length">The length of the name in bytes.</param>
+    /// <returns>Returns a pointer to the value of the property if the property is defined. Returns NULL otherwise.</returns>
+    virtual const std::string * FindLocal(const char * name, size_t length) const;
+
+  private:
+    const PropertyScope * mParent;
+    PropertyStore mProperties;
+  };
+
+} //namespace shellanything
+
+#endif //SA_PROPERTYSCOPE_H
@@ -0,0 +1,224 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "PropertyStore.h"
+
+namespace shellanything
+{
+  const PropertyStore::PropertyId PropertyStore::INVALID_PROPERTY_ID = (PropertyStore::PropertyId)-1;
+
+  // The table is grown when more than half of the slots are used.
+  static const size_t DEFAULT_CAPACITY = 256;
+
+  // Number of properties per page. Must be a power of 2.
+  static const size_t PAGE_SIZE = 64;
+  static const size_t PAGE_SHIFT = 6;
+
+  // Number of slots per chunk of the hash table. Must be a power of 2 and not greater than DEFAULT_CAPACITY.
+  static const size_t SLOT_CHUNK_SIZE = 256;
+  static const size_t SLOT_CHUNK_SHIFT = 8;
+
+  PropertyStore::PropertyStore() :
+    mCount(0),
+    mCapacity(0)
+  {
+    Rehash(DEFAULT_CAPACITY);
+  }
+
+  PropertyStore::PropertyStore(const PropertyStore & store)
+  {
+    (*this) = store;
+  }
+
+  PropertyStore::~PropertyStore()
+  {
+  }
+
+  const PropertyStore & PropertyStore::operator =(const PropertyStore & store)
+  {
+    if (this != &store)
+    {
+      mPages      = store.mPages;
+      mCount      = store.mCount;
+      mSlots      = store.mSlots;
+      mCapacity   = store.mCapacity;
+    }
+    return (*this);
+  }
+
+  size_t PropertyStore::Hash(const char * name, size_t length)
+  {
+    // FNV-1a
+    size_t hash = (size_t)2166136261u;
+    for(size_t i=0; i<length; i++)
+    {
+      hash ^= (unsigned char)name[i];
+      hash *= (size_t)16777619u;
+    }
+    return hash;
+  }
+
+  void PropertyStore::Rehash(size_t capacity)
+  {
+    // Always build new chunks. The previous ones may be shared with another store.
+    SlotChunkList slots;
+    slots.reserve(capacity >> SLOT_CHUNK_SHIFT);
+    for(size_t i=0; i<capacity; i+=SLOT_CHUNK_SIZE)
+    {
+      slots.push_back(SlotChunkPtr(new SlotChunk(SLOT_CHUNK_SIZE, INVALID_PROPERTY_ID)));
+    }
+    mSlots.swap(slots);
+    mCapacity = capacity;
+
+    const PropertyStore & store = *this; // do not copy a shared page
+    const size_t mask = capacity - 1;
+    for(PropertyId id=0; id<mCount; id++)
+    {
+      size_t slot = store.Get(id).hash & mask;
+      while (GetSlot(slot) != INVALID_PROPERTY_ID)
+      {
+        slot = (slot + 1) & mask;
+      }
+      SetSlot(slot, id);
+    }
+  }
+
+  PropertyStore::PropertyId PropertyStore::GetSlot(size_t slot) const
+  {
+    const SlotChunk & chunk = *mSlots[slot >> SLOT_CHUNK_SHIFT];
+    return chunk[slot & (SLOT_CHUNK_SIZE - 1)];
+  }
+
+  void PropertyStore::SetSlot(size_t slot, PropertyId id)
+  {
+    SlotChunkPtr & chunk = mSlots[slot >> SLOT_CHUNK_SHIFT];
+
+    // Copy the chunk if it is shared with another store
+    if (chunk.use_count() > 1)
+      chunk = SlotChunkPtr(new SlotChunk(*chunk));
+
+    (*chunk)[slot & (SLOT_CHUNK_SIZE - 1)] = id;
+  }
+
+  PropertyStore::PropertyId PropertyStore::Intern(const std::string & name)
+  {
+    const size_t hash = Hash(name.c_str(), name.size());
+    const size_t mask = mCapacity - 1;
+    const PropertyStore & store = *this; // do not copy a shared page or chunk
+    size_t slot = hash & mask;
+    while (store.GetSlot(slot) != INVALID_PROPERTY_ID)
+    {
+      PropertyId id = store.GetSlot(slot);
+      const PROPERTY & p = store.Get(id);
+      if (p.hash == hash && p.name == name)
+        return id; // already interned
+      slot = (slot + 1) & mask;
+    }
+
+    // Add a new undefined property
+    PropertyId id = mCount;
+    if ((id & (PAGE_SIZE - 1)) == 0)
+    {
+      PagePtr page(new Page());
+      page->reserve(PAGE_SIZE);
+      mPages.push_back(page);
+    }
+    PROPERTY p;
+    p.name = name;
+    p.hash = hash;
+    p.defined = false;
+    p.generation = 0;
+    p.resolved = false;
+    p.resolution = 0;
+    mCount++;
+    GetPage(id).push_back(p);
+    SetSlot(slot, id);
+
+    // Keep the table at most half full
+    if (mCount * 2 > mCapacity)
+      Rehash(mCapacity * 2);
+
+    return id;
+  }
+
+  PropertyStore::PropertyId PropertyStore::Find(const char * name, size_t length) const
+  {
+    const size_t hash = Hash(name, length);
+    const size_t mask = mCapacity - 1;
+    size_t slot = hash & mask;
+    while (GetSlot(slot) != INVALID_PROPERTY_ID)
+    {
+      PropertyId id = GetSlot(slot);
+      const PROPERTY & p = Get(id);
+      if (p.hash == hash && p.name.compare(0, std::string::npos, name, length) == 0)
+        return id;
+      slot = (slot + 1) & mask;
+    }
+    return INVALID_PROPERTY_ID;
+  }
+
+  PropertyStore::PropertyId PropertyStore::Find(const std::string & name) const
+  {
+    return Find(name.c_str(), name.size());
+  }
+
+  size_t PropertyStore::GetCount() const
+  {
+    return mCount;
+  }
+
+  const PropertyStore::PROPERTY & PropertyStore::Get(PropertyId id) const
+  {
+    const Page & page = *mPages[id >> PAGE_SHIFT];
+    return page[id & (PAGE_SIZE - 1)];
+  }
+
+  PropertyStore::PROPERTY & PropertyStore::Get(PropertyId id)
+  {
+    return GetPage(id)[id & (PAGE_SIZE - 1)];
+  }
+
+  PropertyStore::Page & PropertyStore::GetPage(PropertyId id)
+  {
+    PagePtr & page = mPages[id >> PAGE_SHIFT];
+
+    // Copy the page if it is shared with another store
+    if (page.use_count() > 1)
+    {
+      PagePtr copy(new Page(*page));
+      copy->reserve(PAGE_SIZE);
+      page = copy;
+    }
+
+    return *page;
+  }
+
+  bool PropertyStore::IsDefined(PropertyId id) const
+  {
+    if (id >= mCount)
+      return false;
+    return Get(id).defined;
+  }
+
+} //namespace shellanything
@@ -0,0 +1,150 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_PROPERTYSTORE_H
+#define SA_PROPERTYSTORE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace shellanything
+{
+  /// <summary>
+  /// Storage for the properties of the PropertyManager.
+  /// Property names are interned in an open addressing hash table. Each interned name is identified by a stable integer id.
+  /// Ids are never reused: a deleted property keeps its id and can be defined again later.
+  /// Looking up a property by name does not allocate memory and looking up a property by id is a simple array access.
+  /// The properties and the hash table are stored in fixed size chunks shared between copies of the store.
+  /// A chunk is copied only when it is modified (copy-on-write). Copying a store copies one pointer per chunk
+  /// and modifying a property copies a single page, regardless of the number of properties.
+  /// </summary>
+  class PropertyStore
+  {
+  public:
+    //------------------------
+    // Typedef
+    //------------------------
+    typedef size_t PropertyId;
+    typedef unsigned long long Generation;
+
+    /// <summary>
+    /// Invalid property id. No property is identified by this id.
+    /// </summary>
+    static const PropertyId INVALID_PROPERTY_ID;
+
+    struct PROPERTY
+    {
+      std::string name;
+      std::string value;
+      size_t hash;           // hash of the name
+      bool defined;
+      Generation generation; // generation of the last modification
+      bool resolved;         // true if the value was computed by a PropertyResolver
+      Generation resolution; // resolution epoch of the snapshot when the value was resolved. 0 if never resolved.
+    };
+
+    PropertyStore();
+    PropertyStore(const PropertyStore & store);
+    virtual ~PropertyStore();
+
+    /// <summary>
+    /// Copy operator
+    /// </summary>
+    const PropertyStore & operator =(const PropertyStore & store);
+
+    /// <summary>
+    /// Returns the id of the given property name. The name is interned if it is not already known.
+    /// The property is not defined by this function.
+    /// </summary>
+    /// <param name="name">The name of the property.</param>
+    /// <returns>Returns the id of the given property name.</returns>
+    PropertyId Intern(const std::string & name);
+
+    /// <summary>
+    /// Returns the id of the given property name.
+    /// </summary>
+    /// <param name="name">The name of the property. The name does not need to be NULL terminated.</param>
+    /// <param name="length">The length in bytes of the name.</param>
+    /// <returns>Returns the id of the given property name. Returns INVALID_PROPERTY_ID if the name was never interned.</returns>
+    PropertyId Find(const char * name, size_t length) const;
+
+    /// <summary>
+    /// Returns the id of the given property name.
+    /// </summary>
+    /// <param name="name">The name of the property.</param>
+    /// <returns>Returns the id of the given property name. Returns INVALID_PROPERTY_ID if the name was never interned.</returns>
+    PropertyId Find(const std::string & name) const;
+
+    /// <summary>
+    /// Returns the number of interned property names. Valid ids are in range [0, GetCount()-1].
+    /// </summary>
+    size_t GetCount() const;
+
+    /// <summary>
+    /// Returns the property identified by the given id.
+    /// </summary>
+    /// <param name="id">A valid property id.</param>
+    /// <returns>Returns the property identified by the given id.</returns>
+    const PROPERTY & Get(PropertyId id) const;
+
+    /// <summary>
+    /// Returns the property identified by the given id for modification.
+    /// The page of the property is copied if it is shared with another store.
+    /// </summary>
+    /// <param name="id">A valid property id.</param>
+    /// <returns>Returns the property identified by the given id.</returns>
+    PROPERTY & Get(PropertyId id);
+
+    /// <summary>
+    /// Returns true if the given id identifies a defined property.
+    /// </summary>
+    /// <param name="id">A property id.</param>
+    /// <returns>Returns true if the given id identifies a defined property. Returns false otherwise.</returns>
+    bool IsDefined(PropertyId id) const;
+
+  private:
+    static size_t Hash(const char * name, size_t length);
+    void Rehash(size_t capacity);
+
+    typedef std::vector<PROPERTY> Page;
+    typedef std::shared_ptr<Page> PagePtr;
+    typedef std::vector<PagePtr> PageList;
+    typedef std::vector<PropertyId> SlotChunk;
+    typedef std::shared_ptr<SlotChunk> SlotChunkPtr;
+    typedef std::vector<SlotChunkPtr> SlotChunkList;
+
+    Page & GetPage(PropertyId id);
+    PropertyId GetSlot(size_t slot) const;
+    void SetSlot(size_t slot, PropertyId id);
+
+    PageList mPages;        // properties, PAGE_SIZE properties per page
+    size_t mCount;          // number of properties
+    SlotChunkList mSlots;   // open addressing table, SLOT_CHUNK_SIZE slots per chunk
+    size_t mCapacity;       // number of slots in the table, a power of 2
+  };
+
+} //namespace shellanything
+
+#endif //SA_PROPERTYSTORE_H
@@ -0,0 +1,227 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "shellanything/PropertyTemplate.h"
+#include "PropertyManager.h"
+
+namespace shellanything
+{
+
+  PropertyTemplate::PropertyTemplate() :
+    mExpandedGeneration(PropertyManager::INVALID_GENERATION)
+  {
+  }
+
+  PropertyTemplate::PropertyTemplate(const std::string & value) :
+    mValue(value),
+    mExpandedGeneration(PropertyManager::INVALID_GENERATION)
+  {
+    Compile();
+  }
+
+  PropertyTemplate::PropertyTemplate(const PropertyTemplate & t)
+  {
+    (*this) = t;
+  }
+
+  PropertyTemplate::~PropertyTemplate()
+  {
+  }
+
+  const PropertyTemplate & PropertyTemplate::operator =(const PropertyTemplate & t)
+  {
+    if (this != &t)
+    {
+      mValue              = t.mValue;
+      mSegments           = t.mSegments;
+      mExpandedValue.clear();
+      mExpandedGeneration = PropertyManager::INVALID_GENERATION;
+    }
+    return (*this);
+  }
+
+  const std::string & PropertyTemplate::GetValue() const
+  {
+    return mValue;
+  }
+
+  void PropertyTemplate::SetValue(const std::string & iValue)
+  {
+    mValue = iValue;
+    Compile();
+  }
+
+  bool PropertyTemplate::IsLiteral() const
+  {
+    return mSegments.empty();
+  }
+
+  void PropertyTemplate::Compile()
+  {
+    mSegments.clear();
+    mExpandedValue.clear();
+    mExpandedGeneration = PropertyManager::INVALID_GENERATION;
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+
+    size_t offset = 0;
+    size_t reference_offset = 0;
+    size_t name_length = 0;
+    while (PropertyManager::FindNextPropertyReference(mValue, offset, reference_offset, name_length))
+    {
+      // Text found before the reference
+      if (reference_offset > offset)
+      {
+        SEGMENT literal;
+        literal.offset = offset;
+        literal.length = reference_offset - offset;
+        literal.reference = false;
+        literal.id = PropertyManager::INVALID_PROPERTY_ID;
+        mSegments.push_back(literal);
+      }
+
+      SEGMENT reference;
+      reference.offset = reference_offset;
+      reference.length = name_length + 3; // "${" + name + "}"
+      reference.reference = true;
+      reference.id = pmgr.GetPropertyId(mValue.substr(reference_offset + 2, name_length));
+      mSegments.push_back(reference);
+
+      // Next reference
+      offset = reference.offset + reference.length;
+    }
+
+    // A value without any property reference does not need segments
+    if (mSegments.empty())
+      return;
+
+    // Remaining text
+    if (offset < mValue.size())
+    {
+      SEGMENT literal;
+      literal.offset = offset;
+      literal.length = mValue.size() - offset;
+      literal.reference = false;
+      literal.id = PropertyManager::INVALID_PROPERTY_ID;
+      mSegments.push_back(literal);
+    }
+  }
+
+  bool PropertyTemplate::IsExpandedValueOutdated(unsigned long long generation) const
+  {
+    if (mExpandedGeneration == PropertyManager::INVALID_GENERATION)
+      return true; //never expanded
+    if (mExpandedGeneration == generation)
+      return false; //no property modified since
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    for(size_t i=0; i<mSegments.size(); i++)
+    {
+      const SEGMENT & s = mSegments[i];
+      if (s.reference && pmgr.HasChanged(s.id, mExpandedGeneration))
+        return true;
+    }
+    return false;
+  }
+
+  bool PropertyTemplate::HasScopedReference() const
+  {
+    if (PropertyManager::GetActiveScope() == NULL)
+      return false;
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    for(size_t i=0; i<mSegments.size(); i++)
+    {
+      const SEGMENT & s = mSegments[i];
+      if (s.reference && pmgr.IsScopedProperty(s.id))
+        return true;
+    }
+    return false;
+  }
+
+  void PropertyTemplate::ExpandSegments(std::string & output) const
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+
+    output.clear();
+    for(size_t i=0; i<mSegments.size(); i++)
+    {
+      const SEGMENT & s = mSegments[i];
+      if (!s.reference || !pmgr.AppendProperty(s.id, output))
+        output.append(mValue, s.offset, s.length); // literal or unknown property
+    }
+  }
+
+  std::string PropertyTemplate::Expand() const
+  {
+    if (IsLiteral())
+      return mValue;
+
+    std::string output;
+    Expand(output);
+    return output;
+  }
+
+  const std::string & PropertyTemplate::Expand(std::string & buffer) const
+  {
+    if (IsLiteral())
+      return mValue;
+
+    // Do not wait for another thread using the expanded value.
+    // The expanded value only caches the global properties: a value which depends on the active scope is not cached.
+    std::unique_lock<std::mutex> lock(mExpandedMutex, std::try_to_lock);
+    if (!lock.owns_lock() || HasScopedReference())
+    {
+      PropertyManager::ScopedSnapshot scoped_snapshot;
+      ExpandSegments(buffer);
+      return buffer;
+    }
+
+    // Expand all references from the same snapshot of the properties
+    PropertyManager::ScopedSnapshot scoped_snapshot;
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    const PropertyManager::Generation generation = pmgr.GetGeneration();
+
+    if (IsExpandedValueOutdated(generation))
+      ExpandSegments(mExpandedValue);
+
+    mExpandedGeneration = generation;
+
+    // Another thread may modify the expanded value once unlocked. The buffer keeps its capacity between calls.
+    buffer.assign(mExpandedValue);
+    return buffer;
+  }
+
+  void PropertyTemplate::GetReferencedNames(std::vector<std::string> & names) const
+  {
+    for(size_t i=0; i<mSegments.size(); i++)
+    {
+      const SEGMENT & s = mSegments[i];
+      if (s.reference)
+        names.push_back(mValue.substr(s.offset + 2, s.length - 3)); // without "${" and "}"
+    }
+  }
+
+} //namespace shellanything
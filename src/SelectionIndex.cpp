@@ -0,0 +1,255 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "SelectionIndex.h"
+#include "CaseFold.h"
+
+#include "rapidassist/filesystem_utf8.h"
+
+#include <algorithm>
+
+namespace shellanything
+{
+
+  SelectionIndex::SelectionIndex(const std::vector<std::string> & elements) :
+    mElements(elements)
+  {
+    Invalidate();
+  }
+
+  SelectionIndex::~SelectionIndex()
+  {
+  }
+
+  void SelectionIndex::Invalidate()
+  {
+    mFilenameOffsets.clear();
+    mExtensionOffsets.clear();
+    mExtensions.clear();
+    mNumDriveLetters = 0;
+    mPathsBuilt.store(false, std::memory_order_relaxed);
+
+    for(size_t i=0; i<NUM_DRIVE_CLASSES; i++)
+    {
+      mDriveClassCounts[i] = 0;
+    }
+    mDriveClassesBuilt.store(false, std::memory_order_relaxed);
+
+    mPatternMatches.reset();
+  }
+
+  /// <summary>
+  /// Orders the elements of a SelectionIndex by file extension, regardless of the case of the extensions.
+  /// </summary>
+  struct SelectionIndex::ExtensionLess
+  {
+    ExtensionLess(const SelectionIndex & index) : mIndex(index) {}
+    bool operator()(size_t a, size_t b) const
+    {
+      size_t a_length = 0;
+      size_t b_length = 0;
+      const char * a_extension = mIndex.GetExtensionPointer(a, a_length);
+      const char * b_extension = mIndex.GetExtensionPointer(b, b_length);
+      return CompareNoCase(a_extension, a_length, b_extension, b_length) < 0;
+    }
+    const SelectionIndex & mIndex;
+  };
+
+  const char * SelectionIndex::GetExtensionPointer(size_t index, size_t & length) const
+  {
+    const std::string & element = mElements[index];
+    const size_t extension_offset = mExtensionOffsets[index];
+    if (extension_offset == std::string::npos)
+    {
+      length = 0;
+      return element.c_str() + element.size();
+    }
+    length = element.size() - extension_offset;
+    return element.c_str() + extension_offset;
+  }
+
+  size_t SelectionIndex::GetCount() const
+  {
+    return mElements.size();
+  }
+
+  void SelectionIndex::BuildPaths() const
+  {
+    if (mPathsBuilt.load(std::memory_order_acquire))
+      return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mPathsBuilt.load(std::memory_order_relaxed))
+      return;
+
+    const size_t count = mElements.size();
+    mFilenameOffsets.resize(count);
+    mExtensionOffsets.resize(count);
+    for(size_t i=0; i<count; i++)
+    {
+      const std::string & element = mElements[i];
+
+      // The filename is always the end of the element
+      const std::string filename = ra::filesystem::GetFilename(element.c_str());
+      const size_t filename_offset = element.size() - filename.size();
+      mFilenameOffsets[i] = filename_offset;
+
+      size_t dot_offset = filename.rfind('.');
+      if (dot_offset == std::string::npos)
+        mExtensionOffsets[i] = std::string::npos;
+      else
+        mExtensionOffsets[i] = filename_offset + dot_offset + 1;
+
+      if (!GetDriveLetter(element).empty())
+        mNumDriveLetters++;
+    }
+
+    // Group the elements by file extension, regardless of the case of the extensions.
+    // The extensions are compared in place. Only the unique extensions are copied.
+    OffsetList order(count);
+    for(size_t i=0; i<count; i++)
+    {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), ExtensionLess(*this));
+    for(size_t i=0; i<count; i++)
+    {
+      const size_t element_index = order[i];
+      if (i > 0 && !ExtensionLess(*this)(order[i-1], element_index))
+      {
+        mExtensions.back().count++;
+        continue;
+      }
+
+      size_t length = 0;
+      const char * extension = GetExtensionPointer(element_index, length);
+      EXTENSION unique;
+      unique.name = UppercaseAscii(std::string(extension, length));
+      unique.count = 1;
+      mExtensions.push_back(unique);
+    }
+
+    mPathsBuilt.store(true, std::memory_order_release);
+  }
+
+  void SelectionIndex::BuildDriveClasses() const
+  {
+    if (mDriveClassesBuilt.load(std::memory_order_acquire))
+      return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mDriveClassesBuilt.load(std::memory_order_relaxed))
+      return;
+
+    for(size_t i=0; i<mElements.size(); i++)
+    {
+      DRIVE_CLASS value = GetDriveClassFromPath(mElements[i]);
+      mDriveClassCounts[value]++;
+    }
+
+    mDriveClassesBuilt.store(true, std::memory_order_release);
+  }
+
+  SelectionIndex::PatternMatchesPtr SelectionIndex::BuildPatternMatches(PatternSet::PatternId id) const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    PatternMatchesPtr matches = std::atomic_load(&mPatternMatches);
+    if (matches && id < matches->matcher->GetCount())
+      return matches;
+
+    PATTERN_MATCHES * new_matches = new PATTERN_MATCHES();
+    new_matches->matcher = PatternSet::GetInstance().GetMatcher();
+    const size_t num_words = new_matches->matcher->GetNumWords();
+    new_matches->bits.resize(mElements.size() * num_words);
+    std::vector<uint64_t> tested(num_words); // reused for all elements
+    for(size_t i=0; i<mElements.size() && num_words > 0; i++)
+    {
+      const std::string & element = mElements[i];
+      new_matches->matcher->Match(element.c_str(), element.size(), &new_matches->bits[i * num_words], &tested[0]);
+    }
+
+    matches.reset(new_matches);
+    std::atomic_store(&mPatternMatches, matches);
+    return matches;
+  }
+
+  std::string SelectionIndex::GetFilename(size_t index) const
+  {
+    BuildPaths();
+    return mElements[index].substr(mFilenameOffsets[index]);
+  }
+
+  std::string SelectionIndex::GetFilenameWithoutExtension(size_t index) const
+  {
+    BuildPaths();
+    const size_t filename_offset = mFilenameOffsets[index];
+    const size_t extension_offset = mExtensionOffsets[index];
+    if (extension_offset == std::string::npos)
+      return mElements[index].substr(filename_offset);
+    return mElements[index].substr(filename_offset, extension_offset - 1 - filename_offset);
+  }
+
+  std::string SelectionIndex::GetFileExtension(size_t index) const
+  {
+    BuildPaths();
+    const size_t extension_offset = mExtensionOffsets[index];
+    if (extension_offset == std::string::npos)
+      return std::string();
+    return mElements[index].substr(extension_offset);
+  }
+
+  const SelectionIndex::ExtensionList & SelectionIndex::GetUniqueExtensions() const
+  {
+    BuildPaths();
+    return mExtensions;
+  }
+
+  size_t SelectionIndex::GetNumDriveLetters() const
+  {
+    BuildPaths();
+    return mNumDriveLetters;
+  }
+
+  size_t SelectionIndex::GetNumDriveClass(DRIVE_CLASS value) const
+  {
+    if ((size_t)value >= NUM_DRIVE_CLASSES)
+      return 0;
+    BuildDriveClasses();
+    return mDriveClassCounts[value];
+  }
+
+  bool SelectionIndex::IsPatternMatch(size_t index, PatternSet::PatternId id) const
+  {
+    PatternMatchesPtr matches = std::atomic_load(&mPatternMatches);
+    if (!matches || id >= matches->matcher->GetCount())
+      matches = BuildPatternMatches(id);
+    if (id >= matches->matcher->GetCount())
+      return false; // unknown pattern
+
+    const size_t num_words = matches->matcher->GetNumWords();
+    const uint64_t word = matches->bits[index * num_words + id / 64];
+    return ((word >> (id % 64)) & 1) != 0;
+  }
+
+} //namespace shellanything
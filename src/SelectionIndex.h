@@ -0,0 +1,158 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_SELECTIONINDEX_H
+#define SA_SELECTIONINDEX_H
+
+#include "DriveClass.h"
+#include "PatternSet.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+namespace shellanything
+{
+  /// <summary>
+  /// Precomputed information about the elements of a Context, shared by validators and 'selection.*' properties.
+  /// The information is stored as a structure of arrays: one array per attribute, indexed by element.
+  /// Each group of attributes is computed once, when it is first needed, and is kept until Invalidate() is called.
+  /// The index can be used by multiple threads at the same time.
+  /// </summary>
+  class SelectionIndex
+  {
+  public:
+    /// <summary>
+    /// A unique file extension of the selection and the number of elements with this extension.
+    /// </summary>
+    struct EXTENSION
+    {
+      std::string name; // uppercase, without the dot
+      size_t count;
+    };
+    typedef std::vector<EXTENSION> ExtensionList;
+
+    /// <summary>
+    /// Creates an index of the given elements. The elements must outlive the index.
+    /// </summary>
+    SelectionIndex(const std::vector<std::string> & elements);
+    virtual ~SelectionIndex();
+
+  private:
+    // Disable copy constructor and copy operator
+    SelectionIndex(const SelectionIndex&);
+    SelectionIndex& operator=(const SelectionIndex&);
+  public:
+
+    /// <summary>
+    /// Discards the computed information. Must be called when the elements are modified.
+    /// Must not be called while another thread is using the index.
+    /// </summary>
+    void Invalidate();
+
+    /// <summary>
+    /// Returns the number of elements of the selection.
+    /// </summary>
+    size_t GetCount() const;
+
+    /// <summary>
+    /// Returns the filename of the given element, including the file extension.
+    /// </summary>
+    std::string GetFilename(size_t index) const;
+
+    /// <summary>
+    /// Returns the filename of the given element without the file extension.
+    /// </summary>
+    std::string GetFilenameWithoutExtension(size_t index) const;
+
+    /// <summary>
+    /// Returns the file extension of the given element, without the dot.
+    /// </summary>
+    std::string GetFileExtension(size_t index) const;
+
+    /// <summary>
+    /// Returns the unique file extensions of the selection. Elements without file extension are counted with an empty extension.
+    /// </summary>
+    const ExtensionList & GetUniqueExtensions() const;
+
+    /// <summary>
+    /// Returns the number of elements which are mapped to a drive letter.
+    /// </summary>
+    size_t GetNumDriveLetters() const;
+
+    /// <summary>
+    /// Returns the number of elements which are of the given drive class.
+    /// </summary>
+    size_t GetNumDriveClass(DRIVE_CLASS value) const;
+
+    /// <summary>
+    /// Returns true if the given element matches the given pattern of the PatternSet, regardless of the case of ASCII characters.
+    /// The first call matches the elements against all patterns of the PatternSet at once.
+    /// </summary>
+    bool IsPatternMatch(size_t index, PatternSet::PatternId id) const;
+
+  private:
+    /// <summary>
+    /// The patterns of the PatternSet matched by each element.
+    /// </summary>
+    struct PATTERN_MATCHES
+    {
+      PatternSet::MatcherPtr matcher;
+      std::vector<uint64_t> bits; // GetNumWords() words per element
+    };
+    typedef std::shared_ptr<const PATTERN_MATCHES> PatternMatchesPtr;
+
+    struct ExtensionLess;
+    const char * GetExtensionPointer(size_t index, size_t & length) const;
+    void BuildPaths() const;
+    void BuildDriveClasses() const;
+    PatternMatchesPtr BuildPatternMatches(PatternSet::PatternId id) const;
+
+    static const size_t NUM_DRIVE_CLASSES = DRIVE_CLASS_RAMDISK + 1;
+    typedef std::vector<size_t> OffsetList;
+
+    const std::vector<std::string> & mElements;
+
+    // Paths
+    mutable OffsetList mFilenameOffsets;  // offset of the filename in the element
+    mutable OffsetList mExtensionOffsets; // offset of the file extension in the element, after the dot. std::string::npos if the filename have no dot.
+    mutable ExtensionList mExtensions;
+    mutable size_t mNumDriveLetters;
+    mutable std::atomic<bool> mPathsBuilt;
+
+    // Drive classes
+    mutable size_t mDriveClassCounts[NUM_DRIVE_CLASSES];
+    mutable std::atomic<bool> mDriveClassesBuilt;
+
+    // Pattern matches. Built again when the PatternSet gets new patterns.
+    mutable PatternMatchesPtr mPatternMatches; // accessed with std::atomic_load() and std::atomic_store()
+
+    mutable std::mutex mMutex; // serializes the computations
+  };
+
+} //namespace shellanything
+
+#endif //SA_SELECTIONINDEX_H
@@ -27,6 +27,10 @@
 #include "shellanything/Validator.h"
 #include "PropertyManager.h"
 #include "DriveClass.h"
+#include "SelectionIndex.h"
+#include "PathTypeCache.h"
+#include "PatternSet.h"
+#include "CaseFold.h"
 #include "Wildcard.h"
 #include "rapidassist/strings.h"
 #include "rapidassist/filesystem_utf8.h"
@@ -48,8 +52,7 @@ namespace shellanything
   {
     for(size_t i=0; i<values.size(); i++)
     {
-      std::string tmp = ra::strings::Uppercase(values[i]);
-      values[i] = tmp;
+      values[i] = UppercaseAscii(values[i]);
     }
   }
 
@@ -59,7 +62,8 @@ namespace shellanything
 
   Validator::Validator() :
     mMaxFiles(std::numeric_limits<int>::max()),
-    mMaxDirectories(std::numeric_limits<int>::max())
+    mMaxDirectories(std::numeric_limits<int>::max()),
+    mInverseFlags(0)
   {
   }
 
@@ -78,6 +82,13 @@ namespace shellanything
     {
       mMaxFiles       = validator.mMaxFiles       ;
       mMaxDirectories = validator.mMaxDirectories ;
+      mInverseFlags   = validator.mInverseFlags   ;
+      mPropertyIds    = validator.mPropertyIds    ;
+      mFileExtensionList = validator.mFileExtensionList;
+      mFileExistsList = validator.mFileExistsList ;
+      mClassList      = validator.mClassList      ;
+      mPatternList    = validator.mPatternList    ;
+      mPatternIds     = validator.mPatternIds     ;
       mProperties     = validator.mProperties     ;
       mFileExtensions = validator.mFileExtensions ;
       mFileExists     = validator.mFileExists     ;
@@ -110,52 +121,94 @@ namespace shellanything
 
   const std::string & Validator::GetProperties() const
   {
-    return mProperties;
+    return mProperties.GetValue();
   }
 
   void Validator::SetProperties(const std::string & iProperties)
   {
-    mProperties = iProperties;
+    mProperties.SetValue(iProperties);
+
+    //resolve the ids of the properties once
+    mPropertyIds.clear();
+    if (mProperties.IsLiteral())
+    {
+      PropertyManager & pmgr = PropertyManager::GetInstance();
+      ra::strings::StringVector property_list = ra::strings::Split(iProperties, ";");
+      for(size_t i=0; i<property_list.size(); i++)
+      {
+        mPropertyIds.push_back(pmgr.GetPropertyId(property_list[i]));
+      }
+    }
   }
 
   const std::string & Validator::GetFileExtensions() const
   {
-    return mFileExtensions;
+    return mFileExtensions.GetValue();
   }
 
   void Validator::SetFileExtensions(const std::string & iFileExtensions)
   {
-    mFileExtensions = iFileExtensions;
+    mFileExtensions.SetValue(iFileExtensions);
+
+    //split the list once
+    mFileExtensionList.clear();
+    if (mFileExtensions.IsLiteral())
+      SplitList(iFileExtensions, true, mFileExtensionList);
   }
 
   const std::string & Validator::GetFileExists() const
   {
-    return mFileExists;
+    return mFileExists.GetValue();
   }
 
   void Validator::SetFileExists(const std::string & iFileExists)
   {
-    mFileExists = iFileExists;
+    mFileExists.SetValue(iFileExists);
+
+    //split the list once
+    mFileExistsList.clear();
+    if (mFileExists.IsLiteral())
+      SplitList(iFileExists, false, mFileExistsList);
   }
 
   const std::string & Validator::GetClass() const
   {
-    return mClass;
+    return mClass.GetValue();
   }
 
   void Validator::SetClass(const std::string & iClass)
   {
-    mClass = iClass;
+    mClass.SetValue(iClass);
+
+    //split the list once
+    mClassList = CLASS_LIST();
+    if (mClass.IsLiteral())
+      SplitClass(iClass, mClassList);
   }
 
   const std::string & Validator::GetPattern() const
   {
-    return mPattern;
+    return mPattern.GetValue();
   }
 
   void Validator::SetPattern(const std::string & iPattern)
   {
-    mPattern = iPattern;
+    mPattern.SetValue(iPattern);
+
+    //split the list once
+    mPatternList.clear();
+    mPatternIds.clear();
+    if (mPattern.IsLiteral())
+    {
+      SplitPatterns(iPattern, mPatternList);
+
+      //register the patterns in the automaton of all configured patterns
+      PatternSet & pattern_set = PatternSet::GetInstance();
+      for(size_t i=0; i<mPatternList.size(); i++)
+      {
+        mPatternIds.push_back(pattern_set.Add(mPatternList[i].GetPattern()));
+      }
+    }
   }
 
   const std::string & Validator::GetInserve() const
@@ -166,6 +219,69 @@ namespace shellanything
   void Validator::SetInserve(const std::string & iInserve)
   {
     mInverse = iInserve;
+    UpdateInverseFlags();
+  }
+
+  void Validator::UpdateInverseFlags()
+  {
+    mInverseFlags = 0;
+    if (IsInversed("maxfiles"))       mInverseFlags |= INVERSE_MAXFILES;
+    if (IsInversed("maxfolders"))     mInverseFlags |= INVERSE_MAXFOLDERS;
+    if (IsInversed("properties"))     mInverseFlags |= INVERSE_PROPERTIES;
+    if (IsInversed("fileextensions")) mInverseFlags |= INVERSE_FILEEXTENSIONS;
+    if (IsInversed("exists"))         mInverseFlags |= INVERSE_EXISTS;
+    if (IsInversed("class"))          mInverseFlags |= INVERSE_CLASS;
+    if (IsInversed("pattern"))        mInverseFlags |= INVERSE_PATTERN;
+  }
+
+  void Validator::SplitList(const std::string & value, bool uppercase, StringList & values)
+  {
+    values.clear();
+    if (value.empty())
+      return;
+
+    values = ra::strings::Split(value, ";");
+    if (uppercase)
+      Uppercase(values);
+  }
+
+  void Validator::SplitPatterns(const std::string & value, WildcardPatternList & patterns)
+  {
+    //compile each pattern, ignoring the case of the values
+    StringList values;
+    SplitList(value, false, values);
+    patterns.clear();
+    patterns.reserve(values.size());
+    for(size_t i=0; i<values.size(); i++)
+    {
+      patterns.push_back(WildcardPattern(values[i], false));
+    }
+  }
+
+  void Validator::SplitClass(const std::string & value, CLASS_LIST & class_list)
+  {
+    class_list.file_extensions.clear();
+    class_list.classes.clear();
+    if (value.empty())
+      return;
+
+    ra::strings::StringVector classes = ra::strings::Split(value, ";");
+
+    // Search for file extensions. All file extensions must be extracted from the list and evaluated all at once.
+    for(size_t i=0; i<classes.size(); i++)
+    {
+      const std::string & element = classes[i];
+
+      // Is this a class file extension filter?
+      if (!element.empty() && element[0] == '.')
+        class_list.file_extensions.push_back(UppercaseAscii(element.substr(1)));
+      else
+        class_list.classes.push_back(element);
+    }
+
+    // A single '.' does not filter any file extension
+    if (class_list.file_extensions.size() == 1 && class_list.file_extensions[0].empty())
+      class_list.file_extensions.clear();
   }
 
   bool Validator::IsInversed(const char * name) const
@@ -228,65 +344,86 @@ namespace shellanything
 
   bool Validator::Validate(const Context & iContext) const
   {
-    bool maxfiles_inversed = IsInversed("maxfiles");
+    //resolve properties through the context's scope
+    PropertyManager::ActiveScope active_scope(iContext.GetProperties());
+
+    bool maxfiles_inversed = (mInverseFlags & INVERSE_MAXFILES) != 0;
     if (!maxfiles_inversed && iContext.GetNumFiles() > mMaxFiles)
         return false; //too many files selected
     if (maxfiles_inversed && iContext.GetNumFiles() <= mMaxFiles)
         return false; //too many files selected
 
-    bool maxfolders_inversed = IsInversed("maxfolders");
+    bool maxfolders_inversed = (mInverseFlags & INVERSE_MAXFOLDERS) != 0;
     if (!maxfolders_inversed && iContext.GetNumDirectories() > mMaxDirectories)
       return false; //too many directories selected
     if (maxfolders_inversed && iContext.GetNumDirectories() <= mMaxDirectories)
       return false; //too many directories selected
 
+    //buffer for the expanded attributes, reused by each attribute
+    std::string buffer;
+
     //validate properties
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-    const std::string properties = pmgr.Expand(mProperties);
-    if (!properties.empty())
+    if (!mProperties.GetValue().empty())
     {
-      bool inversed = IsInversed("properties");
-      bool valid = ValidateProperties(iContext, properties, inversed);
+      //the ids of a literal 'properties' attribute are already known
+      bool inversed = (mInverseFlags & INVERSE_PROPERTIES) != 0;
+      bool valid = (mProperties.IsLiteral() ? ValidatePropertyIds(mPropertyIds, inversed) : ValidateProperties(iContext, mProperties.Expand(buffer), inversed));
       if (!valid)
         return false;
     }
 
     //validate file extentions
-    const std::string file_extensions = pmgr.Expand(mFileExtensions);
-    if (!file_extensions.empty())
+    if (!mFileExtensions.GetValue().empty())
     {
-      bool inversed = IsInversed("fileextensions");
+      StringList expanded;
+      if (!mFileExtensions.IsLiteral())
+        SplitList(mFileExtensions.Expand(buffer), true, expanded);
+      const StringList & file_extensions = (mFileExtensions.IsLiteral() ? mFileExtensionList : expanded);
+
+      bool inversed = (mInverseFlags & INVERSE_FILEEXTENSIONS) != 0;
       bool valid = ValidateFileExtensions(iContext, file_extensions, inversed);
       if (!valid)
         return false;
     }
 
     //validate file/directory exists
-    const std::string file_exists = pmgr.Expand(mFileExists);
-    if (!file_exists.empty())
+    if (!mFileExists.GetValue().empty())
     {
-      bool inversed = IsInversed("exists");
+      StringList expanded;
+      if (!mFileExists.IsLiteral())
+        SplitList(mFileExists.Expand(buffer), false, expanded);
+      const StringList & file_exists = (mFileExists.IsLiteral() ? mFileExistsList : expanded);
+
+      bool inversed = (mInverseFlags & INVERSE_EXISTS) != 0;
       bool valid = ValidateExists(iContext, file_exists, inversed);
       if (!valid)
         return false;
     }
 
     //validate class
-    const std::string class_ = pmgr.Expand(mClass);
-    if (!class_.empty())
+    if (!mClass.GetValue().empty())
     {
-      bool inversed = IsInversed("class");
-      bool valid = ValidateClass(iContext, class_, inversed);
+      CLASS_LIST expanded;
+      if (!mClass.IsLiteral())
+        SplitClass(mClass.Expand(buffer), expanded);
+      const CLASS_LIST & class_list = (mClass.IsLiteral() ? mClassList : expanded);
+
+      bool inversed = (mInverseFlags & INVERSE_CLASS) != 0;
+      bool valid = ValidateClass(iContext, class_list, inversed);
       if (!valid)
         return false;
     }
 
     //validate pattern
-    const std::string pattern = pmgr.Expand(mPattern);
-    if (!pattern.empty())
+    if (!mPattern.GetValue().empty())
     {
-      bool inversed = IsInversed("pattern");
-      bool valid = ValidatePattern(iContext, pattern, inversed);
+      WildcardPatternList expanded;
+      if (!mPattern.IsLiteral())
+        SplitPatterns(mPattern.Expand(buffer), expanded);
+      const WildcardPatternList & patterns = (mPattern.IsLiteral() ? mPatternList : expanded);
+
+      bool inversed = (mInverseFlags & INVERSE_PATTERN) != 0;
+      bool valid = (mPattern.IsLiteral() ? ValidatePatternIds(iContext, mPatternIds, inversed) : ValidatePattern(iContext, patterns, inversed));
       if (!valid)
         return false;
     }
@@ -294,6 +431,77 @@ namespace shellanything
     return true;
   }
 
+  int Validator::GetDependencies(PropertyIdList & property_ids) const
+  {
+    int dependencies = 0;
+
+    //the default maximums are always satisfied, or never satisfied if inversed
+    if (mMaxFiles != std::numeric_limits<int>::max() || mMaxDirectories != std::numeric_limits<int>::max())
+      dependencies |= DEPENDS_ON_COUNTS;
+
+    if (!mProperties.GetValue().empty())
+    {
+      if (mProperties.IsLiteral())
+      {
+        StringList names;
+        SplitList(mProperties.GetValue(), false, names);
+        AddPropertyDependencies(names, dependencies, property_ids);
+      }
+      else
+        dependencies |= DEPENDS_ON_ALL_PROPERTIES; //the names of the properties are expanded
+    }
+    if (!mFileExtensions.GetValue().empty())
+      dependencies |= DEPENDS_ON_EXTENSIONS;
+    if (!mFileExists.GetValue().empty())
+      dependencies |= DEPENDS_ON_FILESYSTEM;
+    if (!mClass.GetValue().empty())
+      dependencies |= DEPENDS_ON_COUNTS | DEPENDS_ON_EXTENSIONS | DEPENDS_ON_DRIVES;
+    if (!mPattern.GetValue().empty())
+      dependencies |= DEPENDS_ON_PATHS;
+
+    //properties referenced by the attributes
+    StringList names;
+    mProperties    .GetReferencedNames(names);
+    mFileExtensions.GetReferencedNames(names);
+    mFileExists    .GetReferencedNames(names);
+    mClass         .GetReferencedNames(names);
+    mPattern       .GetReferencedNames(names);
+    AddPropertyDependencies(names, dependencies, property_ids);
+
+    //the expanded names may be 'selection.*' properties, which are computed from the elements
+    if (dependencies & DEPENDS_ON_ALL_PROPERTIES)
+      dependencies |= DEPENDS_ON_PATHS;
+
+    return dependencies;
+  }
+
+  void Validator::AddPropertyDependencies(const StringList & names, int & dependencies, PropertyIdList & property_ids)
+  {
+    if (names.empty())
+      return;
+
+    static const std::string SELECTION_PREFIX = "selection.";
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    bool selection = false;
+    for(size_t i=0; i<names.size(); i++)
+    {
+      const std::string & name = names[i];
+      property_ids.push_back(pmgr.GetPropertyId(name));
+
+      //the 'selection.*' properties of the context are computed from its elements
+      if (name.compare(0, SELECTION_PREFIX.size(), SELECTION_PREFIX) == 0)
+        selection = true;
+    }
+    dependencies |= DEPENDS_ON_PROPERTIES;
+
+    if (selection)
+    {
+      dependencies |= DEPENDS_ON_PATHS;
+      property_ids.push_back(pmgr.GetPropertyId(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME));
+    }
+  }
+
   bool Validator::ValidateProperties(const Context & context, const std::string & properties, bool inversed) const
   {
     if (properties.empty())
@@ -304,25 +512,38 @@ namespace shellanything
     //split
     ra::strings::StringVector property_list = ra::strings::Split(properties, ";");
 
-    //each property specified must exists and be non-empty
+    PropertyIdList ids(property_list.size());
     for(size_t i=0; i<property_list.size(); i++)
     {
-      const std::string & p = property_list[i];
+      ids[i] = pmgr.FindPropertyId(property_list[i]);
+    }
+
+    return ValidatePropertyIds(ids, inversed);
+  }
+
+  bool Validator::ValidatePropertyIds(const PropertyIdList & ids, bool inversed) const
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+
+    //each property specified must exists and be non-empty
+    for(size_t i=0; i<ids.size(); i++)
+    {
+      const PropertyManager::PropertyId & id = ids[i];
 
       if (!inversed)
       {
-        if (!pmgr.HasProperty(p))
+        if (!pmgr.HasProperty(id))
           return false; //missing property
-        const std::string & p_value = pmgr.GetProperty(p);
+        const std::string & p_value = pmgr.GetProperty(id);
         if (p_value.empty())
           return false; //empty
       }
       else
       {
         // inversed
-        if (pmgr.HasProperty(p))
+        if (pmgr.HasProperty(id))
         {
-          const std::string & p_value = pmgr.GetProperty(p);
+          const std::string & p_value = pmgr.GetProperty(id);
           if (!p_value.empty())
             return false; //not empty
         }
@@ -332,23 +553,16 @@ namespace shellanything
     return true;
   }
 
-  bool Validator::ValidateFileExtensions(const Context & context, const std::string & file_extensions, bool inversed) const
+  bool Validator::ValidateFileExtensions(const Context & context, const StringList & accepted_file_extensions, bool inversed) const
   {
-    if (file_extensions.empty())
+    if (accepted_file_extensions.empty())
       return true;
 
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-
-    //split
-    ra::strings::StringVector accepted_file_extensions = ra::strings::Split(file_extensions, ";");
-    Uppercase(accepted_file_extensions);
-
-    //for each file selected
-    const Context::ElementList & elements = context.GetElements();
-    for(size_t i=0; i<elements.size(); i++) 
+    //for each unique file extension of the selection
+    const SelectionIndex::ExtensionList & extensions = context.GetSelectionIndex().GetUniqueExtensions();
+    for(size_t i=0; i<extensions.size(); i++) 
     {
-      const std::string & element = elements[i];
-      std::string current_file_extension = ra::strings::Uppercase(ra::filesystem::GetFileExtention(element));
+      const std::string & current_file_extension = extensions[i].name;
 
       //each file extension must be part of accepted_file_extensions
       bool found = HasValue(accepted_file_extensions, current_file_extension);
@@ -361,23 +575,19 @@ namespace shellanything
     return true;
   }
 
-  bool Validator::ValidateExists(const Context & context, const std::string & file_exists, bool inversed) const
+  bool Validator::ValidateExists(const Context & context, const StringList & mandatory_files, bool inversed) const
   {
-    if (file_exists.empty())
+    if (mandatory_files.empty())
       return true;
 
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-
-    //split
-    ra::strings::StringVector mandatory_files = ra::strings::Split(file_exists, ";");
+    //the same paths are probed on every right-click
+    PathTypeCache & path_cache = PathTypeCache::GetInstance();
 
     //for each file
     for(size_t i=0; i<mandatory_files.size(); i++)
     {
       const std::string & element = mandatory_files[i];
-      bool element_exists = false;
-      element_exists |= ra::filesystem::FileExistsUtf8(element.c_str());
-      element_exists |= ra::filesystem::DirectoryExistsUtf8(element.c_str());
+      bool element_exists = path_cache.Exists(element);
       if (!inversed && !element_exists)
         return false; //mandatory file/directory not found
       if (inversed && element_exists)
@@ -415,17 +625,13 @@ namespace shellanything
     else if (class_ == "drive")
     {
       // Selected elements must be mapped to a drive
+      const SelectionIndex & index = context.GetSelectionIndex();
+      const size_t num_drives = index.GetNumDriveLetters();
       bool valid = true;
-      const Context::ElementList & elements = context.GetElements();
-      for(size_t i=0; i<elements.size() && valid == true; i++)
-      {
-        const std::string & element = elements[i];
-        std::string drive = GetDriveLetter(element);
-        if (!inversed && drive.empty())  // All elements must be mapped to a drive
-          valid = false;
-        if (inversed && !drive.empty())  // All elements must NOT be mapped to a drive.
-          valid = false;
-      }
+      if (!inversed && num_drives != index.GetCount())  // All elements must be mapped to a drive
+        valid = false;
+      if (inversed && num_drives != 0)  // All elements must NOT be mapped to a drive.
+        valid = false;
       if (!valid)
         return false;
     }
@@ -434,17 +640,13 @@ namespace shellanything
       DRIVE_CLASS required_class = GetDriveClassFromString(class_.c_str());
 
       // Selected elements must be of the same drive class
+      const SelectionIndex & index = context.GetSelectionIndex();
+      const size_t num_required_class = index.GetNumDriveClass(required_class);
       bool valid = true;
-      const Context::ElementList & elements = context.GetElements();
-      for(size_t i=0; i<elements.size() && valid == true; i++)
-      {
-        const std::string & element = elements[i];
-        DRIVE_CLASS element_class = GetDriveClassFromPath(element);
-        if (!inversed && element_class != required_class)
-          valid = false;
-        if (inversed && element_class == required_class)
-          valid = false;
-      }
+      if (!inversed && num_required_class != index.GetCount())
+        valid = false;
+      if (inversed && num_required_class != 0)
+        valid = false;
       if (!valid)
         return false;
     }
@@ -452,68 +654,18 @@ namespace shellanything
     return true;
   }
 
-  bool Validator::ValidateClass(const Context & context, const std::string & class_, bool inversed) const
+  bool Validator::ValidateClass(const Context & context, const CLASS_LIST & class_list, bool inversed) const
   {
-    if (class_.empty())
-      return true;
-
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-
-    //split
-    ra::strings::StringVector classes = ra::strings::Split(class_, ";");
-
-    // Search for file extensions. All file extensions must be extracted from the list and evaluated all at once.
-    std::string file_extensions;
-    if (!classes.empty())
+    // Validate file extensions
+    if (!class_list.file_extensions.empty())
     {
-      static const size_t INVALID_INDEX_POSITION = (size_t)-1;
-
-      // Remember each file extension's index to delete them after searching.
-      std::vector<size_t> delete_positions;
-
-      bool found_file_extensions = false;
-
-      for(size_t i=classes.size()-1; i>=0 && i!=INVALID_INDEX_POSITION; i--)
-      {
-        const std::string & element = classes[i];
-
-        // Is this a class file extension filter?
-        if (!element.empty() && element[0] == '.')
-        {
-          // Extract the file extension
-          std::string file_extension;
-          if (element.size() >= 2)
-            file_extension = element.substr(1);
-
-          // Add to the file extension list
-          if (!file_extensions.empty())
-            file_extensions.insert(0, 1, ';');
-          file_extensions.insert(0, file_extension.c_str());
-
-          found_file_extensions = true;
-
-          // Remember this index
-          delete_positions.push_back(i);
-        }
-      }
-
-      // Delete elements of classes which were identified as file extensions
-      for(size_t i=0; i<delete_positions.size(); i++)
-      {
-        const size_t & delete_position = delete_positions[i];
-        classes.erase(classes.begin() + delete_position);
-      }
-
-      // Validate file extensions
-      if (found_file_extensions)
-      {
-        bool valid = ValidateFileExtensions(context, file_extensions, inversed);
-        if (!valid)
-          return false;
-      }
+      bool valid = ValidateFileExtensions(context, class_list.file_extensions, inversed);
+      if (!valid)
+        return false;
     }
 
     // Continue validation for the remaining class elements
+    const StringList & classes = class_list.classes;
     if (!classes.empty())
     {
       bool valid = false;
@@ -529,38 +681,55 @@ namespace shellanything
     return true;
   }
 
-  bool WildcardMatch(const ra::strings::StringVector & patterns, const char * value)
+  bool WildcardMatch(const WildcardPatternList & patterns, const std::string & value)
   {
     for(size_t j=0; j<patterns.size(); j++)
     {
-      const std::string & pattern = patterns[j];
-      bool match = WildcardMatch(pattern.c_str(), value);
+      const WildcardPattern & pattern = patterns[j];
+      bool match = pattern.Match(value);
       if (match)
         return true;
     }
     return false;
   }
 
-  bool Validator::ValidatePattern(const Context & context, const std::string & pattern, bool inversed) const
+  bool Validator::ValidatePattern(const Context & context, const WildcardPatternList & patterns, bool inversed) const
   {
-    if (pattern.empty())
+    if (patterns.empty())
       return true;
 
-    PropertyManager & pmgr = PropertyManager::GetInstance();
-
-    //split
-    ra::strings::StringVector patterns = ra::strings::Split(pattern, ";");
-    Uppercase(patterns);
-
     //for each file selected
     const Context::ElementList & elements = context.GetElements();
     for(size_t i=0; i<elements.size(); i++) 
     {
       const std::string & element = elements[i];
-      std::string element_uppercase = ra::strings::Uppercase(element);
 
       //each element must match one of the patterns
-      bool match = WildcardMatch(patterns, element_uppercase.c_str());
+      bool match = WildcardMatch(patterns, element);
+      if (!inversed && !match)
+        return false; //current file does not match any patterns
+      if (inversed && match)
+        return false; //current element is not accepted
+    }
+
+    return true;
+  }
+
+  bool Validator::ValidatePatternIds(const Context & context, const PatternIdList & ids, bool inversed) const
+  {
+    if (ids.empty())
+      return true;
+
+    //for each file selected
+    const SelectionIndex & index = context.GetSelectionIndex();
+    for(size_t i=0; i<index.GetCount(); i++) 
+    {
+      //each element must match one of the patterns
+      bool match = false;
+      for(size_t j=0; j<ids.size() && !match; j++)
+      {
+        match = index.IsPatternMatch(i, ids[j]);
+      }
       if (!inversed && !match)
         return false; //current file does not match any patterns
       if (inversed && match)
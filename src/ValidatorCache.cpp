@@ -0,0 +1,172 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "ValidatorCache.h"
+#include "rapidassist/strings.h"
+
+#include <algorithm>
+
+namespace shellanything
+{
+
+  ValidatorCache::UpdatePass::UpdatePass()
+  {
+    ValidatorCache & cache = ValidatorCache::GetInstance();
+    std::lock_guard<std::mutex> lock(cache.mMutex);
+    cache.mActivePasses++;
+  }
+
+  ValidatorCache::UpdatePass::~UpdatePass()
+  {
+    ValidatorCache & cache = ValidatorCache::GetInstance();
+    std::lock_guard<std::mutex> lock(cache.mMutex);
+    cache.mActivePasses--;
+    if (cache.mActivePasses == 0)
+      cache.mMemos.clear();
+  }
+
+  ValidatorCache & ValidatorCache::GetInstance()
+  {
+    static ValidatorCache _instance;
+    return _instance;
+  }
+
+  static const size_t MIN_PRUNE_THRESHOLD = 64;
+
+  ValidatorCache::ValidatorCache() :
+    mPruneThreshold(MIN_PRUNE_THRESHOLD),
+    mActivePasses(0),
+    mEvaluations(0),
+    mHits(0)
+  {
+  }
+
+  ValidatorCache::~ValidatorCache()
+  {
+  }
+
+  std::string ValidatorCache::GetKey(const Validator & validator)
+  {
+    // The attributes can not contain a '\0' character
+    std::string key;
+    key.append(ra::strings::ToString(validator.GetMaxFiles()));       key.append(1, '\0');
+    key.append(ra::strings::ToString(validator.GetMaxDirectories())); key.append(1, '\0');
+    key.append(validator.GetProperties());                            key.append(1, '\0');
+    key.append(validator.GetFileExtensions());                        key.append(1, '\0');
+    key.append(validator.GetFileExists());                            key.append(1, '\0');
+    key.append(validator.GetClass());                                 key.append(1, '\0');
+    key.append(validator.GetPattern());                               key.append(1, '\0');
+    key.append(validator.GetInserve());
+    return key;
+  }
+
+  ValidatorCache::ValidatorPtr ValidatorCache::Intern(const Validator & validator)
+  {
+    const std::string key = GetKey(validator);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    ValidatorMap::iterator validatorIt = mValidators.find(key);
+    if (validatorIt != mValidators.end())
+    {
+      ValidatorPtr existing = validatorIt->second.lock();
+      if (existing)
+        return existing;
+    }
+
+    // Forget about the validators of unloaded configurations.
+    // The map is only pruned once it doubled since the last prune, which keeps interning in amortized O(log n).
+    if (mValidators.size() >= mPruneThreshold)
+    {
+      for(validatorIt = mValidators.begin(); validatorIt != mValidators.end(); )
+      {
+        if (validatorIt->second.expired())
+          validatorIt = mValidators.erase(validatorIt);
+        else
+          validatorIt++;
+      }
+      mPruneThreshold = std::max(MIN_PRUNE_THRESHOLD, 2 * mValidators.size());
+    }
+
+    ValidatorPtr interned(new Validator(validator));
+    mValidators[key] = interned;
+    return interned;
+  }
+
+  bool ValidatorCache::Validate(const Validator & validator, const Context & context)
+  {
+    const PropertyManager::Generation generation = PropertyManager::GetInstance().GetGeneration();
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (mActivePasses == 0)
+      {
+        mEvaluations++;
+      }
+      else
+      {
+        MemoMap::const_iterator memoIt = mMemos.find(&validator);
+        if (memoIt != mMemos.end() && memoIt->second.context == &context && memoIt->second.generation == generation)
+        {
+          mHits++;
+          return memoIt->second.result;
+        }
+        mEvaluations++;
+      }
+    }
+
+    // Do not hold the lock while validating. Multiple threads may validate the same validator.
+    bool result = validator.Validate(context);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mActivePasses > 0)
+    {
+      MEMO & memo = mMemos[&validator];
+      memo.context = &context;
+      memo.generation = generation;
+      memo.result = result;
+    }
+    return result;
+  }
+
+  size_t ValidatorCache::GetInternedCount()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t count = 0;
+    for(ValidatorMap::const_iterator validatorIt = mValidators.begin(); validatorIt != mValidators.end(); validatorIt++)
+    {
+      if (!validatorIt->second.expired())
+        count++;
+    }
+    return count;
+  }
+
+  void ValidatorCache::GetStatistics(size_t & evaluations, size_t & hits)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    evaluations = mEvaluations;
+    hits = mHits;
+  }
+
+} //namespace shellanything
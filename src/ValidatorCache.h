@@ -0,0 +1,128 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef SA_VALIDATORCACHE_H
+#define SA_VALIDATORCACHE_H
+
+#include "shellanything/Validator.h"
+#include "shellanything/Context.h"
+#include "PropertyManager.h"
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace shellanything
+{
+  /// <summary>
+  /// Shares identical validators between menus and remembers their results during an update.
+  /// Configurations often repeat the same <visibility> or <validity> criteria on many menus.
+  /// Interned validators with identical attributes are a single immutable instance. While an UpdatePass is active,
+  /// the result of an interned validator is remembered for a given context and generation of the properties
+  /// which allows each distinct validator to be evaluated once per update.
+  /// The cache is thread safe.
+  /// </summary>
+  class ValidatorCache
+  {
+  public:
+    static ValidatorCache & GetInstance();
+  private:
+    ValidatorCache();
+    ~ValidatorCache();
+
+    // Disable copy constructor and copy operator
+    ValidatorCache(const ValidatorCache&);
+    ValidatorCache& operator=(const ValidatorCache&);
+
+  public:
+    typedef std::shared_ptr<const Validator> ValidatorPtr;
+
+    /// <summary>
+    /// Enables the memoization of the validation results for the lifetime of the object.
+    /// The remembered results are discarded when the last active pass is destroyed.
+    /// </summary>
+    class UpdatePass
+    {
+    public:
+      UpdatePass();
+      ~UpdatePass();
+    private:
+      UpdatePass(const UpdatePass&);
+      UpdatePass& operator=(const UpdatePass&);
+    };
+
+    /// <summary>
+    /// Returns the shared instance of the validators which are identical to the given validator.
+    /// </summary>
+    /// <param name="validator">The validator to intern.</param>
+    /// <returns>Returns a shared immutable validator with the same attributes as the given validator.</returns>
+    ValidatorPtr Intern(const Validator & validator);
+
+    /// <summary>
+    /// Validates the given context with the given validator.
+    /// While an UpdatePass is active, the previous result is returned if the same validator was already evaluated
+    /// with the same context and the properties were not modified since.
+    /// </summary>
+    /// <param name="validator">An interned validator. See Intern().</param>
+    /// <param name="context">The context used for validating.</param>
+    /// <returns>Returns the result of Validator::Validate().</returns>
+    bool Validate(const Validator & validator, const Context & context);
+
+    /// <summary>
+    /// Returns the number of distinct interned validators in use.
+    /// </summary>
+    size_t GetInternedCount();
+
+    /// <summary>
+    /// Returns the number of validations that were actually evaluated and the number of validations that reused a remembered result.
+    /// </summary>
+    void GetStatistics(size_t & evaluations, size_t & hits);
+
+  private:
+    static std::string GetKey(const Validator & validator);
+
+    /// <summary>
+    /// A remembered validation result.
+    /// </summary>
+    struct MEMO
+    {
+      const Context * context;
+      PropertyManager::Generation generation;
+      bool result;
+    };
+    typedef std::map<std::string, std::weak_ptr<const Validator> > ValidatorMap;
+    typedef std::map<const Validator *, MEMO> MemoMap;
+
+    std::mutex mMutex;
+    ValidatorMap mValidators;
+    size_t mPruneThreshold; // size of mValidators which triggers the removal of the expired validators
+    MemoMap mMemos;
+    size_t mActivePasses;
+    size_t mEvaluations;
+    size_t mHits;
+  };
+
+} //namespace shellanything
+
+#endif //SA_VALIDATORCACHE_H
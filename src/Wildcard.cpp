@@ -26,28 +26,12 @@
 #include <vector>
 
 #include "Wildcard.h"
+#include "CaseFold.h"
 
 namespace shellanything
 {
   static const size_t INVALID_WILDCARD_POSITION = (size_t)-1;
 
-  size_t GetNextWildcardPosition(const size_t * positions, size_t num_wildcards, size_t current)
-  {
-    for(size_t i=0; i<num_wildcards; i++)
-    {
-      const size_t & pos = positions[i];
-      if (pos == current)
-      {
-        if (i+1 < num_wildcards)
-        {
-          return positions[i+1];
-        }
-        return INVALID_WILDCARD_POSITION; //requested wildcard is the last one
-      }
-    }
-    return INVALID_WILDCARD_POSITION; //wildcard position not found
-  }
-
   size_t FindWildcardCharacters(const char * str, size_t * offsets, size_t offsets_size)
   {
     // Validate str
@@ -133,159 +117,172 @@ namespace shellanything
       strcpy(pattern, simplified_pattern.c_str());
   }
 
-  inline bool IsStarSequence(const char * pattern)
+  /// <summary>
+  /// Returns true if the given pattern, without '*' characters, matches the value at the given position.
+  /// </summary>
+  inline bool IsSegmentMatch(const char * segment, size_t segment_length, const char * value)
   {
-    if (pattern == NULL)
-      return false;
-    while(pattern[0] != '\0')
+    for(size_t i=0; i<segment_length; i++)
     {
-      if (pattern[0] != '*')
+      if (segment[i] != '?' && segment[i] != value[i])
         return false;
-      pattern++;
     }
     return true;
   }
 
-  bool WildcardSolve( const char * pattern,
-                      const char * value,
-                      const size_t * positions,
-                      size_t num_wildcards,
-                      size_t pattern_offset,
-                      size_t value_offset,
-                      WildcardList & matches)
+  /// <summary>
+  /// Adds a span to the given list, if the list is large enough.
+  /// </summary>
+  inline void SetSpan(WILDCARD_SPAN * spans, size_t max_spans, size_t span_index, char character, size_t index, size_t offset, size_t length)
+  {
+    if (spans == NULL || span_index >= max_spans)
+      return;
+    WILDCARD_SPAN & span = spans[span_index];
+    span.character = character;
+    span.index = index;
+    span.offset = offset;
+    span.length = length;
+  }
+
+  /// <summary>
+  /// Adds a span for each '?' character of a segment of the pattern.
+  /// </summary>
+  inline void SetSegmentSpans(const char * pattern, size_t segment_offset, size_t segment_length, size_t value_offset, WILDCARD_SPAN * spans, size_t max_spans, size_t & span_index)
   {
-    size_t pattern_length = strlen(pattern);
-    size_t value_length = strlen(value);
-  
-    // While pattern and value not fully solved
-    while (pattern_offset < pattern_length || value_offset < value_length)
+    for(size_t i=0; i<segment_length; i++)
     {
-      const char & pattern_char  = pattern[pattern_offset];
-      const char & value_char = value[value_offset];
-      if ( !IsWildcard(pattern_char) )
+      if (pattern[segment_offset + i] == '?')
       {
-        if (pattern_char != value_char)
-          return false; // Characters don't match!
+        SetSpan(spans, max_spans, span_index, '?', segment_offset + i, value_offset + i, 1);
+        span_index++;
+      }
+    }
+  }
 
-        // Next characters
-        pattern_offset++;
-        value_offset++;
+  bool WildcardSolve(const char * pattern, size_t pattern_length, const char * value, size_t value_length, WILDCARD_SPAN * spans, size_t max_spans, size_t * num_spans)
+  {
+    if (num_spans)
+      *num_spans = 0;
+    if (pattern == NULL || value == NULL)
+      return false;
+
+    // The '*' characters split the pattern in segments of fixed length: the prefix, the middle segments and the suffix.
+    // The solution gives the longest value to the first '*' character, then to the second, and so on.
+    // The longest value of each '*' character is obtained by placing each middle segment as far to the right as possible,
+    // starting with the last one. The placement of a segment never needs to be revisited, which makes the solver
+    // run in O(n*m) time without recursion or memory allocation.
+
+    // Count the spans and find the prefix and the suffix
+    size_t count = 0;
+    size_t first_star = INVALID_WILDCARD_POSITION;
+    size_t last_star = INVALID_WILDCARD_POSITION;
+    for(size_t i=0; i<pattern_length; i++)
+    {
+      if (pattern[i] == '?' || (pattern[i] == '*' && (i == 0 || pattern[i-1] != '*')))
+        count++;
+      if (pattern[i] == '*')
+      {
+        if (first_star == INVALID_WILDCARD_POSITION)
+          first_star = i;
+        last_star = i;
       }
-      else
+    }
+    if (num_spans)
+      *num_spans = count;
+
+    // Without '*' characters, the pattern is a single segment matching the whole value
+    if (first_star == INVALID_WILDCARD_POSITION)
+    {
+      if (pattern_length != value_length || !IsSegmentMatch(pattern, pattern_length, value))
+        return false;
+      size_t span_index = 0;
+      SetSegmentSpans(pattern, 0, pattern_length, 0, spans, max_spans, span_index);
+      return true;
+    }
+
+    // The prefix and the suffix are anchored to the start and the end of the value
+    const size_t prefix_length = first_star;
+    const size_t suffix_offset = last_star + 1;
+    const size_t suffix_length = pattern_length - suffix_offset;
+    if (prefix_length + suffix_length > value_length)
+      return false;
+    if (!IsSegmentMatch(pattern, prefix_length, value))
+      return false;
+    const size_t value_suffix_offset = value_length - suffix_length;
+    if (!IsSegmentMatch(pattern + suffix_offset, suffix_length, value + value_suffix_offset))
+      return false;
+
+    // Place the middle segments from right to left. The spans are written from the end of the list.
+    size_t span_index = count;
+    for(size_t i=suffix_length; i>0; i--)
+    {
+      if (pattern[suffix_offset + i - 1] == '?')
       {
-        // pattern_char is wildcard
-        if (pattern_char == '?')
-        {
-          // Save wildcard info
-          WILDCARD w;
-          w.character = pattern_char;
-          w.index = pattern_offset;
-          w.value = value_char;
-          matches.push_back(w);
-
-          // Next characters
-          pattern_offset++;
-          value_offset++;
-        }
-        else if (pattern_char == '*')
+        span_index--;
+        SetSpan(spans, max_spans, span_index, '?', suffix_offset + i - 1, value_suffix_offset + i - 1, 1);
+      }
+    }
+
+    // Find the first '*' character of the last '*' sequence
+    size_t star_offset = last_star;
+    while (star_offset > first_star && pattern[star_offset - 1] == '*')
+      star_offset--;
+
+    size_t value_limit = value_suffix_offset; // the '*' sequence ends at this offset in the value
+    while (star_offset > first_star)
+    {
+      // Find the segment before the '*' sequence
+      size_t segment_offset = star_offset;
+      while (pattern[segment_offset - 1] != '*')
+        segment_offset--;
+      const size_t segment_length = star_offset - segment_offset;
+
+      // Find the rightmost position of the segment
+      size_t position = INVALID_WILDCARD_POSITION;
+      if (prefix_length + segment_length <= value_limit)
+      {
+        for(size_t candidate = value_limit - segment_length + 1; candidate > prefix_length; candidate--)
         {
-          // If wildcard character '*' is the last one
-          if (pattern_offset+1 >= pattern_length)
-          {
-            // Automatically match the end of the string
-
-            // Save wildcard info
-            WILDCARD w;
-            w.character = pattern_char;
-            w.index = pattern_offset;
-            w.value = &value_char;
-            matches.push_back(w);
-
-            // If we reached a '*' sequence, move forward to the last '*' character of the sequence
-            while(pattern[pattern_offset] == '*' && (pattern_offset+1 < pattern_length) && pattern[pattern_offset+1] == '*')
-            {
-              pattern_offset++;
-            }
-
-            // Next characters
-            pattern_offset++;
-            value_offset += w.value.size();
-          }
-          else
+          if (IsSegmentMatch(pattern + segment_offset, segment_length, value + candidate - 1))
           {
-            // Wildcard character '*' is not the last one
-
-            // Compute all possibles candidates that can fit in '*' and then use recursion to check if it can be resolved.
-            // Compute the candidates from the longest to the shortest ("") for optimizing the replacement string.
-            // Since all wildcard characters must be mapped, do not compute possibilities/candidates beyond the next wildcard character.
-
-            // Compute next character
-            const char & pattern_char_next = (&pattern_char)[1];
-
-            size_t next_wildcard_position = GetNextWildcardPosition(positions, num_wildcards, pattern_offset);
-
-            // Extract non-wildcard (fixed) characters between this wildcard and the next one (or the end of the string)
-            // In order to match the current '*' character, these non-wildcard characters in the pattern will also have to match.
-            // ie: Extract "fgh" in "abc*fgh?j" or "abc*fgh"
-            std::string pattern_fixed_characters = &pattern_char_next;
-            if (next_wildcard_position != INVALID_WILDCARD_POSITION)
-            {
-              // There is at least another wildcard character after this one
-              pattern_fixed_characters = &pattern_char_next;
-              size_t size = next_wildcard_position - pattern_offset;
-              pattern_fixed_characters.resize(size);
-            }
-
-            // Compute maximum length of candidate
-            size_t remaining_characters_in_value = value_length-value_offset;
-            size_t candidate_max_length = remaining_characters_in_value-pattern_fixed_characters.size();
-
-            // Compute all possible candidates that can fit in '*' with a length in [0,candidate_max_length]
-            for(size_t length=candidate_max_length; length>=0 && length!=INVALID_WILDCARD_POSITION; length--)
-            {
-              // Assuming replacement string is the right one
-
-              std::string candidate = &value_char;
-              candidate.resize(length);
-
-              WildcardList sub_matches = matches;
-
-              // Save wildcard information
-              WILDCARD w;
-              w.character = pattern_char;
-              w.index = pattern_offset;
-              w.value = candidate;
-              sub_matches.push_back(w);
-
-              // Next characters
-              size_t sub_pattern_offset = pattern_offset + 1;
-              size_t sub_value_offset = value_offset + w.value.size();
-
-              // Execute recursive call
-              bool solved = WildcardSolve(pattern, value, positions, num_wildcards, sub_pattern_offset, sub_value_offset, sub_matches);
-              if (solved)
-              {
-                // Solved!
-                // Keep the sub matches that we found
-                matches = sub_matches;
-                return true;
-              }
-            }
-
-            // All possibilities were checked
-            // Unable to solve '*' wildcard
-            return false;
+            position = candidate - 1;
+            break;
           }
         }
       }
+      if (position == INVALID_WILDCARD_POSITION)
+        return false;
+
+      // The '*' sequence after the segment
+      span_index--;
+      SetSpan(spans, max_spans, span_index, '*', star_offset, position + segment_length, value_limit - position - segment_length);
+
+      // The '?' characters of the segment
+      for(size_t i=segment_length; i>0; i--)
+      {
+        if (pattern[segment_offset + i - 1] == '?')
+        {
+          span_index--;
+          SetSpan(spans, max_spans, span_index, '?', segment_offset + i - 1, position + i - 1, 1);
+        }
+      }
+
+      // Find the first '*' character of the previous '*' sequence
+      star_offset = segment_offset - 1;
+      while (star_offset > first_star && pattern[star_offset - 1] == '*')
+        star_offset--;
+      value_limit = position;
     }
 
-    if (pattern_offset == pattern_length && value_offset == value_length)
-      return true; // Solved
-    if ((pattern_offset == pattern_length && value_offset < value_length) ||
-        (pattern_offset == pattern_length && value_offset < value_length)     )
-      return false; // Reached the end of pattern or the end of value
-    return false; //???
+    // The first '*' sequence, after the prefix
+    span_index--;
+    SetSpan(spans, max_spans, span_index, '*', first_star, prefix_length, value_limit - prefix_length);
+
+    // The '?' characters of the prefix
+    span_index = 0;
+    SetSegmentSpans(pattern, 0, prefix_length, 0, spans, max_spans, span_index);
+
+    return true;
   }
 
   bool WildcardSolve(const char * pattern, const char * value, WildcardList & matches)
@@ -299,100 +296,124 @@ namespace shellanything
     std::string simplified_pattern = pattern;
     WildcardSimplify(simplified_pattern);
 
-    // Find all wildcard character positions
-    size_t num_wildcards = FindWildcardCharacters(simplified_pattern.c_str(), NULL, 0);
-    
-    // If no wildcard character found, the strings must be equal
-    if (num_wildcards == 0)
-      return (std::string(pattern) == std::string(value));
+    // Solve in a fixed size buffer. Larger buffers are only needed for patterns with many wildcard characters.
+    static const size_t MAX_STACK_SPANS = 64;
+    WILDCARD_SPAN stack_spans[MAX_STACK_SPANS];
+    std::vector<WILDCARD_SPAN> heap_spans;
+    WILDCARD_SPAN * spans = stack_spans;
+    size_t num_spans = 0;
+    const size_t value_length = strlen(value);
+    bool solved = WildcardSolve(simplified_pattern.c_str(), simplified_pattern.size(), value, value_length, spans, MAX_STACK_SPANS, &num_spans);
+    if (solved && num_spans > MAX_STACK_SPANS)
+    {
+      heap_spans.resize(num_spans);
+      spans = &heap_spans[0];
+      WildcardSolve(simplified_pattern.c_str(), simplified_pattern.size(), value, value_length, spans, num_spans, NULL);
+    }
+    if (!solved)
+      return false;
 
-    // Allocate memory for all wildcard positions
-    size_t * positions = new size_t[num_wildcards];
-    FindWildcardCharacters(simplified_pattern.c_str(), positions, num_wildcards*sizeof(positions[0]));
+    // Copy the value of each wildcard
+    matches.reserve(num_spans);
+    for(size_t i=0; i<num_spans; i++)
+    {
+      const WILDCARD_SPAN & span = spans[i];
+      WILDCARD w;
+      w.character = span.character;
+      w.index = span.index;
+      w.value.assign(value + span.offset, span.length);
+      matches.push_back(w);
+    }
 
-    //solve wildcards
-    bool solved = WildcardSolve(simplified_pattern.c_str(), value, positions, num_wildcards, 0, 0, matches);
+    return true;
+  }
 
-    delete[] positions;
-    positions = NULL;
+  bool WildcardMatch(const char * pattern, const char * value)
+  {
+    if (pattern == NULL || value == NULL)
+      return false;
 
-    return solved;
+    return WildcardMatch(pattern, strlen(pattern), value, strlen(value));
   }
 
-  bool WildcardMatch(const char * pattern, const char * value)
+  /// <summary>
+  /// Character comparison of a case sensitive match.
+  /// </summary>
+  struct CASE_SENSITIVE
+  {
+    static inline char Fold(char c) { return c; }
+  };
+
+  /// <summary>
+  /// Character comparison of a case insensitive match. Only ASCII characters are folded.
+  /// </summary>
+  struct CASE_INSENSITIVE
+  {
+    static inline char Fold(char c) { return ToUpperAscii(c); }
+  };
+
+  /// <summary>
+  /// Implementation of WildcardMatch() where the characters are compared with the given CASE structure.
+  /// </summary>
+  template <typename CASE>
+  static bool WildcardMatchT(const char * pattern, size_t pattern_length, const char * value, size_t value_length)
   {
     if (pattern == NULL || value == NULL)
       return false;
 
-    // Move forward in the pattern and the value as long as we have matching characters.
-    bool matching_characters = true;
-    while(matching_characters)
+    size_t pattern_offset = 0;
+    size_t value_offset = 0;
+
+    // Position of the last '*' character found in the pattern and the position in the value where the '*' stopped matching.
+    // When the pattern fails to match, the last '*' character matches one more character of the value and the matching resumes after it.
+    // Previous '*' characters do not need to be revisited: the last one can already expand to anything they would have matched.
+    size_t star_offset = INVALID_WILDCARD_POSITION;
+    size_t star_value_offset = 0;
+
+    while (value_offset < value_length)
     {
-      // If the pattern is empty, the value must also be empty to match.
-      if (pattern[0] == '\0')
+      if (pattern_offset < pattern_length && pattern[pattern_offset] == '*')
       {
-        if (value[0] == '\0')
-          return true;
-        return false;
+        // Assume '*' matches an empty string
+        star_offset = pattern_offset;
+        star_value_offset = value_offset;
+        pattern_offset++;
       }
-
-      // If the value is empty, the pattern must be '*' (or a '*' sequence) to match
-      if (value[0] == '\0')
+      else if (pattern_offset < pattern_length && (pattern[pattern_offset] == '?' || CASE::Fold(pattern[pattern_offset]) == CASE::Fold(value[value_offset])))
       {
-        if (!IsStarSequence(&pattern[0]))
-          return false;
-
-        // We have a match.
-        return true;
+        // Next characters
+        pattern_offset++;
+        value_offset++;
       }
-
-      // At this point, both the pattern and the value are not empty.
-      // Both can be moved forward if we have a match.
-
-      // Now check if we have a matching characters
-      matching_characters = false;
-
-      // If we reached a '*' sequence, move forward in the pattern to the last '*' character of the sequence
-      while(pattern[0] == '*' && pattern[1] == '*')
+      else if (star_offset != INVALID_WILDCARD_POSITION)
       {
-        pattern++;
-
-        // Even if did not had 'matching characters', set the flag to true so that we run another loop.
-        // This will allows us to check for special cases like:
-        // 1) pattern="" and value=""
-        // 2) pattern="*" and value=""
-        matching_characters = true;
+        // Backtrack: the last '*' matches one more character
+        star_value_offset++;
+        pattern_offset = star_offset + 1;
+        value_offset = star_value_offset;
       }
-
-      // If the pattern contains '?', if both pattern and value characters are equals, move forward
-      if (pattern[0] == '?' || pattern[0] == value[0])
+      else
       {
-        pattern++;
-        value++;
-
-        matching_characters = true;
+        // Characters don't match!
+        return false;
       }
     }
-  
-    // If we reached a '*' character in the pattern, there is two possibilities:
-    // 1) The '*' replaces the next value character.
-    // 2) The '*' does not replaces the next value character.
-    // Use recursion to resolve the two possibilities.
-    if (pattern[0] == '*')
-    {
-      // 1) The '*' replaces the next value character.
-      bool match = WildcardMatch(pattern, value+1);
-      if (match)
-        return true;
-
-      // 2) The '*' does not replaces the next value character.
-      match = WildcardMatch(pattern+1, value);
-      if (match)
-        return true;
-    }
 
-    // No match possible
-    return false;
+    // The value is fully matched. The rest of the pattern must be '*' characters.
+    while (pattern_offset < pattern_length && pattern[pattern_offset] == '*')
+      pattern_offset++;
+
+    return (pattern_offset == pattern_length);
+  }
+
+  bool WildcardMatch(const char * pattern, size_t pattern_length, const char * value, size_t value_length)
+  {
+    return WildcardMatchT<CASE_SENSITIVE>(pattern, pattern_length, value, value_length);
+  }
+
+  bool WildcardMatchNoCase(const char * pattern, size_t pattern_length, const char * value, size_t value_length)
+  {
+    return WildcardMatchT<CASE_INSENSITIVE>(pattern, pattern_length, value, value_length);
   }
 
 } //namespace shellanything
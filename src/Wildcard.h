@@ -47,6 +47,24 @@ namespace shellanything
   /// </summary>
   typedef std::vector<WILDCARD> WildcardList;
 
+  /// <summary>
+  /// Defines the part of a value matched by a wildcard character, without copying the value.
+  /// </summary>
+  struct WILDCARD_SPAN
+  {
+    ///<summary>The wildcard character found in the pattern.</summary>
+    char character;
+
+    ///<summary>The index at which the wildcard character was found in the pattern. The index of a '*' sequence is the index of its first character.</summary>
+    size_t index;
+
+    ///<summary>The offset in the value of the characters matched by the wildcard.</summary>
+    size_t offset;
+
+    ///<summary>The number of characters matched by the wildcard.</summary>
+    size_t length;
+  };
+
   /// <summary>
   /// Evaluates if the given character is a wildcard character supported by the library.
   /// </summary>
@@ -85,6 +103,7 @@ namespace shellanything
   /// <summary>
   /// Returns true if the given pattern with wildcard characters can be expanded to match the given value.
   /// The function also returns the expanded value for each wildcard character match.
+  /// The captures follow the same rule as the offset-based WildcardSolve(): each '*' takes the longest span, left to right.
   /// If you do not need to know the value of the wildcard characters, use the function <see cref="WildcardMatch()"/> which is faster.
   /// </summary>
   /// <param name="pattern">The string with the wildcard pattern.</param>
@@ -93,6 +112,25 @@ namespace shellanything
   /// <returns>Returns true if the given pattern with wildcard characters can be expanded to match the given value. Returns false otherwise.</returns>
   bool WildcardSolve(const char * pattern, const char * value, WildcardList & matches);
 
+  /// <summary>
+  /// Returns true if the given pattern with wildcard characters can be expanded to match the given value.
+  /// The function also returns the part of the value matched by each wildcard character, in the order of the pattern.
+  /// A sequence of '*' characters is a single wildcard. When multiple solutions exist, the captures follow this rule:
+  /// each '*' takes the longest span, left to right. The first '*' takes the longest span which still allows the rest of the pattern to match,
+  /// then the next '*' takes the longest remaining span, and so on. A '*' may capture an empty span, including at the end of the value.
+  /// For example, "*a*" on "bbaaaa" captures "bbaaa" and "", and "*b*" on "b" captures "" and "".
+  /// The function does not allocate memory. The worst case runs in O(n*m) where n and m are the lengths of the pattern and value.
+  /// </summary>
+  /// <param name="pattern">The string with the wildcard pattern.</param>
+  /// <param name="pattern_length">The length of the pattern in bytes.</param>
+  /// <param name="value">The value to match.</param>
+  /// <param name="value_length">The length of the value in bytes.</param>
+  /// <param name="spans">An array of WILDCARD_SPAN elements which, if provided, contains the span of each wildcard. Can be NULL.</param>
+  /// <param name="max_spans">The number of elements of the 'spans' array. Spans beyond this number are not returned.</param>
+  /// <param name="num_spans">If not NULL, receives the number of wildcards of the pattern. The 'spans' array is incomplete if this number is greater than 'max_spans'.</param>
+  /// <returns>Returns true if the given pattern with wildcard characters can be expanded to match the given value. Returns false otherwise.</returns>
+  bool WildcardSolve(const char * pattern, size_t pattern_length, const char * value, size_t value_length, WILDCARD_SPAN * spans, size_t max_spans, size_t * num_spans);
+
   /// <summary>
   /// Returns true if the given pattern with wildcard characters matches the given value.
   /// If you need to know the value of the wildcard characters, use the function <see cref="WildcardSolve()"/>.
@@ -102,6 +140,29 @@ namespace shellanything
   /// <returns>Returns true if the given pattern with wildcard characters matches the given value. Returns false otherwise.</returns>
   bool WildcardMatch(const char * pattern, const char * value);
 
+  /// <summary>
+  /// Returns true if the given pattern with wildcard characters matches the given value.
+  /// The function does not allocate memory. The worst case runs in O(n*m) where n and m are the lengths of the pattern and value.
+  /// </summary>
+  /// <param name="pattern">The string with the wildcard pattern.</param>
+  /// <param name="pattern_length">The length of the pattern in bytes.</param>
+  /// <param name="value">The value to match.</param>
+  /// <param name="value_length">The length of the value in bytes.</param>
+  /// <returns>Returns true if the given pattern with wildcard characters matches the given value. Returns false otherwise.</returns>
+  bool WildcardMatch(const char * pattern, size_t pattern_length, const char * value, size_t value_length);
+
+  /// <summary>
+  /// Returns true if the given pattern with wildcard characters matches the given value, ignoring the case of ASCII characters.
+  /// The characters are compared in place: neither the pattern nor the value is copied.
+  /// Multi-byte utf-8 characters must be identical to match.
+  /// </summary>
+  /// <param name="pattern">The string with the wildcard pattern.</param>
+  /// <param name="pattern_length">The length of the pattern in bytes.</param>
+  /// <param name="value">The value to match.</param>
+  /// <param name="value_length">The length of the value in bytes.</param>
+  /// <returns>Returns true if the given pattern with wildcard characters matches the given value. Returns false otherwise.</returns>
+  bool WildcardMatchNoCase(const char * pattern, size_t pattern_length, const char * value, size_t value_length);
+
 } //namespace shellanything
 
 #endif //SA_WILDCARD_H
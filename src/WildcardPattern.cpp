@@ -0,0 +1,550 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "shellanything/WildcardPattern.h"
+#include "Wildcard.h"
+#include "CaseFold.h"
+
+#include <string.h>
+
+namespace shellanything
+{
+  static const size_t INVALID_SEGMENT = (size_t)-1;
+  static const char GLOB_PREFIX[] = "glob:";
+  static const size_t GLOB_PREFIX_LENGTH = sizeof(GLOB_PREFIX) - 1;
+
+  /// <summary>
+  /// Returns true if the given pattern starts with the "glob:" prefix of path patterns, regardless of the case of the prefix.
+  /// </summary>
+  static inline bool HasGlobPrefix(const std::string & pattern)
+  {
+    return (pattern.size() >= GLOB_PREFIX_LENGTH && EqualsNoCase(pattern.c_str(), GLOB_PREFIX, GLOB_PREFIX_LENGTH));
+  }
+
+  /// <summary>
+  /// Returns true if the given literal string is found in the given value.
+  /// The search jumps to the occurrences of the first character with memchr() which is vectorized by most C libraries.
+  /// </summary>
+  static bool HasLiteral(const char * value, size_t length, const char * literal, size_t literal_length)
+  {
+    if (literal_length == 0)
+      return true;
+    if (literal_length > length)
+      return false;
+
+    const char first = literal[0];
+    const char * last = value + length - literal_length; // last position where the literal can start
+    const char * position = value;
+    while (position <= last)
+    {
+      position = (const char *)memchr(position, first, last - position + 1);
+      if (position == NULL)
+        return false;
+      if (memcmp(position + 1, literal + 1, literal_length - 1) == 0)
+        return true;
+      position++;
+    }
+    return false;
+  }
+
+  /// <summary>
+  /// Returns true if the given character separates the segments of a path.
+  /// </summary>
+  static inline bool IsPathSeparator(char c)
+  {
+    return (c == '\\' || c == '/');
+  }
+
+  /// <summary>
+  /// Returns the end of the path segment which starts at the given offset.
+  /// </summary>
+  static inline size_t GetSegmentEnd(const char * value, size_t length, size_t offset)
+  {
+    while (offset < length && !IsPathSeparator(value[offset]))
+      offset++;
+    return offset;
+  }
+
+  /// <summary>
+  /// Returns the start of the last path segment of the given value.
+  /// </summary>
+  static inline size_t GetSegmentStart(const char * value, size_t length)
+  {
+    while (length > 0 && !IsPathSeparator(value[length - 1]))
+      length--;
+    return length;
+  }
+
+  /// <summary>
+  /// Matches a single character of a value with the element of a glob pattern at the given offset: a '?' character, a "[...]" set or a literal character.
+  /// On success, the offset is moved to the next element of the pattern.
+  /// A '[' character without a matching ']' character is a literal character.
+  /// </summary>
+  static bool MatchGlobElement(const char * pattern, size_t pattern_length, size_t & offset, char c, bool case_sensitive)
+  {
+    const char value_char = (case_sensitive ? c : ToUpperAscii(c));
+    const char pattern_char = pattern[offset];
+    if (pattern_char == '?')
+    {
+      offset++;
+      return true;
+    }
+
+    if (pattern_char == '[')
+    {
+      size_t i = offset + 1;
+      const bool negate = (i < pattern_length && (pattern[i] == '!' || pattern[i] == '^'));
+      if (negate)
+        i++;
+
+      // A ']' character at the beginning of the set is a member of the set
+      bool matched = false;
+      bool first = true;
+      while (i < pattern_length && (pattern[i] != ']' || first))
+      {
+        first = false;
+        const char low = pattern[i];
+        char high = low;
+        if (i + 2 < pattern_length && pattern[i+1] == '-' && pattern[i+2] != ']')
+        {
+          high = pattern[i+2];
+          i += 3;
+        }
+        else
+          i++;
+        if ((unsigned char)low <= (unsigned char)value_char && (unsigned char)value_char <= (unsigned char)high)
+          matched = true;
+      }
+
+      if (i < pattern_length)
+      {
+        offset = i + 1; // skip the set
+        return (matched != negate);
+      }
+    }
+
+    // Literal character
+    if (pattern_char != value_char)
+      return false;
+    offset++;
+    return true;
+  }
+
+  inline bool WildcardPattern::Equals(const char * a, const char * b, size_t length) const
+  {
+    if (mCaseSensitive)
+      return (memcmp(a, b, length) == 0);
+    return EqualsNoCase(a, b, length);
+  }
+
+  WildcardPattern::WildcardPattern() :
+    mCaseSensitive(true)
+  {
+    Compile();
+  }
+
+  WildcardPattern::WildcardPattern(const std::string & pattern) :
+    mPattern(pattern),
+    mCaseSensitive(true)
+  {
+    Compile();
+  }
+
+  WildcardPattern::WildcardPattern(const std::string & pattern, bool case_sensitive) :
+    mPattern(pattern),
+    mCaseSensitive(case_sensitive)
+  {
+    Compile();
+  }
+
+  WildcardPattern::~WildcardPattern()
+  {
+  }
+
+  const std::string & WildcardPattern::GetPattern() const
+  {
+    return mPattern;
+  }
+
+  void WildcardPattern::SetPattern(const std::string & iPattern)
+  {
+    mPattern = iPattern;
+    Compile();
+  }
+
+  bool WildcardPattern::IsCaseSensitive() const
+  {
+    return mCaseSensitive;
+  }
+
+  bool WildcardPattern::IsGlob() const
+  {
+    return mGlob;
+  }
+
+  std::string WildcardPattern::GetLongestLiteral() const
+  {
+    // Search the longest string without wildcard characters.
+    // The sets of a glob pattern and its path separators (which may be '\\' or '/' in the value) are not literals.
+    const size_t length = mPattern.size();
+    size_t best_offset = 0;
+    size_t best_length = 0;
+    size_t offset = (mGlob ? GLOB_PREFIX_LENGTH : 0);
+    while (offset < length)
+    {
+      size_t end = offset;
+      while (end < length && !IsWildcard(mPattern[end]) && !(mGlob && (mPattern[end] == '[' || IsPathSeparator(mPattern[end]))))
+        end++;
+      if (end - offset > best_length)
+      {
+        best_offset = offset;
+        best_length = end - offset;
+      }
+
+      // Skip the set
+      if (mGlob && end < length && mPattern[end] == '[')
+      {
+        size_t set_end = mPattern.find(']', end + 2);
+        if (set_end != std::string::npos)
+          end = set_end;
+      }
+      offset = end + 1;
+    }
+    return mPattern.substr(best_offset, best_length);
+  }
+
+  void WildcardPattern::Compile()
+  {
+    if (!mCaseSensitive)
+      mPattern = UppercaseAscii(mPattern);
+
+    const size_t length = mPattern.size();
+
+    mWildcard = false;
+    mStar = false;
+    mPrefixSuffixOnly = false;
+    mMinLength = 0;
+    mPrefixLength = length;
+    mSuffixLength = 0;
+    mLiteralOffset = 0;
+    mLiteralLength = 0;
+    mGlob = false;
+    mSegments.clear();
+    mLastGlobstar = INVALID_SEGMENT;
+
+    // Only the patterns with the "glob:" prefix are path patterns.
+    // A '[' character or "**" in other patterns keep their meaning of WildcardMatch(): a literal character and two '*' characters.
+    if (HasGlobPrefix(mPattern))
+    {
+      CompileGlob();
+      return;
+    }
+
+    size_t num_stars = 0;
+    size_t num_questions = 0;
+    size_t first_wildcard = length;
+    size_t last_wildcard = 0;
+    for(size_t i=0; i<length; i++)
+    {
+      const char c = mPattern[i];
+      if (!IsWildcard(c))
+        continue;
+
+      if (c == '*')
+        num_stars++;
+      else
+        num_questions++;
+
+      if (first_wildcard == length)
+        first_wildcard = i;
+      last_wildcard = i;
+    }
+
+    mMinLength = length - num_stars;
+    if (first_wildcard == length)
+      return; // Literal pattern
+
+    mWildcard = true;
+    mStar = (num_stars > 0);
+    mPrefixLength = first_wildcard;
+    mSuffixLength = length - last_wildcard - 1;
+
+    // Patterns such as "*.TXT" or "FOO*" are solved with the prefix and the suffix
+    mPrefixSuffixOnly = (num_stars == 1 && num_questions == 0);
+
+    // Find the longest literal string between the first and the last wildcard characters
+    size_t offset = first_wildcard + 1;
+    while (offset < last_wildcard)
+    {
+      size_t end = offset;
+      while (end < last_wildcard && !IsWildcard(mPattern[end]))
+        end++;
+      if (end - offset > mLiteralLength)
+      {
+        mLiteralOffset = offset;
+        mLiteralLength = end - offset;
+      }
+      offset = end + 1;
+    }
+  }
+
+  void WildcardPattern::CompileGlob()
+  {
+    mGlob = true;
+    mWildcard = true;
+
+    // The "glob:" prefix is not part of the segments.
+    // The literal segments before the first wildcard character must match the beginning of the value
+    const size_t length = mPattern.size();
+    size_t first_wildcard = GLOB_PREFIX_LENGTH;
+    while (first_wildcard < length && !IsWildcard(mPattern[first_wildcard]) && mPattern[first_wildcard] != '[')
+      first_wildcard++;
+    mPrefixLength = 0;
+    for(size_t i=GLOB_PREFIX_LENGTH; i<first_wildcard; i++)
+    {
+      if (IsPathSeparator(mPattern[i]))
+        mPrefixLength = i - GLOB_PREFIX_LENGTH;
+    }
+
+    // The literal characters at the end of the last segment must match the end of the value
+    mSuffixLength = 0;
+    while (mSuffixLength < length - GLOB_PREFIX_LENGTH)
+    {
+      const char c = mPattern[length - mSuffixLength - 1];
+      if (IsWildcard(c) || c == '[' || c == ']' || IsPathSeparator(c))
+        break;
+      mSuffixLength++;
+    }
+    size_t offset = GLOB_PREFIX_LENGTH;
+    while (true)
+    {
+      SEGMENT segment;
+      segment.offset = offset;
+      segment.length = GetSegmentEnd(mPattern.c_str(), length, offset) - offset;
+      segment.kind = SEGMENT::SEGMENT_LITERAL;
+      if (segment.length == 2 && mPattern[offset] == '*' && mPattern[offset + 1] == '*')
+        segment.kind = SEGMENT::SEGMENT_GLOBSTAR;
+      else
+      {
+        for(size_t i=0; i<segment.length; i++)
+        {
+          const char c = mPattern[offset + i];
+          if (c == '[')
+            segment.kind = SEGMENT::SEGMENT_SET;
+          else if (IsWildcard(c) && segment.kind == SEGMENT::SEGMENT_LITERAL)
+            segment.kind = SEGMENT::SEGMENT_WILDCARD;
+        }
+      }
+
+      // Consecutive "**" segments are equivalent to a single one
+      bool repeated = (segment.kind == SEGMENT::SEGMENT_GLOBSTAR && !mSegments.empty() && mSegments.back().kind == SEGMENT::SEGMENT_GLOBSTAR);
+      if (!repeated)
+      {
+        if (segment.kind == SEGMENT::SEGMENT_GLOBSTAR)
+          mLastGlobstar = mSegments.size();
+        mSegments.push_back(segment);
+      }
+
+      offset += segment.length;
+      if (offset >= length)
+        break;
+      offset++; // skip the separator
+    }
+  }
+
+  bool WildcardPattern::MatchSegment(const SEGMENT & segment, const char * value, size_t length) const
+  {
+    const char * pattern = mPattern.c_str() + segment.offset;
+    const size_t pattern_length = segment.length;
+
+    if (segment.kind == SEGMENT::SEGMENT_LITERAL)
+      return (length == pattern_length && Equals(value, pattern, length));
+    if (segment.kind == SEGMENT::SEGMENT_WILDCARD)
+    {
+      if (mCaseSensitive)
+        return WildcardMatch(pattern, pattern_length, value, length);
+      return WildcardMatchNoCase(pattern, pattern_length, value, length);
+    }
+
+    // Same algorithm as WildcardMatch(), where a pattern element may be a set of characters.
+    // The value does not contain path separators: '*' can not match beyond the segment.
+    size_t pattern_offset = 0;
+    size_t value_offset = 0;
+    size_t star_offset = std::string::npos; // offset of the pattern after the last '*' character
+    size_t star_value_offset = 0;
+    while (value_offset < length)
+    {
+      if (pattern_offset < pattern_length && pattern[pattern_offset] == '*')
+      {
+        while (pattern_offset < pattern_length && pattern[pattern_offset] == '*')
+          pattern_offset++;
+        star_offset = pattern_offset;
+        star_value_offset = value_offset;
+      }
+      else if (pattern_offset < pattern_length && MatchGlobElement(pattern, pattern_length, pattern_offset, value[value_offset], mCaseSensitive))
+      {
+        value_offset++;
+      }
+      else if (star_offset != std::string::npos)
+      {
+        // Backtrack: the last '*' matches one more character
+        star_value_offset++;
+        pattern_offset = star_offset;
+        value_offset = star_value_offset;
+      }
+      else
+        return false;
+    }
+
+    while (pattern_offset < pattern_length && pattern[pattern_offset] == '*')
+      pattern_offset++;
+    return (pattern_offset == pattern_length);
+  }
+
+  bool WildcardPattern::MatchGlob(const char * value, size_t length) const
+  {
+    // Match the segments of the value with the segments of the pattern.
+    // A "**" segment is a '*' character at the segment level: the same backtracking as WildcardMatch() is used.
+    // A segment of the value which does not match a literal segment is rejected without looking at the next segments.
+    size_t num_segments = mSegments.size();
+    bool value_matched = false; // true when all segments of the value are matched
+
+    // Compare the literal segments at the beginning of the pattern, where '\\' and '/' characters are equivalent
+    if (length < mPrefixLength)
+      return false;
+    for(size_t i=0; i<mPrefixLength; i++)
+    {
+      const char pattern_char = mPattern[GLOB_PREFIX_LENGTH + i];
+      const char value_char = (mCaseSensitive ? value[i] : ToUpperAscii(value[i]));
+      if (pattern_char != value_char && !(IsPathSeparator(pattern_char) && IsPathSeparator(value_char)))
+        return false;
+    }
+
+    // Compare the literal characters at the end of the pattern
+    if (length < mSuffixLength || !Equals(value + length - mSuffixLength, mPattern.c_str() + mPattern.size() - mSuffixLength, mSuffixLength))
+      return false;
+
+    // The segments after the last "**" segment are anchored to the end of the value. Match them first, from the end.
+    if (mLastGlobstar != INVALID_SEGMENT)
+    {
+      while (num_segments > mLastGlobstar + 1)
+      {
+        if (value_matched)
+          return false;
+        const size_t start = GetSegmentStart(value, length);
+        if (!MatchSegment(mSegments[num_segments - 1], value + start, length - start))
+          return false;
+        num_segments--;
+        if (start == 0)
+          value_matched = true;
+        else
+          length = start - 1; // remove the segment and its separator
+      }
+    }
+
+    const size_t value_end = length + 1; // offset of the value when all its segments are matched
+    size_t segment_index = 0;
+    size_t value_offset = (value_matched ? value_end : 0);
+    size_t star_index = INVALID_SEGMENT;
+    size_t star_value_offset = 0;
+    while (value_offset != value_end)
+    {
+      const size_t value_segment_end = GetSegmentEnd(value, length, value_offset);
+      if (segment_index < num_segments && mSegments[segment_index].kind == SEGMENT::SEGMENT_GLOBSTAR)
+      {
+        // Assume "**" matches no segment
+        star_index = segment_index;
+        star_value_offset = value_offset;
+        segment_index++;
+      }
+      else if (segment_index < num_segments && MatchSegment(mSegments[segment_index], value + value_offset, value_segment_end - value_offset))
+      {
+        // Next segments
+        segment_index++;
+        value_offset = value_segment_end + 1;
+      }
+      else if (star_index != INVALID_SEGMENT)
+      {
+        // Backtrack: the last "**" matches one more segment
+        star_value_offset = GetSegmentEnd(value, length, star_value_offset) + 1;
+        segment_index = star_index + 1;
+        value_offset = star_value_offset;
+      }
+      else
+        return false;
+    }
+
+    // All segments of the value are matched. The rest of the pattern must be "**" segments.
+    while (segment_index < num_segments && mSegments[segment_index].kind == SEGMENT::SEGMENT_GLOBSTAR)
+      segment_index++;
+    return (segment_index == num_segments);
+  }
+
+  bool WildcardPattern::Match(const char * value, size_t length) const
+  {
+    if (value == NULL)
+      return false;
+    if (mGlob)
+      return MatchGlob(value, length);
+
+    const char * pattern = mPattern.c_str();
+    const size_t pattern_length = mPattern.size();
+
+    if (!mWildcard)
+      return (length == pattern_length && Equals(pattern, value, length));
+
+    if (length < mMinLength)
+      return false;
+    if (!mStar && length != mMinLength)
+      return false; // Each '?' character matches a single character
+
+    // Compare the literal prefix and suffix
+    if (!Equals(value, pattern, mPrefixLength))
+      return false;
+    if (!Equals(value + length - mSuffixLength, pattern + pattern_length - mSuffixLength, mSuffixLength))
+      return false;
+    if (mPrefixSuffixOnly)
+      return true;
+
+    // The remaining part of the value must contain the longest literal
+    const char * middle = value + mPrefixLength;
+    const size_t middle_length = length - mPrefixLength - mSuffixLength;
+    const char * literal = pattern + mLiteralOffset;
+    if (mCaseSensitive ? !HasLiteral(middle, middle_length, literal, mLiteralLength) : !HasLiteralNoCase(middle, middle_length, literal, mLiteralLength))
+      return false;
+
+    // Run the complete matcher on the characters between the prefix and the suffix
+    const char * middle_pattern = pattern + mPrefixLength;
+    const size_t middle_pattern_length = pattern_length - mPrefixLength - mSuffixLength;
+    if (mCaseSensitive)
+      return WildcardMatch(middle_pattern, middle_pattern_length, middle, middle_length);
+    return WildcardMatchNoCase(middle_pattern, middle_pattern_length, middle, middle_length);
+  }
+
+  bool WildcardPattern::Match(const std::string & value) const
+  {
+    return Match(value.c_str(), value.size());
+  }
+
+} //namespace shellanything
@@ -0,0 +1,213 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+
+#include "WorkerPool.h"
+
+#include <thread>
+#include <chrono>
+#include <system_error>
+
+namespace shellanything
+{
+  const size_t WorkerPool::MAX_THREADS = 32;
+  const unsigned int WorkerPool::IDLE_TIMEOUT = 60000;
+
+  WorkerPool & WorkerPool::GetInstance()
+  {
+    // Never destroyed: the worker threads are detached and may still be waiting for a job when the process exits.
+    static WorkerPool * _instance = new WorkerPool();
+    return *_instance;
+  }
+
+  WorkerPool::WorkerPool() :
+    mNumThreads(0),
+    mNumIdle(0)
+  {
+  }
+
+  WorkerPool::~WorkerPool()
+  {
+  }
+
+  /// <summary>
+  /// Withdraws a posted job and waits for the worker threads executing it, even if the calling thread throws.
+  /// </summary>
+  class WorkerPool::PostGuard
+  {
+  public:
+    PostGuard(WorkerPool & pool, POST & post) :
+      mPool(pool),
+      mPost(post)
+    {
+    }
+
+    ~PostGuard()
+    {
+      Wait();
+    }
+
+    void Wait()
+    {
+      std::unique_lock<std::mutex> lock(mPool.mMutex);
+
+      // The job is already done. Worker threads which did not take it yet must not start it.
+      if (mPost.wanted > 0)
+      {
+        mPool.mPosts.remove(&mPost);
+        mPost.wanted = 0;
+      }
+
+      while (mPost.running > 0)
+      {
+        mPool.mDone.wait(lock);
+      }
+    }
+
+  private:
+    WorkerPool & mPool;
+    POST & mPost;
+  };
+
+  void WorkerPool::Run(Job & job, size_t iNumThreads)
+  {
+    if (iNumThreads < 2)
+    {
+      job.Execute();
+      return;
+    }
+
+    POST post;
+    post.job = &job;
+    post.wanted = iNumThreads - 1;
+    post.running = 0;
+
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+
+      // Idle threads are first taken by the jobs posted before this one
+      size_t reserved = 0;
+      for(PostList::const_iterator postIt = mPosts.begin(); postIt != mPosts.end(); ++postIt)
+      {
+        reserved += (*postIt)->wanted;
+      }
+
+      // Create the missing threads. The calling thread does the remaining work if a thread cannot be created.
+      while (mNumIdle < reserved + post.wanted && AddThread())
+      {
+      }
+      const size_t available = (mNumIdle > reserved ? mNumIdle - reserved : 0);
+      if (post.wanted > available)
+        post.wanted = available;
+
+      if (post.wanted > 0)
+      {
+        mPosts.push_back(&post);
+        mPosted.notify_all();
+      }
+    }
+
+    PostGuard guard(*this, post);
+    job.Execute();
+    guard.Wait();
+
+    if (post.error)
+      std::rethrow_exception(post.error);
+  }
+
+  size_t WorkerPool::GetNumThreads()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mNumThreads;
+  }
+
+  bool WorkerPool::AddThread()
+  {
+    // mMutex must be locked by the caller
+    if (mNumThreads >= MAX_THREADS)
+      return false;
+
+    try
+    {
+      std::thread worker(&WorkerPool::WorkerMain, this);
+      worker.detach();
+    }
+    catch (const std::system_error &)
+    {
+      return false;
+    }
+
+    mNumThreads++;
+    mNumIdle++;
+    return true;
+  }
+
+  void WorkerPool::WorkerMain()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    for(;;)
+    {
+      // Wait for a job
+      while (mPosts.empty())
+      {
+        std::cv_status status = mPosted.wait_for(lock, std::chrono::milliseconds(IDLE_TIMEOUT));
+        if (status == std::cv_status::timeout && mPosts.empty())
+        {
+          mNumIdle--;
+          mNumThreads--;
+          return;
+        }
+      }
+
+      POST * post = mPosts.front();
+      post->wanted--;
+      post->running++;
+      if (post->wanted == 0)
+        mPosts.pop_front();
+      mNumIdle--;
+
+      lock.unlock();
+      std::exception_ptr error;
+      try
+      {
+        post->job->Execute();
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+      lock.lock();
+
+      if (error && !post->error)
+        post->error = error;
+      mNumIdle++;
+
+      // The post is destroyed once the posting thread is notified
+      post->running--;
+      if (post->running == 0)
+        mDone.notify_all();
+    }
+  }
+
+} //namespace shellanything
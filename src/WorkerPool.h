@@ -0,0 +1,122 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+
+#ifndef SA_WORKERPOOL_H
+#define SA_WORKERPOOL_H
+
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <list>
+
+namespace shellanything
+{
+  /// <summary>
+  /// Process-wide pool of worker threads shared by GetPathTypes() and ConfigManager::Update().
+  /// The threads are created on first use and wait for more work once a job is completed.
+  /// A worker thread which stays idle for IDLE_TIMEOUT milliseconds exits. The pool is thread safe.
+  /// </summary>
+  class WorkerPool
+  {
+  public:
+    static WorkerPool & GetInstance();
+  private:
+    WorkerPool();
+    ~WorkerPool();
+
+    // Disable copy constructor and copy operator
+    WorkerPool(const WorkerPool&);
+    WorkerPool& operator=(const WorkerPool&);
+
+  public:
+    /// <summary>
+    /// Maximum number of worker threads of the pool.
+    /// </summary>
+    static const size_t MAX_THREADS;
+
+    /// <summary>
+    /// Time, in milliseconds, after which an idle worker thread exits.
+    /// </summary>
+    static const unsigned int IDLE_TIMEOUT;
+
+    /// <summary>
+    /// Work executed concurrently by multiple threads.
+    /// Execute() is called once per thread. Each call must fetch work from a shared source until all the work is done.
+    /// </summary>
+    class Job
+    {
+    public:
+      virtual ~Job() {}
+
+      /// <summary>
+      /// Fetches and executes work until all the work is done. Must be thread safe.
+      /// </summary>
+      virtual void Execute() = 0;
+    };
+
+    /// <summary>
+    /// Executes the given job from the calling thread and from up to iNumThreads-1 worker threads of the pool.
+    /// Returns once all the threads are done with the job. The calling thread does all the work if no worker thread is available.
+    /// If Execute() throws, the first exception is thrown again by Run() after all the threads are done with the job.
+    /// Run() may be called from a worker thread.
+    /// </summary>
+    /// <param name="job">The job to execute.</param>
+    /// <param name="iNumThreads">The maximum number of threads executing the job, including the calling thread.</param>
+    void Run(Job & job, size_t iNumThreads);
+
+    /// <summary>
+    /// Returns the number of worker threads of the pool.
+    /// </summary>
+    size_t GetNumThreads();
+
+  private:
+    /// <summary>
+    /// A job waiting for worker threads.
+    /// </summary>
+    struct POST
+    {
+      Job * job;
+      size_t wanted;              // number of worker threads still wanted
+      size_t running;             // number of worker threads executing the job
+      std::exception_ptr error;   // first exception thrown by a worker thread
+    };
+    typedef std::list<POST*> PostList;
+
+    class PostGuard;
+
+    bool AddThread();
+    void WorkerMain();
+
+    std::mutex mMutex;
+    std::condition_variable mPosted;    // signaled when a job is posted
+    std::condition_variable mDone;      // signaled when a worker thread is done with a job
+    PostList mPosts;
+    size_t mNumThreads;
+    size_t mNumIdle;
+  };
+
+} //namespace shellanything
+
+#endif //SA_WORKERPOOL_H
@@ -249,9 +249,8 @@ public:
 void CContextMenu::BuildMenuTree(HMENU hMenu, shellanything::Menu * menu, UINT & insert_pos)
 {
   //Expanded the menu's strings
-  shellanything::PropertyManager & pmgr = shellanything::PropertyManager::GetInstance();
-  std::string title       = pmgr.Expand(menu->GetName());
-  std::string description = pmgr.Expand(menu->GetDescription());
+  std::string title       = menu->GetNameTemplate().Expand();
+  std::string description = menu->GetDescriptionTemplate().Expand();
 
   //Get visible/enable properties based on current context.
   bool menu_visible   = menu->IsVisible();
@@ -297,9 +296,8 @@ void CContextMenu::BuildMenuTree(HMENU hMenu, shellanything::Menu * menu, UINT &
   const shellanything::Icon & icon = menu->GetIcon();
   if (!menu_separator && icon.IsValid())
   {
-    shellanything::PropertyManager & pmgr = shellanything::PropertyManager::GetInstance();
-    std::string file_extension  = pmgr.Expand(icon.GetFileExtension());
-    std::string icon_filename   = pmgr.Expand(icon.GetPath());
+    std::string file_extension  = icon.GetFileExtensionTemplate().Expand();
+    std::string icon_filename   = icon.GetPathTemplate().Expand();
     int icon_index              = icon.GetIndex();
 
     //if the icon is pointing to a file extension
@@ -381,11 +379,11 @@ void CContextMenu::BuildMenuTree(HMENU hMenu, shellanything::Menu * menu, UINT &
     menuinfo.fMask |= MIIM_SUBMENU;
     HMENU hSubMenu = CreatePopupMenu();
 
-    shellanything::Menu::MenuPtrList subs = menu->GetSubMenus();
+    shellanything::Menu::MenuRange subs = menu->GetSubMenuRange();
     UINT sub_insert_pos = 0;
-    for(size_t i=0; i<subs.size(); i++)
+    for(shellanything::Menu::MenuRange::iterator subIt = subs.begin(); subIt != subs.end(); ++subIt)
     {
-      shellanything::Menu * submenu = subs[i];
+      shellanything::Menu * submenu = (*subIt);
       BuildMenuTree(hSubMenu, submenu, sub_insert_pos);
     }
 
@@ -429,18 +427,18 @@ void CContextMenu::BuildMenuTree(HMENU hMenu)
 
   //for each configuration
   shellanything::ConfigManager & cmgr = shellanything::ConfigManager::GetInstance();
-  shellanything::Configuration::ConfigurationPtrList configs = cmgr.GetConfigurations();
+  shellanything::Configuration::ConfigurationRange configs = cmgr.GetConfigurationRange();
   UINT insert_pos = 0;
-  for(size_t i=0; i<configs.size(); i++)
+  for(shellanything::Configuration::ConfigurationRange::iterator configIt = configs.begin(); configIt != configs.end(); ++configIt)
   {
-    shellanything::Configuration * config = configs[i];
+    shellanything::Configuration * config = (*configIt);
     if (config)
     {
       //for each menu child
-      shellanything::Menu::MenuPtrList menus = config->GetMenus();
-      for(size_t j=0; j<menus.size(); j++)
+      shellanything::Menu::MenuRange menus = config->GetMenuRange();
+      for(shellanything::Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
       {
-        shellanything::Menu * menu = menus[j];
+        shellanything::Menu * menu = (*menuIt);
 
         //Add this menu to the tree
         BuildMenuTree(hMenu, menu, insert_pos);
@@ -541,6 +539,9 @@ HRESULT STDMETHODCALLTYPE CContextMenu::QueryContextMenu(HMENU hMenu, UINT index
   //From this point, it is safe to use class members without other threads interference
   CCriticalSectionGuard cs_guard(&m_CS);
 
+  //Resolve the selection properties through the context's scope
+  shellanything::PropertyManager::ActiveScope active_scope(m_Context.GetProperties());
+
   //Note on uFlags...
   //Right-click on a file or directory with Windows Explorer on the right area:  uFlags=0x00020494=132244(dec)=(CMF_NORMAL|CMF_EXPLORE|CMF_CANRENAME|CMF_ITEMMENU|CMF_ASYNCVERBSTATE)
   //Right-click on the empty area      with Windows Explorer on the right area:  uFlags=0x00020424=132132(dec)=(CMF_NORMAL|CMF_EXPLORE|CMF_NODEFAULT|CMF_ASYNCVERBSTATE)
@@ -641,6 +642,9 @@ HRESULT STDMETHODCALLTYPE CContextMenu::InvokeCommand(LPCMINVOKECOMMANDINFO lpcm
   //From this point, it is safe to use class members without other threads interference
   CCriticalSectionGuard cs_guard(&m_CS);
 
+  //Resolve the selection properties through the context's scope
+  shellanything::PropertyManager::ActiveScope active_scope(m_Context.GetProperties());
+
   //find the menu that is requested
   shellanything::ConfigManager & cmgr = shellanything::ConfigManager::GetInstance();
   shellanything::Menu * menu = cmgr.FindMenuByCommandId(target_command_id);
@@ -651,8 +655,7 @@ HRESULT STDMETHODCALLTYPE CContextMenu::InvokeCommand(LPCMINVOKECOMMANDINFO lpcm
   }
 
   //compute the visual menu title
-  shellanything::PropertyManager & pmgr = shellanything::PropertyManager::GetInstance();
-  std::string title = pmgr.Expand(menu->GetName());
+  std::string title = menu->GetNameTemplate().Expand();
 
   //found a menu match, execute menu action
   LOG(INFO) << __FUNCTION__ << "(), executing action(s) for menu '" << title.c_str() << "'...";
@@ -720,6 +723,9 @@ HRESULT STDMETHODCALLTYPE CContextMenu::GetCommandString(UINT_PTR idCmd, UINT uF
   //From this point, it is safe to use class members without other threads interference
   CCriticalSectionGuard cs_guard(&m_CS);
 
+  //Resolve the selection properties through the context's scope
+  shellanything::PropertyManager::ActiveScope active_scope(m_Context.GetProperties());
+
   //find the menu that is requested
   shellanything::ConfigManager & cmgr = shellanything::ConfigManager::GetInstance();
   shellanything::Menu * menu = cmgr.FindMenuByCommandId(target_command_id);
@@ -730,8 +736,7 @@ HRESULT STDMETHODCALLTYPE CContextMenu::GetCommandString(UINT_PTR idCmd, UINT uF
   }
 
   //compute the visual menu description
-  shellanything::PropertyManager & pmgr = shellanything::PropertyManager::GetInstance();
-  std::string description = pmgr.Expand(menu->GetDescription());
+  std::string description = menu->GetDescriptionTemplate().Expand();
 
   //convert to windows unicode...
   std::wstring desc_utf16 = ra::unicode::Utf8ToUnicode(description);
@@ -791,7 +796,6 @@ HRESULT STDMETHODCALLTYPE CContextMenu::Initialize(LPCITEMIDLIST pIDFolder, LPDA
   shellanything::Context::ElementList files;
 
   // Cleanup
-  m_Context.UnregisterProperties(); //Unregister the previous context properties
   m_Context.SetElements(files);
   m_IsBackGround = false;
 
@@ -868,11 +872,9 @@ HRESULT STDMETHODCALLTYPE CContextMenu::Initialize(LPCITEMIDLIST pIDFolder, LPDA
   }
 
   //update the selection context
+  //The selection properties are defined in the context's scope so that menus can display the right caption
   m_Context.SetElements(files);
 
-  //Register the current context properties so that menus can display the right caption
-  m_Context.RegisterProperties();
-
   return S_OK;
 }
 
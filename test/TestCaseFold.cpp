@@ -0,0 +1,99 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestCaseFold.h"
+#include "CaseFold.h"
+
+namespace shellanything { namespace test
+{
+  //--------------------------------------------------------------------------------------------------
+  void TestCaseFold::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestCaseFold::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestCaseFold, testUppercaseAscii)
+  {
+    ASSERT_EQ( std::string("C:\\TEMP\\FILE.TXT"), UppercaseAscii("c:\\Temp\\file.txt") );
+    ASSERT_EQ( std::string("@[`{"), UppercaseAscii("@[`{") ); // characters around the letters
+
+    // The utf-8 characters are unchanged
+    ASSERT_EQ( std::string("CAF\xC3\xA9"), UppercaseAscii("caf\xC3\xA9") );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestCaseFold, testEqualsNoCase)
+  {
+    // Test all lengths around the size of the vectorized comparison
+    for(size_t length=0; length<=40; length++)
+    {
+      std::string lowercase;
+      std::string uppercase;
+      for(size_t i=0; i<length; i++)
+      {
+        lowercase.append(1, (char)('a' + i % 26));
+        uppercase.append(1, (char)('A' + i % 26));
+      }
+      ASSERT_TRUE( EqualsNoCase(lowercase.c_str(), uppercase.c_str(), length) ) << "length=" << length;
+
+      // A single difference at any position
+      for(size_t i=0; i<length; i++)
+      {
+        std::string other = uppercase;
+        other[i] = '.';
+        ASSERT_FALSE( EqualsNoCase(lowercase.c_str(), other.c_str(), length) ) << "length=" << length << " i=" << i;
+      }
+    }
+
+    // Only letters are folded. '@' and '`' differ from 'A' and 'a' by 0x20 as well.
+    ASSERT_FALSE( EqualsNoCase("@@@@@@@@@@@@@@@@@", "`````````````````", 17) );
+    ASSERT_FALSE( EqualsNoCase("[[[[[[[[[[[[[[[[[", "{{{{{{{{{{{{{{{{{", 17) );
+    ASSERT_FALSE( EqualsNoCase("\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9", "\xC3\x89\xC3\x89\xC3\x89\xC3\x89\xC3\x89\xC3\x89\xC3\x89\xC3\x89", 16) );
+    ASSERT_TRUE ( EqualsNoCase("\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9", "\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9", 16) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestCaseFold, testCompareNoCase)
+  {
+    ASSERT_EQ( 0, CompareNoCase("txt", 3, "TXT", 3) );
+    ASSERT_GT( 0, CompareNoCase("dat", 3, "TXT", 3) );
+    ASSERT_LT( 0, CompareNoCase("TXT", 3, "dat", 3) );
+    ASSERT_GT( 0, CompareNoCase("tx", 2, "TXT", 3) );
+    ASSERT_LT( 0, CompareNoCase("TX\xC3\xA9", 4, "txt", 3) ); // utf-8 bytes are greater than ASCII characters
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestCaseFold, testHasLiteralNoCase)
+  {
+    const std::string value = "C:\\Program Files\\ShellAnything\\bin\\shellext.dll";
+    ASSERT_TRUE ( HasLiteralNoCase(value.c_str(), value.size(), "SHELLANYTHING", 13) );
+    ASSERT_TRUE ( HasLiteralNoCase(value.c_str(), value.size(), "shellext.DLL", 12) );
+    ASSERT_TRUE ( HasLiteralNoCase(value.c_str(), value.size(), "", 0) );
+    ASSERT_FALSE( HasLiteralNoCase(value.c_str(), value.size(), "SHELLEXT.EXE", 12) );
+    ASSERT_FALSE( HasLiteralNoCase("abc", 3, "abcd", 4) );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
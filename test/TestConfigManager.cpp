@@ -557,6 +557,41 @@ namespace shellanything { namespace test
     ASSERT_EQ( Menu::INVALID_COMMAND_ID, option1_2_1  ->GetCommandId() );
     ASSERT_EQ( Menu::INVALID_COMMAND_ID, option1_2_1_1->GetCommandId() );
 
+    //assert lookups by command id only return visible menus
+    ASSERT_EQ( option1,     cmgr.FindMenuByCommandId(101) );
+    ASSERT_EQ( option1_1,   cmgr.FindMenuByCommandId(102) );
+    ASSERT_EQ( (Menu*)NULL, cmgr.FindMenuByCommandId(100) );
+    ASSERT_EQ( (Menu*)NULL, cmgr.FindMenuByCommandId(103) );
+    ASSERT_EQ( (Menu*)NULL, cmgr.FindMenuByCommandId(Menu::INVALID_COMMAND_ID) );
+
+    //assert lookups are forgotten once configurations are reloaded
+    cmgr.Refresh();
+    ASSERT_EQ( (Menu*)NULL, cmgr.FindMenuByCommandId(101) );
+    ASSERT_EQ( 103, cmgr.AssignCommandIds(101) );
+    ASSERT_TRUE( cmgr.FindMenuByCommandId(101) != NULL );
+
+    //assert menus validated by multiple threads produce the same result
+    ASSERT_EQ( 1, cmgr.GetMaxUpdateThreads() );
+    cmgr.SetMaxUpdateThreads(4);
+    for(size_t i=0; i<menus.size(); i++)
+    {
+      menus[i]->SetVisible(false);
+    }
+    Context other_context = GetContextSingleFile();
+    cmgr.Update(other_context);
+    cmgr.SetMaxUpdateThreads(1);
+    ASSERT_EQ( 103, cmgr.AssignCommandIds(101) );
+    ASSERT_EQ( option1,   cmgr.FindMenuByCommandId(101) );
+    ASSERT_EQ( option1_1, cmgr.FindMenuByCommandId(102) );
+    ASSERT_FALSE( option1_2->IsVisible() );
+
+    //assert lookups are forgotten once a menu is removed
+    ASSERT_TRUE( option1->RemoveChild(option1_1) );
+    ASSERT_EQ( (Menu*)NULL, cmgr.FindMenuByCommandId(101) );
+    ASSERT_EQ( (Menu*)NULL, cmgr.FindMenuByCommandId(102) );
+    ASSERT_EQ( 102, cmgr.AssignCommandIds(101) );
+    ASSERT_EQ( option1, cmgr.FindMenuByCommandId(101) );
+
     //cleanup
     ASSERT_TRUE( ra::filesystem::DeleteFile(template_target_path.c_str()) ) << "Failed deleting file '" << template_target_path << "'.";
   }
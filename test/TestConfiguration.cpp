@@ -304,6 +304,34 @@ namespace shellanything { namespace test
     ASSERT_TRUE( ra::filesystem::DeleteFile(template_target_path.c_str()) ) << "Failed deleting file '" << template_target_path << "'.";
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestConfiguration, testMenuIndexInvalidation)
+  {
+    Configuration config;
+    Menu * menu1 = new Menu();
+    config.AddChild(menu1);
+
+    Context empty_context;
+    config.Update(empty_context);
+    ASSERT_EQ( 102, config.AssignCommandIds(101) );
+    ASSERT_EQ( menu1, config.FindMenuByCommandId(101) );
+
+    //assert menus added after an update are found
+    Menu * menu1_1 = new Menu();
+    Menu * menu1_2 = new Menu();
+    menu1->AddChild(menu1_1);
+    menu1->AddChild(menu1_2);
+    config.Update(empty_context);
+    ASSERT_EQ( 104, config.AssignCommandIds(101) );
+    ASSERT_EQ( menu1_2, config.FindMenuByCommandId(103) );
+
+    //assert removed menus are forgotten
+    ASSERT_TRUE( menu1->RemoveChild(menu1_1) );
+    config.Update(empty_context);
+    ASSERT_EQ( 103, config.AssignCommandIds(101) );
+    ASSERT_EQ( menu1_2, config.FindMenuByCommandId(102) );
+    ASSERT_EQ( (Menu*)NULL, config.FindMenuByCommandId(103) );
+  }
+  //--------------------------------------------------------------------------------------------------
 
 } //namespace test
 } //namespace shellanything
@@ -25,6 +25,7 @@
 #include "TestContext.h"
 #include "shellanything/Context.h"
 #include "PropertyManager.h"
+#include "rapidassist/filesystem.h"
 
 namespace shellanything { namespace test
 {
@@ -393,6 +394,76 @@ namespace shellanything { namespace test
     ASSERT_EQ( "", pmgr.GetProperty("selection.drive.letter") );
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestContext, testScopedProperties)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME, ",");
+
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + ra::filesystem::GetPathSeparatorStr();
+    Context::ElementList elements;
+    elements.push_back(directory + "foo.txt");
+    elements.push_back(directory + "bar.dat");
+
+    Context context;
+    context.SetElements(elements);
+
+    // The properties are defined in the scope of the context and not globally
+    ASSERT_FALSE( pmgr.HasProperty("selection.filename") );
+    ASSERT_EQ( "foo.txt,bar.dat", context.GetProperties().GetProperty("selection.filename") );
+
+    {
+      PropertyManager::ActiveScope active_scope(context.GetProperties());
+      ASSERT_EQ( "foo.txt,bar.dat", pmgr.Expand("${selection.filename}") );
+      ASSERT_EQ( "txt,dat", pmgr.GetProperty("selection.filename.extension") );
+    }
+    ASSERT_FALSE( pmgr.HasProperty("selection.filename") );
+
+    // The properties must be rebuilt when the separator changes
+    pmgr.SetProperty(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME, ";");
+    ASSERT_EQ( "foo.txt,bar.dat", context.GetProperties().GetProperty("selection.filename") );
+    context.RefreshProperties();
+    ASSERT_EQ( "foo.txt;bar.dat", context.GetProperties().GetProperty("selection.filename") );
+
+    // A copy of the context have its own scope
+    Context copy = context;
+    context.SetElements(Context::ElementList());
+    ASSERT_FALSE( context.GetProperties().HasProperty("selection.filename") );
+    ASSERT_EQ( "foo.txt;bar.dat", copy.GetProperties().GetProperty("selection.filename") );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestContext, testLazyProperties)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME, ",");
+
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + ra::filesystem::GetPathSeparatorStr();
+    Context::ElementList elements;
+    elements.push_back(directory + "foo.txt");
+    elements.push_back(directory + "bar");
+    elements.push_back(directory + "baz.dat");
+
+    Context context;
+    context.SetElements(elements);
+
+    // The values are computed on the first reference, with the separator defined when the properties were refreshed
+    pmgr.SetProperty(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME, ";");
+    ASSERT_EQ( "foo,bar,baz", context.GetProperties().GetProperty("selection.filename.noext") );
+    context.RefreshProperties();
+    ASSERT_EQ( "foo;bar;baz", context.GetProperties().GetProperty("selection.filename.noext") );
+    ASSERT_EQ( "txt;;dat", context.GetProperties().GetProperty("selection.filename.extension") );
+
+    // The values are cached until the properties are refreshed
+    pmgr.SetProperty(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME, "|");
+    ASSERT_EQ( "foo;bar;baz", context.GetProperties().GetProperty("selection.filename.noext") );
+    ASSERT_EQ( "foo.txt;bar;baz.dat", context.GetProperties().GetProperty("selection.filename") );
+    context.RefreshProperties();
+    ASSERT_EQ( "foo|bar|baz", context.GetProperties().GetProperty("selection.filename.noext") );
+
+    // Unknown properties are not defined by the context
+    ASSERT_FALSE( context.GetProperties().HasProperty("selection") );
+    ASSERT_FALSE( context.GetProperties().HasProperty("selection.filename.extensions") );
+  }
+  //--------------------------------------------------------------------------------------------------
 
 } //namespace test
 } //namespace shellanything
@@ -0,0 +1,128 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestDriveClass.h"
+#include "DriveClass.h"
+#include "rapidassist/strings.h"
+
+#include <thread>
+#include <chrono>
+
+namespace shellanything { namespace test
+{
+  /// <summary>
+  /// A DriveClassProvider which does not query the operating system.
+  /// </summary>
+  class FakeDriveClassProvider : public DriveClassProvider
+  {
+  public:
+    FakeDriveClassProvider() : num_queries(0) {}
+    virtual DRIVE_CLASS GetDriveClass(const std::string & path)
+    {
+      num_queries++;
+      if (path == "C:\\")
+        return DRIVE_CLASS_FIXED;
+      if (path == "D:\\")
+        return DRIVE_CLASS_OPTICAL;
+      if (path == "E:\\")
+        return DRIVE_CLASS_REMOVABLE;
+      return DRIVE_CLASS_UNKNOWN;
+    }
+
+    size_t num_queries;
+  };
+
+  //--------------------------------------------------------------------------------------------------
+  void TestDriveClass::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestDriveClass::TearDown()
+  {
+    SetDriveClassProvider(NULL);
+    SetDriveClassTimeToLive(DRIVE_CLASS_DEFAULT_TIME_TO_LIVE);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestDriveClass, testGetDriveClassFromPath)
+  {
+    FakeDriveClassProvider provider;
+    SetDriveClassProvider(&provider);
+
+    ASSERT_EQ( DRIVE_CLASS_FIXED,     GetDriveClassFromPath("C:\\") );
+    ASSERT_EQ( DRIVE_CLASS_FIXED,     GetDriveClassFromPath("C:\\Windows\\System32\\cmd.exe") );
+    ASSERT_EQ( DRIVE_CLASS_FIXED,     GetDriveClassFromPath("c:\\windows") );
+    ASSERT_EQ( DRIVE_CLASS_OPTICAL,   GetDriveClassFromPath("D:\\setup.exe") );
+    ASSERT_EQ( DRIVE_CLASS_REMOVABLE, GetDriveClassFromPath("E:\\photos\\image.jpg") );
+    ASSERT_EQ( DRIVE_CLASS_UNKNOWN,   GetDriveClassFromPath("Z:\\file.txt") );
+    ASSERT_EQ( DRIVE_CLASS_NETWORK,   GetDriveClassFromPath("\\\\localhost\\shared\\file.txt") );
+
+    //assert each drive is queried once and network paths are not queried
+    ASSERT_EQ( 4, provider.num_queries );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestDriveClass, testOneQueryPerDrive)
+  {
+    FakeDriveClassProvider provider;
+    SetDriveClassProvider(&provider);
+
+    static const size_t NUM_ELEMENTS = 50000;
+    for(size_t i=0; i<NUM_ELEMENTS; i++)
+    {
+      const std::string filename = ra::strings::ToString(i) + ".txt";
+      ASSERT_EQ( DRIVE_CLASS_FIXED,   GetDriveClassFromPath("C:\\temp\\" + filename) );
+      ASSERT_EQ( DRIVE_CLASS_OPTICAL, GetDriveClassFromPath("D:\\" + filename) );
+    }
+    ASSERT_EQ( 2, provider.num_queries );
+
+    //assert drives are queried again when the cache is cleared
+    ClearDriveClassCache();
+    ASSERT_EQ( DRIVE_CLASS_FIXED, GetDriveClassFromPath("C:\\temp\\file.txt") );
+    ASSERT_EQ( 3, provider.num_queries );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestDriveClass, testTimeToLive)
+  {
+    FakeDriveClassProvider provider;
+    SetDriveClassProvider(&provider);
+
+    //assert a drive is queried again once its class is expired
+    SetDriveClassTimeToLive(50);
+    ASSERT_EQ( DRIVE_CLASS_FIXED, GetDriveClassFromPath("C:\\temp\\file.txt") );
+    ASSERT_EQ( DRIVE_CLASS_FIXED, GetDriveClassFromPath("C:\\temp\\file.txt") );
+    ASSERT_EQ( 1, provider.num_queries );
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ( DRIVE_CLASS_FIXED, GetDriveClassFromPath("C:\\temp\\file.txt") );
+    ASSERT_EQ( 2, provider.num_queries );
+
+    //assert the drives are queried each time when the cache is disabled
+    SetDriveClassTimeToLive(0);
+    ASSERT_EQ( 0, GetDriveClassTimeToLive() );
+    ASSERT_EQ( DRIVE_CLASS_FIXED, GetDriveClassFromPath("C:\\temp\\file.txt") );
+    ASSERT_EQ( DRIVE_CLASS_FIXED, GetDriveClassFromPath("C:\\temp\\file.txt") );
+    ASSERT_EQ( 4, provider.num_queries );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
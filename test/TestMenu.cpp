@@ -182,6 +182,19 @@ namespace shellanything { namespace test
     ASSERT_EQ( child2, subs[1] );
     ASSERT_EQ( child3, subs[2] );
 
+    //assert the range matches the list
+    Menu::MenuRange range = body->GetSubMenuRange();
+    Menu::MenuRange::iterator subIt = range.begin();
+    for(size_t i=0; i<subs.size(); i++, ++subIt)
+    {
+      ASSERT_TRUE( subIt != range.end() );
+      ASSERT_EQ( subs[i], *subIt );
+    }
+    ASSERT_TRUE( subIt == range.end() );
+    ASSERT_TRUE( root->IsParentMenu() );
+    ASSERT_FALSE( child1->IsParentMenu() );
+    ASSERT_TRUE( child1->GetSubMenuRange().empty() );
+
     //destroy the tree
     delete root;
     root = NULL;
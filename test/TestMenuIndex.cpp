@@ -0,0 +1,612 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestMenuIndex.h"
+#include "MenuIndex.h"
+#include "shellanything/Context.h"
+#include "shellanything/Validator.h"
+#include "PropertyManager.h"
+#include "PathTypeCache.h"
+#include "WorkerPool.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/strings.h"
+#include <stdlib.h>
+#include <atomic>
+#include <stdexcept>
+
+namespace shellanything { namespace test
+{
+  Menu * NewIndexedMenu(Node & parent, const char * file_extensions)
+  {
+    Menu * menu = new Menu();
+    if (file_extensions)
+    {
+      Validator visibility;
+      visibility.SetFileExtensions(file_extensions);
+      menu->SetVisibility(visibility);
+    }
+    parent.AddChild(menu);
+    return menu;
+  }
+
+  // Builds a random tree of menus. About half of the leaf menus are only visible with *.txt files.
+  void BuildRandomMenus(Node & parent, size_t depth)
+  {
+    static const char * extensions[] = { NULL, "txt", "zip", "zip" };
+    size_t count = (size_t)(rand() % 4);
+    for(size_t i=0; i<count; i++)
+    {
+      Menu * menu = NewIndexedMenu(parent, extensions[rand() % 4]);
+      if (depth > 0)
+        BuildRandomMenus(*menu, depth - 1);
+    }
+  }
+
+  // Returns the visible, enabled and command id states of the given menus and their submenus, in pre-order.
+  void GetMenuStates(const Node & parent, std::vector<uint32_t> & states)
+  {
+    Menu::MenuRange menus = parent.GetChildren<Menu*>(Node::NODE_KIND_MENU);
+    for(Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
+    {
+      Menu * menu = (*menuIt);
+      states.push_back((menu->IsVisible() ? 1 : 0) + (menu->IsEnabled() ? 2 : 0));
+      states.push_back(menu->GetCommandId());
+      GetMenuStates(*menu, states);
+    }
+  }
+
+  Context GetIndexContext(const char * element1, const char * element2)
+  {
+    Context context;
+    Context::ElementList elements;
+    if (element1)
+      elements.push_back(element1);
+    if (element2)
+      elements.push_back(element2);
+    context.SetElements(elements);
+    return context;
+  }
+
+  // Builds a random tree of menus with various validators.
+  void BuildRandomValidatorMenus(Node & parent, size_t depth)
+  {
+    size_t count = (size_t)(rand() % 4);
+    for(size_t i=0; i<count; i++)
+    {
+      Validator visibility;
+      switch(rand() % 7)
+      {
+      case 0: break; // always visible
+      case 1: visibility.SetFileExtensions("txt"); break;
+      case 2: visibility.SetPattern("*\\a.*"); break;
+      case 3: visibility.SetProperties("test.menuindex.flag"); break;
+      case 4: visibility.SetPattern("${test.menuindex.pattern}"); break;
+      case 5: visibility.SetMaxFiles(1); visibility.SetMaxDirectories(0); break;
+      case 6: visibility.SetClass("drive:fixed"); break;
+      };
+      Validator validity;
+      if (rand() % 2)
+        validity.SetFileExtensions("zip");
+
+      Menu * menu = new Menu();
+      menu->SetVisibility(visibility);
+      menu->SetValidity(validity);
+      parent.AddChild(menu);
+      if (depth > 0)
+        BuildRandomValidatorMenus(*menu, depth - 1);
+    }
+  }
+
+  // Resets the states of the given menus and their submenus.
+  void ResetMenuStates(const Node & parent)
+  {
+    Menu::MenuRange menus = parent.GetChildren<Menu*>(Node::NODE_KIND_MENU);
+    for(Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
+    {
+      Menu * menu = (*menuIt);
+      menu->SetVisible(false);
+      menu->SetEnabled(false);
+      menu->SetCommandId(Menu::INVALID_COMMAND_ID);
+      ResetMenuStates(*menu);
+    }
+  }
+
+  // Validates the outdated menus of an index from the threads of the WorkerPool, like ConfigManager::Update().
+  class ValidateIndexedMenusJob : public WorkerPool::Job
+  {
+  public:
+    ValidateIndexedMenusJob(MenuIndex & index, size_t count, const Context & context) :
+      mIndex(index),
+      mCount(count),
+      mContext(context),
+      mNext(0)
+    {
+    }
+
+    virtual void Execute()
+    {
+      for(size_t i = mNext.fetch_add(1); i < mCount; i = mNext.fetch_add(1))
+      {
+        mIndex.ValidateMenu(i, mContext);
+      }
+    }
+
+  private:
+    MenuIndex & mIndex;
+    size_t mCount;
+    const Context & mContext;
+    std::atomic<size_t> mNext;
+  };
+
+  // Updates the given index with the given number of threads.
+  void UpdateConcurrently(MenuIndex & index, const Context & context, size_t num_threads)
+  {
+    const size_t count = index.BeginUpdate(context);
+    ValidateIndexedMenusJob job(index, count, context);
+    WorkerPool::GetInstance().Run(job, num_threads);
+    index.EndUpdate();
+  }
+
+  // A file system which fails on the given path.
+  class FailingPathTypeProvider : public PathTypeProvider
+  {
+  public:
+    virtual PATH_TYPE GetPathType(const std::string & path)
+    {
+      if (path == "failing.exe")
+        throw std::runtime_error("failing file system");
+      return PATH_TYPE_FILE;
+    }
+  };
+
+  //--------------------------------------------------------------------------------------------------
+  void TestMenuIndex::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestMenuIndex::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testBuild)
+  {
+    Node root("root");
+    Menu * menu1   = NewIndexedMenu(root,   NULL);
+    Menu * menu1_1 = NewIndexedMenu(*menu1, NULL);
+    Menu * menu1_2 = NewIndexedMenu(*menu1, NULL);
+    Menu * menu1_2_1 = NewIndexedMenu(*menu1_2, NULL);
+    root.AddChild(new Node("generic"));
+    Menu * menu2   = NewIndexedMenu(root,   NULL);
+
+    MenuIndex index;
+    ASSERT_FALSE( index.IsValid() );
+
+    index.Build(root);
+    ASSERT_TRUE( index.IsValid() );
+
+    //assert menus are in pre-order with their subtree size
+    const MenuIndex::EntryList & entries = index.GetEntries();
+    ASSERT_EQ( 5, entries.size() );
+    ASSERT_EQ( menu1,     entries[0].menu ); ASSERT_EQ( 4, entries[0].size );
+    ASSERT_EQ( menu1_1,   entries[1].menu ); ASSERT_EQ( 1, entries[1].size );
+    ASSERT_EQ( menu1_2,   entries[2].menu ); ASSERT_EQ( 2, entries[2].size );
+    ASSERT_EQ( menu1_2_1, entries[3].menu ); ASSERT_EQ( 1, entries[3].size );
+    ASSERT_EQ( menu2,     entries[4].menu ); ASSERT_EQ( 1, entries[4].size );
+
+    index.Invalidate();
+    ASSERT_FALSE( index.IsValid() );
+    ASSERT_TRUE( index.GetEntries().empty() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdate)
+  {
+    Node root("root");
+    Menu * option1     = NewIndexedMenu(root,     NULL);
+    Menu * option1_1   = NewIndexedMenu(*option1, NULL);
+    Menu * option1_2   = NewIndexedMenu(*option1, NULL);
+    Menu * option1_2_1 = NewIndexedMenu(*option1_2, "zip");
+    Menu * option1_3   = NewIndexedMenu(*option1, "zip");
+    Menu * option2     = NewIndexedMenu(root,     NULL);
+    Menu * option2_1   = NewIndexedMenu(*option2, "zip");
+
+    Context context;
+    Context::ElementList elements;
+    elements.push_back("C:\\Windows\\System32\\notepad.txt");
+    context.SetElements(elements);
+
+    MenuIndex index;
+    index.Build(root);
+    index.Update(context);
+
+    //Issue #4 - parent menus whose children are all invisible are also invisible
+    ASSERT_TRUE (     option1->IsVisible() );
+    ASSERT_TRUE (   option1_1->IsVisible() );
+    ASSERT_FALSE(   option1_2->IsVisible() );
+    ASSERT_FALSE( option1_2_1->IsVisible() );
+    ASSERT_FALSE(   option1_3->IsVisible() );
+    ASSERT_FALSE(     option2->IsVisible() );
+    ASSERT_FALSE(   option2_1->IsVisible() );
+
+    //Issue #5 - invisible menus are not assigned a command id
+    ASSERT_EQ( 103, index.AssignCommandIds(101) );
+    ASSERT_EQ( 101, option1->GetCommandId() );
+    ASSERT_EQ( 102, option1_1->GetCommandId() );
+    ASSERT_EQ( Menu::INVALID_COMMAND_ID, option1_2->GetCommandId() );
+    ASSERT_EQ( Menu::INVALID_COMMAND_ID, option1_2_1->GetCommandId() );
+    ASSERT_EQ( Menu::INVALID_COMMAND_ID, option2_1->GetCommandId() );
+
+    ASSERT_EQ( option1_1,   index.FindMenuByCommandId(102) );
+    ASSERT_EQ( (Menu*)NULL, index.FindMenuByCommandId(103) );
+
+    //assert an invalid first command id invalidates all menus
+    ASSERT_EQ( Menu::INVALID_COMMAND_ID, index.AssignCommandIds(Menu::INVALID_COMMAND_ID) );
+    ASSERT_EQ( Menu::INVALID_COMMAND_ID, option1->GetCommandId() );
+    ASSERT_EQ( Menu::INVALID_COMMAND_ID, option1_1->GetCommandId() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdateDifferential)
+  {
+    Context context;
+    Context::ElementList elements;
+    elements.push_back("C:\\Windows\\System32\\notepad.txt");
+    context.SetElements(elements);
+
+    srand(0);
+    for(size_t i=0; i<200; i++)
+    {
+      Node root("root");
+      BuildRandomMenus(root, 4);
+
+      //update with recursive calls
+      uint32_t expected_next_id = 101;
+      Menu::MenuRange menus = root.GetChildren<Menu*>(Node::NODE_KIND_MENU);
+      for(Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
+      {
+        (*menuIt)->Update(context);
+        expected_next_id = (*menuIt)->AssignCommandIds(expected_next_id);
+      }
+      std::vector<uint32_t> expected;
+      GetMenuStates(root, expected);
+
+      ResetMenuStates(root);
+
+      //update with the index
+      MenuIndex index;
+      index.Build(root);
+      index.Update(context);
+      uint32_t actual_next_id = index.AssignCommandIds(101);
+      std::vector<uint32_t> actual;
+      GetMenuStates(root, actual);
+
+      ASSERT_EQ( expected_next_id, actual_next_id ) << "at tree " << i;
+      ASSERT_EQ( expected, actual ) << "at tree " << i;
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdateIncremental)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.ClearProperty("test.menuindex.flag");
+
+    Node root("root");
+    Menu * always     = NewIndexedMenu(root, NULL);
+    Menu * extensions = NewIndexedMenu(root, "txt");
+    Menu * parent     = NewIndexedMenu(root, NULL);
+    Menu * property   = NewIndexedMenu(*parent, NULL);
+    Validator visibility;
+    visibility.SetProperties("test.menuindex.flag");
+    property->SetVisibility(visibility);
+
+    MenuIndex index;
+    index.Build(root);
+
+    //first update validates all menus
+    index.Update(GetIndexContext("C:\\foo\\a.txt", NULL));
+    ASSERT_EQ( 4, index.GetNumValidated() );
+    ASSERT_TRUE ( always->IsVisible() );
+    ASSERT_TRUE ( extensions->IsVisible() );
+    ASSERT_FALSE( property->IsVisible() );
+    ASSERT_FALSE( parent->IsVisible() ); //issue #4
+
+    //assert nothing is validated with an identical context
+    index.Update(GetIndexContext("C:\\foo\\a.txt", NULL));
+    ASSERT_EQ( 0, index.GetNumValidated() );
+    ASSERT_TRUE ( extensions->IsVisible() );
+    ASSERT_FALSE( parent->IsVisible() );
+
+    //assert the same file extensions do not validate again
+    index.Update(GetIndexContext("C:\\bar\\b.txt", NULL));
+    ASSERT_EQ( 0, index.GetNumValidated() );
+
+    //assert only the menus which depend on file extensions are validated
+    index.Update(GetIndexContext("C:\\foo\\a.zip", NULL));
+    ASSERT_EQ( 1, index.GetNumValidated() );
+    ASSERT_FALSE( extensions->IsVisible() );
+
+    //assert only the menus which depend on the property are validated, and the parent is visible again
+    pmgr.SetProperty("test.menuindex.flag", "on");
+    index.Update(GetIndexContext("C:\\foo\\a.zip", NULL));
+    ASSERT_EQ( 1, index.GetNumValidated() );
+    ASSERT_TRUE( property->IsVisible() );
+    ASSERT_TRUE( parent->IsVisible() );
+
+    //assert a menu modified outside of the index is restored
+    parent->SetVisible(false);
+    always->SetEnabled(false);
+    index.Update(GetIndexContext("C:\\foo\\a.zip", NULL));
+    ASSERT_EQ( 0, index.GetNumValidated() );
+    ASSERT_TRUE( parent->IsVisible() );
+    ASSERT_TRUE( always->IsEnabled() );
+
+    //assert replaced validators are validated
+    visibility.SetProperties("");
+    visibility.SetFileExtensions("txt");
+    property->SetVisibility(visibility);
+    index.Update(GetIndexContext("C:\\foo\\a.zip", NULL));
+    ASSERT_EQ( 1, index.GetNumValidated() );
+    ASSERT_FALSE( property->IsVisible() );
+    ASSERT_FALSE( parent->IsVisible() );
+
+    pmgr.ClearProperty("test.menuindex.flag");
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdateDriveClass)
+  {
+    Node root("root");
+    Menu * drive = NewIndexedMenu(root, NULL);
+    Validator visibility;
+    visibility.SetClass("drive");
+    drive->SetVisibility(visibility);
+
+    MenuIndex index;
+    index.Build(root);
+
+    index.Update(GetIndexContext("C:\\foo\\a.txt", NULL));
+    ASSERT_TRUE( drive->IsVisible() );
+
+    //assert an element which is not mapped to a drive is seen, with the same drive letters and extensions
+    index.Update(GetIndexContext("C:\\foo\\a.txt", "\\\\server\\share"));
+    ASSERT_EQ( 1, index.GetNumValidated() );
+    ASSERT_FALSE( drive->IsVisible() );
+
+    index.Update(GetIndexContext("C:\\foo\\a.txt", NULL));
+    ASSERT_EQ( 1, index.GetNumValidated() );
+    ASSERT_TRUE( drive->IsVisible() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdateReplacedValidators)
+  {
+    Node root("root");
+    Menu * menu = NewIndexedMenu(root, NULL);
+
+    MenuIndex index;
+    index.Build(root);
+
+    //each replaced validator is freed by the menu, its address may be reused by a later one
+    for(int i=0; i<100; i++)
+    {
+      const bool txt = (i % 2 == 0);
+      Validator visibility;
+      visibility.SetMaxDirectories(100 + i);
+      menu->SetVisibility(visibility); //frees the validator of the previous update
+      visibility.SetMaxFiles(100 + i);
+      visibility.SetFileExtensions(txt ? "txt" : "zip");
+      menu->SetVisibility(visibility);
+
+      index.Update(GetIndexContext("C:\\foo\\a.txt", NULL));
+      ASSERT_EQ( 1, index.GetNumValidated() ) << "at update " << i;
+      ASSERT_EQ( txt, menu->IsVisible() ) << "at update " << i;
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdateIncrementalDifferential)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    static const char * elements[] = { "C:\\foo\\a.txt", "C:\\foo\\b.txt", "C:\\foo\\a.zip", "C:\\bar\\c", NULL };
+    static const size_t num_elements = sizeof(elements)/sizeof(elements[0]);
+
+    srand(0);
+    for(size_t i=0; i<50; i++)
+    {
+      Node root("root");
+      BuildRandomValidatorMenus(root, 3);
+
+      MenuIndex index;
+      index.Build(root);
+
+      for(size_t j=0; j<20; j++)
+      {
+        //modify some of the inputs
+        if (rand() % 3 == 0)
+          pmgr.SetProperty("test.menuindex.flag", (rand() % 2 ? "on" : ""));
+        if (rand() % 3 == 0)
+          pmgr.SetProperty("test.menuindex.pattern", (rand() % 2 ? "*.txt" : "*.zip"));
+        Context context = GetIndexContext(elements[rand() % num_elements], elements[rand() % num_elements]);
+
+        //update with recursive calls
+        uint32_t expected_next_id = 101;
+        Menu::MenuRange menus = root.GetChildren<Menu*>(Node::NODE_KIND_MENU);
+        for(Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
+        {
+          (*menuIt)->Update(context);
+          expected_next_id = (*menuIt)->AssignCommandIds(expected_next_id);
+        }
+        std::vector<uint32_t> expected;
+        GetMenuStates(root, expected);
+        ResetMenuStates(root);
+
+        //update with the index
+        index.Update(context);
+        uint32_t actual_next_id = index.AssignCommandIds(101);
+        std::vector<uint32_t> actual;
+        GetMenuStates(root, actual);
+
+        ASSERT_EQ( expected_next_id, actual_next_id ) << "at tree " << i << ", update " << j;
+        ASSERT_EQ( expected, actual ) << "at tree " << i << ", update " << j;
+      }
+    }
+
+    pmgr.ClearProperty("test.menuindex.flag");
+    pmgr.ClearProperty("test.menuindex.pattern");
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdateConcurrently)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    static const char * elements[] = { "C:\\foo\\a.txt", "C:\\foo\\b.txt", "C:\\foo\\a.zip", "C:\\bar\\c", NULL };
+    static const size_t num_elements = sizeof(elements)/sizeof(elements[0]);
+
+    srand(0);
+    for(size_t i=0; i<50; i++)
+    {
+      Node root("root");
+      BuildRandomValidatorMenus(root, 3);
+
+      MenuIndex sequential_index;
+      MenuIndex concurrent_index;
+      sequential_index.Build(root);
+      concurrent_index.Build(root);
+
+      for(size_t j=0; j<10; j++)
+      {
+        //modify some of the inputs
+        if (rand() % 3 == 0)
+          pmgr.SetProperty("test.menuindex.flag", (rand() % 2 ? "on" : ""));
+        Context context = GetIndexContext(elements[rand() % num_elements], elements[rand() % num_elements]);
+
+        //update from the current thread
+        sequential_index.Update(context);
+        uint32_t expected_next_id = sequential_index.AssignCommandIds(101);
+        std::vector<uint32_t> expected;
+        GetMenuStates(root, expected);
+        ResetMenuStates(root);
+
+        //update from multiple threads
+        UpdateConcurrently(concurrent_index, context, 4);
+        uint32_t actual_next_id = concurrent_index.AssignCommandIds(101);
+        std::vector<uint32_t> actual;
+        GetMenuStates(root, actual);
+
+        ASSERT_EQ( sequential_index.GetNumValidated(), concurrent_index.GetNumValidated() ) << "at tree " << i << ", update " << j;
+        ASSERT_EQ( expected_next_id, actual_next_id ) << "at tree " << i << ", update " << j;
+        ASSERT_EQ( expected, actual ) << "at tree " << i << ", update " << j;
+      }
+    }
+
+    pmgr.ClearProperty("test.menuindex.flag");
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdateConcurrentlyWithResolvedProperties)
+  {
+    static const size_t NUM_MENUS = 64;
+    Context::ElementList elements;
+    elements.push_back(ra::filesystem::GetTemporaryDirectory() + ra::filesystem::GetPathSeparatorStr() + "a.txt");
+    Context context;
+    context.SetElements(elements);
+
+    for(size_t i=0; i<20; i++)
+    {
+      // Each validator expands 'selection.*' properties from the scope of the context and resolves a new 'env.*' property,
+      // which publishes a new snapshot of the properties while the other threads are expanding.
+      Node root("root");
+      for(size_t j=0; j<NUM_MENUS; j++)
+      {
+        const std::string env = "${env.SHELLANYTHING_TEST_MENUINDEX_" + ra::strings::ToString(i) + "_" + ra::strings::ToString(j) + "}";
+        Validator visibility;
+        visibility.SetPattern("*${selection.filename}");
+        Validator validity;
+        validity.SetPattern(env + "*${selection.filename}");
+
+        Menu * menu = new Menu();
+        menu->SetVisibility(visibility);
+        menu->SetValidity(validity);
+        root.AddChild(menu);
+      }
+
+      MenuIndex index;
+      index.Build(root);
+      UpdateConcurrently(index, context, 4);
+      ASSERT_EQ( NUM_MENUS, index.GetNumValidated() );
+
+      // The environment variables are not defined
+      Menu::MenuRange menus = root.GetChildren<Menu*>(Node::NODE_KIND_MENU);
+      for(Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
+      {
+        ASSERT_TRUE ( (*menuIt)->IsVisible() ) << "at iteration " << i;
+        ASSERT_FALSE( (*menuIt)->IsEnabled() ) << "at iteration " << i;
+      }
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMenuIndex, testUpdateConcurrentlyWithException)
+  {
+    static const size_t NUM_MENUS = 64;
+    Context context = GetIndexContext("C:\\foo\\a.txt", NULL);
+
+    Node root("root");
+    Menu * failing = NULL;
+    for(size_t i=0; i<NUM_MENUS; i++)
+    {
+      Validator visibility;
+      visibility.SetFileExists(i == NUM_MENUS / 2 ? "failing.exe" : "tool.exe");
+      Menu * menu = new Menu();
+      menu->SetVisibility(visibility);
+      root.AddChild(menu);
+      if (i == NUM_MENUS / 2)
+        failing = menu;
+    }
+
+    MenuIndex index;
+    index.Build(root);
+
+    PathTypeCache & path_cache = PathTypeCache::GetInstance();
+    const uint32_t time_to_live = path_cache.GetTimeToLive();
+    path_cache.SetTimeToLive(0);
+    FailingPathTypeProvider provider;
+    SetPathTypeProvider(&provider);
+
+    //the exception of a validator is thrown again by the calling thread
+    for(size_t i=0; i<20; i++)
+    {
+      ASSERT_THROW(UpdateConcurrently(index, context, 4), std::runtime_error) << "at iteration " << i;
+    }
+
+    //the next update succeeds
+    failing->SetVisibility(Validator());
+    UpdateConcurrently(index, context, 4);
+    ASSERT_EQ( NUM_MENUS, index.GetNumValidated() );
+
+    SetPathTypeProvider(NULL);
+    path_cache.SetTimeToLive(time_to_live);
+
+    Menu::MenuRange menus = root.GetChildren<Menu*>(Node::NODE_KIND_MENU);
+    for(Menu::MenuRange::iterator menuIt = menus.begin(); menuIt != menus.end(); ++menuIt)
+    {
+      ASSERT_TRUE( (*menuIt)->IsVisible() );
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
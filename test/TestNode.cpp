@@ -328,6 +328,53 @@ namespace shellanything { namespace test
     ASSERT_EQ( child1, body->GetChildren()[0] );
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestNode, testGetChildrenKind)
+  {
+    Node root("root");
+    Node * child1 = (new Node("menu", Node::NODE_KIND_MENU));
+    Node * child2 = (new Node("generic"));
+    Node * child3 = (new Node("menu", Node::NODE_KIND_MENU));
+    Node * child4 = (new Node("configuration", Node::NODE_KIND_CONFIGURATION));
+
+    //no children yet
+    ASSERT_TRUE( root.GetChildren<Node*>(Node::NODE_KIND_MENU).empty() );
+    ASSERT_FALSE( root.HasChildren(Node::NODE_KIND_MENU) );
+
+    root.AddChild(child1);
+    root.AddChild(child2);
+    root.AddChild(child3);
+    root.AddChild(child4);
+
+    ASSERT_EQ( Node::NODE_KIND_MENU,    child1->GetNodeKind() );
+    ASSERT_EQ( Node::NODE_KIND_GENERIC, child2->GetNodeKind() );
+    ASSERT_TRUE( root.HasChildren(Node::NODE_KIND_MENU) );
+    ASSERT_TRUE( root.HasChildren(Node::NODE_KIND_CONFIGURATION) );
+    ASSERT_FALSE( child1->HasChildren(Node::NODE_KIND_MENU) );
+
+    //assert only the nodes of the given kind are iterated, in order
+    Node::NodePtrList menus;
+    NodeRange<Node*> range = root.GetChildren<Node*>(Node::NODE_KIND_MENU);
+    for(NodeRange<Node*>::iterator nodeIt = range.begin(); nodeIt != range.end(); ++nodeIt)
+    {
+      menus.push_back(*nodeIt);
+    }
+    ASSERT_EQ( 2, menus.size() );
+    ASSERT_EQ( child1, menus[0] );
+    ASSERT_EQ( child3, menus[1] );
+
+    //assert a range ending with a node of another kind
+    range = root.GetChildren<Node*>(Node::NODE_KIND_CONFIGURATION);
+    ASSERT_FALSE( range.empty() );
+    ASSERT_EQ( child4, *range.begin() );
+    ASSERT_TRUE( ++range.begin() == range.end() );
+
+    //assert a range with no match
+    range = root.GetChildren<Node*>(Node::NODE_KIND_GENERIC);
+    ASSERT_EQ( child2, *range.begin() );
+    range = child1->GetChildren<Node*>(Node::NODE_KIND_MENU);
+    ASSERT_TRUE( range.begin() == range.end() );
+  }
+  //--------------------------------------------------------------------------------------------------
 
 } //namespace test
 } //namespace shellanything
@@ -0,0 +1,135 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestPathType.h"
+#include "PathType.h"
+#include "rapidassist/testing.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/strings.h"
+
+namespace shellanything { namespace test
+{
+  /// <summary>
+  /// A PathTypeProvider which does not query the file system.
+  /// </summary>
+  class FakePathTypeProvider : public PathTypeProvider
+  {
+  public:
+    virtual PATH_TYPE GetPathType(const std::string & path)
+    {
+      if (path == "file.txt")
+        return PATH_TYPE_FILE;
+      if (path == "directory")
+        return PATH_TYPE_DIRECTORY;
+      return PATH_TYPE_MISSING;
+    }
+  };
+
+  //--------------------------------------------------------------------------------------------------
+  void TestPathType::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestPathType::TearDown()
+  {
+    SetPathTypeProvider(NULL);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathType, testGetPathType)
+  {
+    static const std::string path_separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = std::string("test_files") + path_separator + ra::testing::GetTestQualifiedName();
+    const std::string file = directory + path_separator + "file.txt";
+    ASSERT_TRUE( ra::filesystem::CreateDirectory(directory.c_str()) );
+    ASSERT_TRUE( ra::filesystem::WriteFile(file, "foo") );
+
+    ASSERT_EQ( PATH_TYPE_DIRECTORY, GetPathType(directory) );
+    ASSERT_EQ( PATH_TYPE_FILE, GetPathType(file) );
+    ASSERT_EQ( PATH_TYPE_MISSING, GetPathType(directory + path_separator + "missing.txt") );
+    ASSERT_EQ( PATH_TYPE_MISSING, GetPathType("") );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathType, testGetPathTypes)
+  {
+    static const std::string path_separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = std::string("test_files") + path_separator + ra::testing::GetTestQualifiedName();
+    ASSERT_TRUE( ra::filesystem::CreateDirectory(directory.c_str()) );
+
+    // Build a list of files, directories and missing elements large enough to be queried from multiple threads
+    std::vector<std::string> paths;
+    PathTypeList expected;
+    for(size_t i=0; paths.size() < 3*PATH_TYPE_PARALLEL_THRESHOLD; i++)
+    {
+      const std::string prefix = directory + path_separator + ra::strings::ToString(i);
+      ASSERT_TRUE( ra::filesystem::WriteFile(prefix + ".txt", "foo") );
+      ASSERT_TRUE( ra::filesystem::CreateDirectory((prefix + ".dir").c_str()) );
+      paths.push_back(prefix + ".txt");
+      paths.push_back(prefix + ".dir");
+      paths.push_back(prefix + ".missing");
+      expected.push_back(PATH_TYPE_FILE);
+      expected.push_back(PATH_TYPE_DIRECTORY);
+      expected.push_back(PATH_TYPE_MISSING);
+    }
+
+    PathTypeList types;
+    GetPathTypes(paths, types);
+    ASSERT_EQ( expected.size(), types.size() );
+    for(size_t i=0; i<expected.size(); i++)
+    {
+      ASSERT_EQ( expected[i], types[i] ) << "path=" << paths[i];
+    }
+
+    // Small lists are queried by the current thread
+    paths.resize(3);
+    GetPathTypes(paths, types);
+    ASSERT_EQ( 3, types.size() );
+    ASSERT_EQ( PATH_TYPE_FILE, types[0] );
+    ASSERT_EQ( PATH_TYPE_DIRECTORY, types[1] );
+    ASSERT_EQ( PATH_TYPE_MISSING, types[2] );
+
+    paths.clear();
+    GetPathTypes(paths, types);
+    ASSERT_TRUE( types.empty() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathType, testPathTypeProvider)
+  {
+    const std::string temp_directory = ra::filesystem::GetTemporaryDirectory();
+
+    FakePathTypeProvider provider;
+    SetPathTypeProvider(&provider);
+
+    ASSERT_EQ( PATH_TYPE_FILE, GetPathType("file.txt") );
+    ASSERT_EQ( PATH_TYPE_DIRECTORY, GetPathType("directory") );
+    ASSERT_EQ( PATH_TYPE_MISSING, GetPathType(temp_directory) );
+
+    // Restore the file system
+    SetPathTypeProvider(NULL);
+    ASSERT_EQ( PATH_TYPE_DIRECTORY, GetPathType(temp_directory) );
+    ASSERT_EQ( PATH_TYPE_MISSING, GetPathType("file.txt") );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
@@ -0,0 +1,201 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestPathTypeCache.h"
+#include "PathTypeCache.h"
+#include "rapidassist/testing.h"
+#include "rapidassist/filesystem.h"
+
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+
+namespace shellanything { namespace test
+{
+  /// <summary>
+  /// A PathTypeProvider which blocks each query until it is released.
+  /// </summary>
+  class BlockingPathTypeProvider : public PathTypeProvider
+  {
+  public:
+    BlockingPathTypeProvider() : type(PATH_TYPE_MISSING), num_queries(0), released(false) {}
+    virtual ~BlockingPathTypeProvider() {}
+
+    virtual PATH_TYPE GetPathType(const std::string & path)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      const PATH_TYPE result = type;
+      num_queries++;
+      condition.notify_all();
+      while (!released)
+        condition.wait(lock);
+      return result;
+    }
+
+    void WaitForQueries(size_t count)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (num_queries < count)
+        condition.wait(lock);
+    }
+
+    void Release()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      released = true;
+      condition.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    PATH_TYPE type;
+    size_t num_queries;
+    bool released;
+  };
+
+  void QueryPathType(std::string path, PATH_TYPE * type)
+  {
+    *type = PathTypeCache::GetInstance().GetPathType(path);
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  void TestPathTypeCache::SetUp()
+  {
+    PathTypeCache::GetInstance().SetTimeToLive(PathTypeCache::DEFAULT_TIME_TO_LIVE);
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestPathTypeCache::TearDown()
+  {
+    SetPathTypeProvider(NULL);
+    PathTypeCache::GetInstance().SetTimeToLive(PathTypeCache::DEFAULT_TIME_TO_LIVE);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathTypeCache, testNegativeEntries)
+  {
+    PathTypeCache & cache = PathTypeCache::GetInstance();
+
+    static const std::string path_separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = std::string("test_files") + path_separator + ra::testing::GetTestQualifiedName();
+    const std::string file = directory + path_separator + "file.txt";
+    ASSERT_TRUE( ra::filesystem::CreateDirectory(directory.c_str()) );
+
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t previous_hits = 0;
+    size_t previous_misses = 0;
+    cache.GetStatistics(previous_hits, previous_misses);
+
+    //assert a missing path is remembered
+    ASSERT_EQ( PATH_TYPE_DIRECTORY, cache.GetPathType(directory) );
+    ASSERT_FALSE( cache.Exists(file) );
+    ASSERT_TRUE( ra::filesystem::WriteFile(file, "foo") );
+    ASSERT_FALSE( cache.Exists(file) );
+    ASSERT_EQ( PATH_TYPE_DIRECTORY, cache.GetPathType(directory) );
+
+    cache.GetStatistics(hits, misses);
+    ASSERT_EQ( previous_hits + 2, hits );
+    ASSERT_EQ( previous_misses + 2, misses );
+
+    //assert the file is found once the path is invalidated
+    cache.Invalidate(file);
+    ASSERT_EQ( PATH_TYPE_FILE, cache.GetPathType(file) );
+
+    cache.GetStatistics(hits, misses);
+    ASSERT_EQ( previous_misses + 3, misses );
+
+    //cleanup
+    ASSERT_TRUE( ra::filesystem::DeleteFile(file.c_str()) ) << "Failed deleting file '" << file << "'.";
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathTypeCache, testTimeToLive)
+  {
+    PathTypeCache & cache = PathTypeCache::GetInstance();
+
+    static const std::string path_separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = std::string("test_files") + path_separator + ra::testing::GetTestQualifiedName();
+    ASSERT_TRUE( ra::filesystem::CreateDirectory(directory.c_str()) );
+
+    //assert the cache is disabled without a time to live
+    cache.SetTimeToLive(0);
+    const std::string file1 = directory + path_separator + "file1.txt";
+    ASSERT_FALSE( cache.Exists(file1) );
+    ASSERT_TRUE( ra::filesystem::WriteFile(file1, "foo") );
+    ASSERT_TRUE( cache.Exists(file1) );
+
+    //assert the type of a path expires
+    cache.SetTimeToLive(50);
+    const std::string file2 = directory + path_separator + "file2.txt";
+    ASSERT_FALSE( cache.Exists(file2) );
+    ASSERT_TRUE( ra::filesystem::WriteFile(file2, "foo") );
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_TRUE( cache.Exists(file2) );
+
+    //assert all paths are forgotten
+    cache.SetTimeToLive(PathTypeCache::DEFAULT_TIME_TO_LIVE);
+    const std::string file3 = directory + path_separator + "file3.txt";
+    ASSERT_FALSE( cache.Exists(file3) );
+    ASSERT_TRUE( ra::filesystem::WriteFile(file3, "foo") );
+    cache.Clear();
+    ASSERT_TRUE( cache.Exists(file3) );
+
+    //cleanup
+    ASSERT_TRUE( ra::filesystem::DeleteFile(file1.c_str()) ) << "Failed deleting file '" << file1 << "'.";
+    ASSERT_TRUE( ra::filesystem::DeleteFile(file2.c_str()) ) << "Failed deleting file '" << file2 << "'.";
+    ASSERT_TRUE( ra::filesystem::DeleteFile(file3.c_str()) ) << "Failed deleting file '" << file3 << "'.";
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathTypeCache, testInvalidateDuringQuery)
+  {
+    PathTypeCache & cache = PathTypeCache::GetInstance();
+    const std::string path = std::string("C:\\") + ra::testing::GetTestQualifiedName() + ".txt";
+
+    BlockingPathTypeProvider provider;
+    SetPathTypeProvider(&provider);
+
+    //the path is created while the cache queries the provider
+    PATH_TYPE queried = PATH_TYPE_FILE;
+    std::thread query(QueryPathType, path, &queried);
+    provider.WaitForQueries(1);
+    {
+      std::lock_guard<std::mutex> lock(provider.mutex);
+      provider.type = PATH_TYPE_FILE;
+    }
+    cache.Invalidate(path);
+    provider.Release();
+    query.join();
+    ASSERT_EQ( PATH_TYPE_MISSING, queried );
+
+    //assert the stale type of the query is not remembered
+    ASSERT_EQ( PATH_TYPE_FILE, cache.GetPathType(path) );
+    ASSERT_EQ( 2, provider.num_queries );
+
+    //assert the type is remembered when there is no invalidation
+    ASSERT_EQ( PATH_TYPE_FILE, cache.GetPathType(path) );
+    ASSERT_EQ( 2, provider.num_queries );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
@@ -0,0 +1,166 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestPatternSet.h"
+#include "PatternSet.h"
+#include "SelectionIndex.h"
+
+#include <random>
+
+namespace shellanything { namespace test
+{
+  std::string GetRandomPatternSetString(std::mt19937 & generator, const char * alphabet, size_t max_length)
+  {
+    const size_t alphabet_length = strlen(alphabet);
+    const size_t length = generator() % (max_length + 1);
+    std::string output;
+    for(size_t i=0; i<length; i++)
+    {
+      output.append(1, alphabet[generator() % alphabet_length]);
+    }
+    return output;
+  }
+
+  bool IsBitSet(const std::vector<uint64_t> & bits, size_t id)
+  {
+    return ((bits[id / 64] >> (id % 64)) & 1) != 0;
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  void TestPatternSet::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestPatternSet::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPatternSet, testMatcher)
+  {
+    WildcardPatternList patterns;
+    patterns.push_back(WildcardPattern("*.TXT", false));
+    patterns.push_back(WildcardPattern("*.DAT", false));
+    patterns.push_back(WildcardPattern("C:\\TEMP\\*", false));
+    patterns.push_back(WildcardPattern("*", false));
+    patterns.push_back(WildcardPattern("*\\?.TXT", false));
+    patterns.push_back(WildcardPattern("*EMP*EMP*", false));
+    PatternSet::Matcher matcher(patterns);
+
+    ASSERT_EQ( 6, matcher.GetCount() );
+    ASSERT_EQ( 1, matcher.GetNumWords() );
+
+    std::vector<uint64_t> bits(matcher.GetNumWords());
+    const std::string value = "c:\\temp\\a.txt";
+    matcher.Match(value.c_str(), value.size(), &bits[0]);
+    ASSERT_TRUE ( IsBitSet(bits, 0) );
+    ASSERT_FALSE( IsBitSet(bits, 1) );
+    ASSERT_TRUE ( IsBitSet(bits, 2) );
+    ASSERT_TRUE ( IsBitSet(bits, 3) );
+    ASSERT_TRUE ( IsBitSet(bits, 4) );
+    ASSERT_FALSE( IsBitSet(bits, 5) );
+
+    const std::string other = "D:\\TEMP\\TEMPLATE.DAT";
+    matcher.Match(other.c_str(), other.size(), &bits[0]);
+    ASSERT_FALSE( IsBitSet(bits, 0) );
+    ASSERT_TRUE ( IsBitSet(bits, 1) );
+    ASSERT_FALSE( IsBitSet(bits, 2) );
+    ASSERT_TRUE ( IsBitSet(bits, 3) );
+    ASSERT_FALSE( IsBitSet(bits, 4) );
+    ASSERT_TRUE ( IsBitSet(bits, 5) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPatternSet, testMatcherDifferential)
+  {
+    std::mt19937 generator(0x5eed);
+
+    for(size_t iteration=0; iteration<200; iteration++)
+    {
+      // Many overlapping literals over a small alphabet, across multiple words of the bitset. Includes path patterns.
+      WildcardPatternList patterns;
+      const size_t num_patterns = 1 + generator() % 150;
+      for(size_t i=0; i<num_patterns; i++)
+      {
+        const std::string prefix = (generator() % 2 == 0 ? "glob:" : "");
+        patterns.push_back(WildcardPattern(prefix + GetRandomPatternSetString(generator, "aB.*?\\[]", 8), false));
+      }
+      PatternSet::Matcher matcher(patterns);
+      std::vector<uint64_t> bits(matcher.GetNumWords() + 1);
+      std::vector<uint64_t> tested(matcher.GetNumWords() + 1); // reused for all values
+
+      for(size_t j=0; j<20; j++)
+      {
+        const std::string value = GetRandomPatternSetString(generator, "aAbB.\\/", 16);
+        matcher.Match(value.c_str(), value.size(), &bits[0], &tested[0]);
+        for(size_t i=0; i<patterns.size(); i++)
+        {
+          const bool expected = patterns[i].Match(value);
+          ASSERT_EQ( expected, IsBitSet(bits, i) ) << "pattern='" << patterns[i].GetPattern() << "' value='" << value << "'";
+        }
+      }
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPatternSet, testAdd)
+  {
+    PatternSet & pattern_set = PatternSet::GetInstance();
+
+    PatternSet::PatternId id1 = pattern_set.Add("*.TESTPATTERNSET1");
+    PatternSet::PatternId id2 = pattern_set.Add("*.TESTPATTERNSET2");
+    ASSERT_NE( id1, id2 );
+    ASSERT_EQ( id1, pattern_set.Add("*.TESTPATTERNSET1") );
+
+    PatternSet::MatcherPtr matcher = pattern_set.GetMatcher();
+    ASSERT_TRUE( matcher.get() != NULL );
+    ASSERT_GT( matcher->GetCount(), id2 );
+    ASSERT_EQ( matcher.get(), pattern_set.GetMatcher().get() ); // not built again
+
+    // A new pattern requires a new automaton
+    PatternSet::PatternId id3 = pattern_set.Add("*.TESTPATTERNSET3");
+    PatternSet::MatcherPtr matcher3 = pattern_set.GetMatcher();
+    ASSERT_GT( matcher3->GetCount(), id3 );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPatternSet, testSelectionIndex)
+  {
+    PatternSet & pattern_set = PatternSet::GetInstance();
+    PatternSet::PatternId txt = pattern_set.Add("*.TESTPATTERNSETTXT");
+
+    std::vector<std::string> elements;
+    elements.push_back("c:\\temp\\a.testpatternsettxt");
+    elements.push_back("c:\\temp\\b.dat");
+    SelectionIndex index(elements);
+
+    ASSERT_TRUE ( index.IsPatternMatch(0, txt) );
+    ASSERT_FALSE( index.IsPatternMatch(1, txt) );
+
+    // Patterns added after the matches were computed are also found
+    PatternSet::PatternId dat = pattern_set.Add("*.DAT");
+    ASSERT_FALSE( index.IsPatternMatch(0, dat) );
+    ASSERT_TRUE ( index.IsPatternMatch(1, dat) );
+    ASSERT_TRUE ( index.IsPatternMatch(0, txt) );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
@@ -24,9 +24,94 @@
 
 #include "TestPropertyManager.h"
 #include "PropertyManager.h"
+#include "rapidassist/environment_utf8.h"
+#include "rapidassist/strings.h"
+#include "shellanything/PropertyTemplate.h"
+
+#include <thread>
+#include <atomic>
+#include <vector>
 
 namespace shellanything { namespace test
 {
+  bool IsExpectedStressValue(const std::string & value)
+  {
+    // Expected format is "[N|N]" where both N are the same number.
+    if (value.size() < 5 || value[0] != '[' || value[value.size()-1] != ']')
+      return false;
+    size_t separator = value.find('|');
+    if (separator == std::string::npos)
+      return false;
+    std::string first = value.substr(1, separator - 1);
+    std::string second = value.substr(separator + 1, value.size() - separator - 2);
+    if (first.empty() || first != second)
+      return false;
+    return first.find_first_not_of("0123456789") == std::string::npos;
+  }
+
+  /// <summary>
+  /// A scope which modifies and reads the global properties while one of its properties is looked up.
+  /// </summary>
+  class ReentrantPropertyScope : public PropertyScope
+  {
+  public:
+    ReentrantPropertyScope() : mCount(0) {}
+
+  protected:
+    virtual const std::string * FindLocal(const char * name, size_t length) const
+    {
+      if (std::string(name, length) != "scope.reentrant")
+        return PropertyScope::FindLocal(name, length);
+
+      // Publish a new snapshot, then read from the manager
+      PropertyManager & pmgr = PropertyManager::GetInstance();
+      mCount++;
+      pmgr.SetProperty("scope.counter", ra::strings::ToString(mCount));
+      mValue = pmgr.GetProperty("scope.counter");
+      return &mValue;
+    }
+
+  private:
+    mutable size_t mCount;
+    mutable std::string mValue;
+  };
+
+  /// <summary>
+  /// Resolves the 'counting.*' properties to their name and counts the resolutions.
+  /// </summary>
+  class CountingPropertyResolver : public PropertyResolver
+  {
+  public:
+    static CountingPropertyResolver * GetInstance()
+    {
+      // The manager owns the resolvers: it is registered once
+      static CountingPropertyResolver * _instance = NULL;
+      if (_instance == NULL)
+      {
+        _instance = new CountingPropertyResolver();
+        PropertyManager::GetInstance().RegisterResolver(_instance);
+      }
+      return _instance;
+    }
+
+    virtual const std::string & GetPrefix() const
+    {
+      static const std::string prefix = "counting.";
+      return prefix;
+    }
+
+    virtual bool Resolve(const std::string & name, std::string & value) const
+    {
+      num_resolutions++;
+      value = name;
+      return true;
+    }
+
+    mutable std::atomic<size_t> num_resolutions;
+
+  private:
+    CountingPropertyResolver() : num_resolutions(0) {}
+  };
 
   //--------------------------------------------------------------------------------------------------
   void TestPropertyManager::SetUp()
@@ -98,6 +183,33 @@ namespace shellanything { namespace test
     }
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testExpandSpecialCases)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("foo", "bar");
+    pmgr.SetProperty("recursive", "${foo}");
+
+    //no property reference
+    ASSERT_EQ("", pmgr.Expand(""));
+    ASSERT_EQ("foo", pmgr.Expand("foo"));
+    ASSERT_EQ("$foo {foo} $", pmgr.Expand("$foo {foo} $"));
+
+    //references at the beginning, at the end and next to each other
+    ASSERT_EQ("bar", pmgr.Expand("${foo}"));
+    ASSERT_EQ("barbar", pmgr.Expand("${foo}${foo}"));
+    ASSERT_EQ("$bar}", pmgr.Expand("$${foo}}"));
+
+    //unterminated references
+    ASSERT_EQ("${foo", pmgr.Expand("${foo"));
+    ASSERT_EQ("bar ${foo", pmgr.Expand("${foo} ${foo"));
+
+    //nested references, the innermost reference is expanded
+    ASSERT_EQ("${unknownbar}", pmgr.Expand("${unknown${foo}}"));
+
+    //the value of a property is not expanded again
+    ASSERT_EQ("${foo}", pmgr.Expand("${recursive}"));
+  }
+  //--------------------------------------------------------------------------------------------------
   TEST_F(TestPropertyManager, testEnvironmentVariableProperty)
   {
     PropertyManager & pmgr = PropertyManager::GetInstance();
@@ -154,6 +266,327 @@ namespace shellanything { namespace test
     ASSERT_TRUE( pmgr.HasProperty(env_var_name) );
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testGeneration)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    const PropertyManager::Generation initial = pmgr.GetGeneration();
+    ASSERT_NE( PropertyManager::INVALID_GENERATION, initial );
+    ASSERT_EQ( PropertyManager::INVALID_GENERATION, pmgr.GetPropertyGeneration("generation.never.set") );
+
+    //setting a new property
+    pmgr.SetProperty("foo", "bar");
+    const PropertyManager::Generation foo_generation = pmgr.GetGeneration();
+    ASSERT_GT( foo_generation, initial );
+    ASSERT_EQ( foo_generation, pmgr.GetPropertyGeneration("foo") );
+    ASSERT_TRUE( pmgr.HasChanged("foo", initial) );
+    ASSERT_FALSE( pmgr.HasChanged("foo", foo_generation) );
+
+    //setting the same value is not a modification
+    pmgr.SetProperty("foo", "bar");
+    ASSERT_EQ( foo_generation, pmgr.GetGeneration() );
+    ASSERT_EQ( foo_generation, pmgr.GetPropertyGeneration("foo") );
+
+    //modifying another property
+    pmgr.SetProperty("baz", "qux");
+    const PropertyManager::Generation baz_generation = pmgr.GetGeneration();
+    ASSERT_GT( baz_generation, foo_generation );
+    ASSERT_FALSE( pmgr.HasChanged("foo", foo_generation) );
+    ASSERT_TRUE( pmgr.HasChanged("baz", foo_generation) );
+
+    std::vector<std::string> names;
+    names.push_back("foo");
+    names.push_back("unknown");
+    ASSERT_FALSE( pmgr.HasChanged(names, foo_generation) );
+    names.push_back("baz");
+    ASSERT_TRUE( pmgr.HasChanged(names, foo_generation) );
+    ASSERT_FALSE( pmgr.HasChanged(names, baz_generation) );
+
+    //deleting a property
+    pmgr.ClearProperty("foo");
+    ASSERT_TRUE( pmgr.HasChanged("foo", baz_generation) );
+    const PropertyManager::Generation delete_generation = pmgr.GetGeneration();
+
+    //deleting an unknown property is not a modification
+    pmgr.ClearProperty("foo");
+    ASSERT_EQ( delete_generation, pmgr.GetGeneration() );
+
+    //clearing all properties
+    pmgr.Clear();
+    ASSERT_TRUE( pmgr.HasChanged("baz", delete_generation) );
+    ASSERT_TRUE( pmgr.HasChanged("path.separator", delete_generation) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testPropertyId)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    ASSERT_EQ( PropertyManager::INVALID_PROPERTY_ID, pmgr.FindPropertyId("property.id.never.used") );
+
+    PropertyManager::PropertyId id = pmgr.GetPropertyId("property.id.never.used");
+    ASSERT_NE( PropertyManager::INVALID_PROPERTY_ID, id );
+    ASSERT_EQ( id, pmgr.FindPropertyId("property.id.never.used") );
+    ASSERT_FALSE( pmgr.HasProperty(id) );
+
+    //set by id, get by name
+    pmgr.SetProperty(id, "foo");
+    ASSERT_TRUE( pmgr.HasProperty("property.id.never.used") );
+    ASSERT_EQ( "foo", pmgr.GetProperty("property.id.never.used") );
+
+    //set by name, get by id
+    pmgr.SetProperty("property.id.never.used", "bar");
+    ASSERT_EQ( "bar", pmgr.GetProperty(id) );
+    std::string output = "foo";
+    ASSERT_TRUE( pmgr.AppendProperty(id, output) );
+    ASSERT_EQ( "foobar", output );
+
+    //ids are kept when properties are deleted
+    pmgr.Clear();
+    ASSERT_FALSE( pmgr.HasProperty(id) );
+    ASSERT_EQ( "", pmgr.GetProperty(id) );
+    ASSERT_EQ( id, pmgr.GetPropertyId("property.id.never.used") );
+
+    //invalid ids are never set
+    ASSERT_FALSE( pmgr.HasProperty(PropertyManager::INVALID_PROPERTY_ID) );
+    ASSERT_EQ( "", pmgr.GetProperty(PropertyManager::INVALID_PROPERTY_ID) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testEnvironmentVariableResolution)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    const char * var_name = "SHELLANYTHING_TEST_ENVIRONMENT_VARIABLE";
+    const std::string name = std::string("env.") + var_name;
+
+    //environment variables are resolved on demand
+    ASSERT_TRUE( ra::environment::SetEnvironmentVariableUtf8(var_name, "foo") );
+    pmgr.SetProperty("test.generation", "1");
+    ASSERT_TRUE( pmgr.HasProperty(name) );
+    ASSERT_EQ( "foo", pmgr.GetProperty(name) );
+    ASSERT_EQ( "[foo]", pmgr.Expand("[${" + name + "}]") );
+
+    //the resolved value is kept until the generation changes
+    ASSERT_TRUE( ra::environment::SetEnvironmentVariableUtf8(var_name, "bar") );
+    ASSERT_EQ( "foo", pmgr.GetProperty(name) );
+    pmgr.SetProperty("test.generation", "2");
+    ASSERT_EQ( "bar", pmgr.GetProperty(name) );
+
+    //a property can override an environment variable
+    pmgr.SetProperty(name, "baz");
+    ASSERT_EQ( "baz", pmgr.GetProperty(name) );
+    pmgr.ClearProperty(name);
+    ASSERT_EQ( "bar", pmgr.GetProperty(name) );
+
+    //in snapshot mode, the resolved value is kept until refreshed
+    pmgr.SetSnapshotMode(true);
+    ASSERT_TRUE( ra::environment::SetEnvironmentVariableUtf8(var_name, "qux") );
+    pmgr.SetProperty("test.generation", "3");
+    ASSERT_EQ( "bar", pmgr.GetProperty(name) );
+    pmgr.RefreshResolvedProperties();
+    ASSERT_EQ( "qux", pmgr.GetProperty(name) );
+    pmgr.SetSnapshotMode(false);
+
+    //deleted environment variables are not defined
+    ASSERT_TRUE( ra::environment::SetEnvironmentVariableUtf8(var_name, "") );
+    pmgr.SetProperty("test.generation", "4");
+    ASSERT_FALSE( pmgr.HasProperty(name) );
+    ASSERT_EQ( "${" + name + "}", pmgr.Expand("${" + name + "}") );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testLazyResolution)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    CountingPropertyResolver * resolver = CountingPropertyResolver::GetInstance();
+
+    ASSERT_EQ( "a", pmgr.GetProperty("counting.a") );
+    ASSERT_EQ( "b", pmgr.GetProperty("counting.b") );
+    const size_t count = resolver->num_resolutions;
+
+    //assert modifications do not resolve the properties again
+    for(int i=0; i<10; i++)
+    {
+      pmgr.SetProperty("test.lazy", ra::strings::ToString(i));
+    }
+    pmgr.ClearProperty("test.lazy");
+    ASSERT_EQ( count, resolver->num_resolutions );
+
+    //assert a stale property is resolved again once, on its next lookup
+    ASSERT_EQ( "a", pmgr.GetProperty("counting.a") );
+    ASSERT_EQ( "a", pmgr.GetProperty("counting.a") );
+    ASSERT_EQ( count + 1, resolver->num_resolutions );
+
+    //assert a refresh does not resolve the properties either
+    pmgr.RefreshResolvedProperties();
+    ASSERT_EQ( count + 1, resolver->num_resolutions );
+    ASSERT_EQ( "b", pmgr.GetProperty("counting.b") );
+    ASSERT_EQ( count + 2, resolver->num_resolutions );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testConcurrentExpand)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("stress.value", "0");
+
+    static const size_t NUM_READERS = 8;
+    static const size_t NUM_WRITES = 20000;
+
+    const PropertyTemplate t("[${stress.value}|${stress.value}]");
+    std::atomic<bool> done(false);
+    std::atomic<size_t> errors(0);
+    std::atomic<size_t> reads(0);
+
+    // Readers expand the same property twice. Both references must always be expanded from the same snapshot.
+    std::vector<std::thread> readers;
+    for(size_t i=0; i<NUM_READERS; i++)
+    {
+      readers.push_back(std::thread([&pmgr, &t, &done, &errors, &reads]()
+      {
+        while(!done)
+        {
+          if (!IsExpectedStressValue(pmgr.Expand("[${stress.value}|${stress.value}]")))
+            errors++;
+          if (!IsExpectedStressValue(t.Expand()))
+            errors++;
+          if (!pmgr.HasProperty("stress.value") || pmgr.GetProperty("line.separator").empty())
+            errors++;
+          if (pmgr.GetProperty("env.PATH").empty())
+            errors++;
+          reads++;
+        }
+      }));
+    }
+
+    // A writer modifies the expanded property.
+    std::thread value_writer([&pmgr]()
+    {
+      for(size_t i=1; i<=NUM_WRITES; i++)
+      {
+        pmgr.SetProperty("stress.value", ra::strings::ToString(i));
+      }
+    });
+
+    // Another writer adds and deletes unrelated properties.
+    std::thread other_writer([&pmgr]()
+    {
+      for(size_t i=0; i<NUM_WRITES; i++)
+      {
+        const std::string name = "stress.other." + ra::strings::ToString(i % 64);
+        pmgr.SetProperty(name, ra::strings::ToString(i));
+        if (i % 3 == 0)
+          pmgr.ClearProperty(name);
+      }
+    });
+
+    value_writer.join();
+    other_writer.join();
+    done = true;
+    for(size_t i=0; i<readers.size(); i++)
+    {
+      readers[i].join();
+    }
+
+    ASSERT_EQ( 0, errors );
+    ASSERT_GT( reads, 0 );
+    ASSERT_EQ( ra::strings::ToString(NUM_WRITES), pmgr.GetProperty("stress.value") );
+    ASSERT_EQ( "[20000|20000]", t.Expand() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testPropertyScope)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("scope.global", "global");
+    pmgr.SetProperty("scope.shadowed", "global");
+
+    PropertyScope parent;
+    parent.SetProperty("scope.parent", "parent");
+    parent.SetProperty("scope.shadowed", "parent");
+
+    PropertyScope scope;
+    scope.SetParent(&parent);
+    scope.SetProperty("scope.local", "local");
+
+    const std::string value = "${scope.global} ${scope.parent} ${scope.shadowed} ${scope.local}";
+    const PropertyTemplate t(value);
+    ASSERT_EQ( "global ${scope.parent} global ${scope.local}", t.Expand() );
+
+    {
+      PropertyManager::ActiveScope active_scope(scope);
+      ASSERT_TRUE( PropertyManager::GetActiveScope() == &scope );
+
+      ASSERT_EQ( "global parent parent local", pmgr.Expand(value) );
+      ASSERT_EQ( "global parent parent local", t.Expand() );
+      ASSERT_TRUE( pmgr.HasProperty("scope.local") );
+      ASSERT_EQ( "parent", pmgr.GetProperty(pmgr.GetPropertyId("scope.shadowed")) );
+      ASSERT_TRUE( pmgr.IsScopedProperty(pmgr.GetPropertyId("scope.local")) );
+      ASSERT_FALSE( pmgr.IsScopedProperty(pmgr.GetPropertyId("scope.global")) );
+
+      // Global modifications are visible through the scope
+      pmgr.SetProperty("scope.global", "modified");
+      ASSERT_EQ( "modified parent parent local", t.Expand() );
+    }
+
+    // The global properties are not modified by the scope
+    ASSERT_TRUE( PropertyManager::GetActiveScope() == NULL );
+    ASSERT_FALSE( pmgr.HasProperty("scope.local") );
+    ASSERT_EQ( "global", pmgr.GetProperty("scope.shadowed") );
+    ASSERT_EQ( "modified ${scope.parent} global ${scope.local}", t.Expand() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testReentrantScope)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    const char * var_name = "SHELLANYTHING_TEST_REENTRANT_VARIABLE";
+    ASSERT_TRUE( ra::environment::SetEnvironmentVariableUtf8(var_name, "env") );
+    pmgr.SetProperty("scope.global", "global");
+    pmgr.SetProperty("scope.counter", "0");
+
+    ReentrantPropertyScope scope;
+    PropertyManager::ActiveScope active_scope(scope);
+
+    // The snapshot used by the expansion must outlive the snapshots published by the resolution
+    // of 'env.*' properties and by the scope. All references are expanded from the same snapshot.
+    const std::string value = "${scope.global}|${env.SHELLANYTHING_TEST_REENTRANT_VARIABLE}|${scope.reentrant}|${scope.global}";
+    ASSERT_EQ( "global|env|0|global", pmgr.Expand(value) );
+    ASSERT_EQ( "global|env|1|global", pmgr.Expand(value) );
+    ASSERT_EQ( "2", pmgr.GetProperty("scope.counter") );
+
+    ASSERT_TRUE( ra::environment::SetEnvironmentVariableUtf8(var_name, "") );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyManager, testConcurrentPropertyScopes)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+
+    // Each thread expands the same template through its own scope
+    const PropertyTemplate t("thread ${scope.thread.id}");
+
+    static const size_t NUM_THREADS = 4;
+    static const size_t NUM_ITERATIONS = 10000;
+    std::atomic<size_t> errors(0);
+
+    std::vector<std::thread> threads;
+    for(size_t i=0; i<NUM_THREADS; i++)
+    {
+      threads.push_back(std::thread([&t, &errors, i]()
+      {
+        PropertyScope scope;
+        scope.SetProperty("scope.thread.id", ra::strings::ToString(i));
+        PropertyManager::ActiveScope active_scope(scope);
+
+        const std::string expected = "thread " + ra::strings::ToString(i);
+        for(size_t j=0; j<NUM_ITERATIONS; j++)
+        {
+          if (t.Expand() != expected)
+            errors++;
+        }
+      }));
+    }
+    for(size_t i=0; i<threads.size(); i++)
+    {
+      threads[i].join();
+    }
+
+    ASSERT_EQ( 0, errors.load() );
+    ASSERT_FALSE( pmgr.HasProperty("scope.thread.id") );
+  }
+  //--------------------------------------------------------------------------------------------------
 
 } //namespace test
 } //namespace shellanything
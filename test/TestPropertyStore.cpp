@@ -0,0 +1,126 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestPropertyStore.h"
+#include "PropertyStore.h"
+#include "rapidassist/strings.h"
+
+namespace shellanything { namespace test
+{
+
+  //--------------------------------------------------------------------------------------------------
+  void TestPropertyStore::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestPropertyStore::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyStore, testIntern)
+  {
+    PropertyStore store;
+    ASSERT_EQ( 0, store.GetCount() );
+
+    PropertyStore::PropertyId foo = store.Intern("foo");
+    PropertyStore::PropertyId bar = store.Intern("bar");
+    ASSERT_NE( PropertyStore::INVALID_PROPERTY_ID, foo );
+    ASSERT_NE( PropertyStore::INVALID_PROPERTY_ID, bar );
+    ASSERT_NE( foo, bar );
+    ASSERT_EQ( 2, store.GetCount() );
+
+    //interning a known name returns the same id
+    ASSERT_EQ( foo, store.Intern("foo") );
+    ASSERT_EQ( 2, store.GetCount() );
+
+    //interned names are not defined
+    ASSERT_FALSE( store.IsDefined(foo) );
+    ASSERT_EQ( "foo", store.Get(foo).name );
+    ASSERT_EQ( "bar", store.Get(bar).name );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyStore, testFind)
+  {
+    PropertyStore store;
+    PropertyStore::PropertyId foo = store.Intern("foo");
+
+    ASSERT_EQ( foo, store.Find("foo") );
+    ASSERT_EQ( PropertyStore::INVALID_PROPERTY_ID, store.Find("fo") );
+    ASSERT_EQ( PropertyStore::INVALID_PROPERTY_ID, store.Find("fooo") );
+    ASSERT_EQ( PropertyStore::INVALID_PROPERTY_ID, store.Find("") );
+
+    //find a name within a larger string
+    const char * value = "${foo}";
+    ASSERT_EQ( foo, store.Find(value + 2, 3) );
+    ASSERT_EQ( PropertyStore::INVALID_PROPERTY_ID, store.Find(value + 2, 2) );
+
+    //invalid ids are never defined
+    ASSERT_FALSE( store.IsDefined(PropertyStore::INVALID_PROPERTY_ID) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyStore, testStableIds)
+  {
+    PropertyStore store;
+
+    //intern enough names to force the table to grow multiple times
+    static const size_t count = 10000;
+    std::vector<PropertyStore::PropertyId> ids;
+    for(size_t i=0; i<count; i++)
+    {
+      std::string name = "property." + ra::strings::ToString(i);
+      PropertyStore::PropertyId id = store.Intern(name);
+      store.Get(id).value = ra::strings::ToString(i);
+      store.Get(id).defined = true;
+      ids.push_back(id);
+    }
+    ASSERT_EQ( count, store.GetCount() );
+
+    for(size_t i=0; i<count; i++)
+    {
+      std::string name = "property." + ra::strings::ToString(i);
+      ASSERT_EQ( ids[i], store.Find(name) );
+      ASSERT_TRUE( store.IsDefined(ids[i]) );
+      ASSERT_EQ( ra::strings::ToString(i), store.Get(ids[i]).value );
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyStore, testCopy)
+  {
+    PropertyStore store1;
+    PropertyStore::PropertyId foo = store1.Intern("foo");
+    store1.Get(foo).value = "bar";
+    store1.Get(foo).defined = true;
+
+    PropertyStore store2(store1);
+    ASSERT_EQ( foo, store2.Find("foo") );
+    ASSERT_EQ( "bar", store2.Get(foo).value );
+
+    //copies are independent
+    store2.Get(foo).value = "baz";
+    ASSERT_EQ( "bar", store1.Get(foo).value );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
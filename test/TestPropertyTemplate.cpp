@@ -0,0 +1,182 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestPropertyTemplate.h"
+#include "shellanything/PropertyTemplate.h"
+#include "PropertyManager.h"
+
+namespace shellanything { namespace test
+{
+
+  //--------------------------------------------------------------------------------------------------
+  void TestPropertyTemplate::SetUp()
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.Clear();
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestPropertyTemplate::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyTemplate, testLiteral)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("foo", "bar");
+
+    PropertyTemplate t("The quick brown fox jumps over the lazy dog.");
+    ASSERT_TRUE( t.IsLiteral() );
+
+    //a literal template returns its own value
+    ASSERT_EQ( "The quick brown fox jumps over the lazy dog.", t.Expand() );
+
+    //the value of a literal template is not copied in the buffer
+    std::string buffer;
+    const std::string & expanded = t.Expand(buffer);
+    ASSERT_EQ( &t.GetValue(), &expanded );
+    ASSERT_TRUE( buffer.empty() );
+
+    //empty template
+    PropertyTemplate empty;
+    ASSERT_TRUE( empty.IsLiteral() );
+    ASSERT_EQ( "", empty.Expand() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyTemplate, testExpand)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("job", "actor");
+    pmgr.SetProperty("name", "Brad Pitt");
+
+    PropertyTemplate t("${name} is a famous ${job}.");
+    ASSERT_FALSE( t.IsLiteral() );
+    ASSERT_EQ( "Brad Pitt is a famous actor.", t.Expand() );
+
+    //the template follows the current value of the properties
+    pmgr.SetProperty("name", "Angelina Jolie");
+    ASSERT_EQ( "Angelina Jolie is a famous actor.", t.Expand() );
+
+    //expand in a buffer
+    std::string buffer;
+    const std::string & expanded = t.Expand(buffer);
+    ASSERT_EQ( &buffer, &expanded );
+    ASSERT_EQ( "Angelina Jolie is a famous actor.", buffer );
+    pmgr.SetProperty("job", "director");
+    ASSERT_EQ( "Angelina Jolie is a famous director.", t.Expand(buffer) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyTemplate, testExpandUnchangedProperties)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("foo", "bar");
+    pmgr.SetProperty("baz", "qux");
+
+    PropertyTemplate t("${foo}.${unknown}");
+    ASSERT_EQ( "bar.${unknown}", t.Expand() );
+
+    //modifying an unrelated property does not change the expanded value
+    pmgr.SetProperty("baz", "quux");
+    ASSERT_EQ( "bar.${unknown}", t.Expand() );
+
+    //setting an unknown property must update the expanded value
+    pmgr.SetProperty("unknown", "known");
+    ASSERT_EQ( "bar.known", t.Expand() );
+
+    //deleting a property must update the expanded value
+    pmgr.ClearProperty("foo");
+    ASSERT_EQ( "${foo}.known", t.Expand() );
+
+    //clearing all properties must update the expanded value
+    pmgr.SetProperty("foo", "bar");
+    ASSERT_EQ( "bar.known", t.Expand() );
+    pmgr.Clear();
+    ASSERT_EQ( "${foo}.${unknown}", t.Expand() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyTemplate, testSameAsPropertyManager)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("foo", "bar");
+    pmgr.SetProperty("recursive", "${foo}");
+
+    static const char * values[] = {
+      "",
+      "${foo}",
+      "${foo}${foo}",
+      "$${foo}}",
+      "${unknown}",
+      "${foo",
+      "foo}",
+      "${unknown${foo}}",
+      "${recursive}",
+      "before ${foo} middle ${unknown} after",
+    };
+    static const size_t num_values = sizeof(values)/sizeof(values[0]);
+
+    for(size_t i=0; i<num_values; i++)
+    {
+      const std::string value = values[i];
+      PropertyTemplate t(value);
+      ASSERT_EQ( pmgr.Expand(value), t.Expand() ) << "value=" << value;
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyTemplate, testSetValue)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("foo", "bar");
+
+    PropertyTemplate t("${foo}");
+    ASSERT_EQ( "bar", t.Expand() );
+
+    //changing the value must recompile the template
+    t.SetValue("foo");
+    ASSERT_TRUE( t.IsLiteral() );
+    ASSERT_EQ( "foo", t.GetValue() );
+    ASSERT_EQ( "foo", t.Expand() );
+
+    t.SetValue("[${foo}]");
+    ASSERT_FALSE( t.IsLiteral() );
+    ASSERT_EQ( "[bar]", t.Expand() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPropertyTemplate, testCopy)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    pmgr.SetProperty("foo", "bar");
+
+    PropertyTemplate t1("${foo}-${foo}");
+    PropertyTemplate t2(t1);
+    PropertyTemplate t3;
+    t3 = t1;
+
+    ASSERT_EQ( t1.GetValue(), t2.GetValue() );
+    ASSERT_EQ( t1.GetValue(), t3.GetValue() );
+    ASSERT_EQ( "bar-bar", t2.Expand() );
+    ASSERT_EQ( "bar-bar", t3.Expand() );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
@@ -0,0 +1,125 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestSelectionIndex.h"
+#include "SelectionIndex.h"
+#include "rapidassist/filesystem.h"
+
+namespace shellanything { namespace test
+{
+
+  //--------------------------------------------------------------------------------------------------
+  void TestSelectionIndex::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestSelectionIndex::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSelectionIndex, testPaths)
+  {
+    static const std::string path_separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = std::string("foo") + path_separator + "bar.dir";
+
+    std::vector<std::string> elements;
+    elements.push_back(directory + path_separator + "file.txt");
+    elements.push_back(directory + path_separator + "archive.tar.gz");
+    elements.push_back(directory + path_separator + "README");
+    SelectionIndex index(elements);
+
+    ASSERT_EQ( 3, index.GetCount() );
+
+    ASSERT_EQ( std::string("file.txt"),       index.GetFilename(0) );
+    ASSERT_EQ( std::string("archive.tar.gz"), index.GetFilename(1) );
+    ASSERT_EQ( std::string("README"),         index.GetFilename(2) );
+
+    ASSERT_EQ( std::string("file"),           index.GetFilenameWithoutExtension(0) );
+    ASSERT_EQ( std::string("archive.tar"),    index.GetFilenameWithoutExtension(1) );
+    ASSERT_EQ( std::string("README"),         index.GetFilenameWithoutExtension(2) );
+
+    ASSERT_EQ( std::string("txt"),            index.GetFileExtension(0) );
+    ASSERT_EQ( std::string("gz"),             index.GetFileExtension(1) );
+    ASSERT_EQ( std::string(""),               index.GetFileExtension(2) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSelectionIndex, testUniqueExtensions)
+  {
+    std::vector<std::string> elements;
+    elements.push_back("a.txt");
+    elements.push_back("b.TXT");
+    elements.push_back("c.dat");
+    elements.push_back("d");
+    elements.push_back("e.Txt");
+    elements.push_back("f.tx\xC3\xA9"); // utf-8 characters are left unchanged
+    elements.push_back("g.TX\xC3\xA9");
+    SelectionIndex index(elements);
+
+    // Sorted by name, case insensitive
+    const SelectionIndex::ExtensionList & extensions = index.GetUniqueExtensions();
+    ASSERT_EQ( 4, extensions.size() );
+    ASSERT_EQ( std::string(""),    extensions[0].name );
+    ASSERT_EQ( 1,                  extensions[0].count );
+    ASSERT_EQ( std::string("DAT"), extensions[1].name );
+    ASSERT_EQ( 1,                  extensions[1].count );
+    ASSERT_EQ( std::string("TXT"), extensions[2].name );
+    ASSERT_EQ( 3,                  extensions[2].count );
+    ASSERT_EQ( std::string("TX\xC3\xA9"), extensions[3].name );
+    ASSERT_EQ( 2,                  extensions[3].count );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSelectionIndex, testDrives)
+  {
+    std::vector<std::string> elements;
+    elements.push_back("C:\\Windows\\System32\\cmd.exe");
+    elements.push_back("D:\\file.txt");
+    elements.push_back("\\\\localhost\\shared\\file.txt");
+    SelectionIndex index(elements);
+
+    ASSERT_EQ( 2, index.GetNumDriveLetters() );
+    ASSERT_EQ( 1, index.GetNumDriveClass(DRIVE_CLASS_NETWORK) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestSelectionIndex, testInvalidate)
+  {
+    std::vector<std::string> elements;
+    elements.push_back("a.txt");
+    SelectionIndex index(elements);
+    const PatternSet::PatternId dat = PatternSet::GetInstance().Add("*.dat");
+
+    ASSERT_EQ( 1, index.GetUniqueExtensions().size() );
+    ASSERT_FALSE( index.IsPatternMatch(0, dat) );
+
+    elements.push_back("b.dat");
+    index.Invalidate();
+
+    ASSERT_EQ( 2, index.GetCount() );
+    ASSERT_EQ( 2, index.GetUniqueExtensions().size() );
+    ASSERT_TRUE( index.IsPatternMatch(1, dat) );
+    ASSERT_EQ( std::string("dat"), index.GetFileExtension(1) );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
@@ -766,6 +766,155 @@ namespace shellanything { namespace test
 
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestValidator, testPropertyReferences)
+  {
+    Context c;
+    {
+      Context::ElementList elements;
+      elements.push_back("C:\\Windows\\System32\\cmd.exe"     );
+      elements.push_back("C:\\Windows\\System32\\notepad.exe" );
+      c.SetElements(elements);
+    }
+
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    const std::string property_name = ra::testing::GetTestQualifiedName();
+    pmgr.SetProperty(property_name, "dll");
+
+    Validator v;
+
+    //assert lists are resolved again when the referenced property is modified
+    v.SetFileExtensions("${" + property_name + "};msc");
+    ASSERT_FALSE( v.Validate(c) );
+    pmgr.SetProperty(property_name, "exe");
+    ASSERT_TRUE( v.Validate(c) );
+    v.SetFileExtensions("");
+
+    v.SetPattern("*.${" + property_name + "}");
+    ASSERT_TRUE( v.Validate(c) );
+    pmgr.SetProperty(property_name, "dll");
+    ASSERT_FALSE( v.Validate(c) );
+
+    //assert the inversed attributes are updated
+    v.SetInserve("pattern");
+    ASSERT_TRUE( v.Validate(c) );
+    v.SetInserve("");
+    ASSERT_FALSE( v.Validate(c) );
+    v.SetPattern("");
+
+    v.SetClass(".${" + property_name + "}");
+    ASSERT_FALSE( v.Validate(c) );
+    pmgr.SetProperty(property_name, "exe");
+    ASSERT_TRUE( v.Validate(c) );
+
+    //assert a copy is identical
+    Validator copy = v;
+    ASSERT_TRUE( copy.Validate(c) );
+    pmgr.SetProperty(property_name, "dll");
+    ASSERT_FALSE( copy.Validate(c) );
+
+    pmgr.ClearProperty(property_name);
+  }
+  //--------------------------------------------------------------------------------------------------
+
+  TEST_F(TestValidator, testPatternGlob)
+  {
+    Context c;
+    {
+      Context::ElementList elements;
+      elements.push_back("C:\\Projects\\foo\\build\\release\\foo.dll");
+      elements.push_back("C:\\Projects\\bar\\build\\bar.dll"         );
+      c.SetElements(elements);
+    }
+
+    Validator v;
+
+    //assert "**" matches any number of directories
+    v.SetPattern("glob:C:\\Projects\\**\\build\\**\\*.dll");
+    ASSERT_TRUE( v.Validate(c) );
+    v.SetPattern("glob:c:/projects/**/BUILD/**/*.DLL"); //any separator, any case
+    ASSERT_TRUE( v.Validate(c) );
+
+    //assert '*' does not match path separators in a path pattern
+    v.SetPattern("glob:C:\\Projects\\**\\build\\*.dll");
+    ASSERT_FALSE( v.Validate(c) );
+    v.SetPattern("glob:C:\\Projects\\**\\build\\*.dll;GLOB:C:\\Projects\\**\\build\\release\\*.dll");
+    ASSERT_TRUE( v.Validate(c) );
+
+    //assert patterns without the "glob:" prefix keep the wildcard semantics
+    v.SetPattern("C:\\Projects\\**\\build\\*.dll");
+    ASSERT_TRUE( v.Validate(c) );
+    v.SetPattern("C:\\Projects\\**\\[bf][ao][or].dll");
+    ASSERT_FALSE( v.Validate(c) );
+
+    //assert sets
+    v.SetPattern("glob:C:\\Projects\\**\\[bf][ao][or].dll");
+    ASSERT_TRUE( v.Validate(c) );
+    v.SetPattern("glob:C:\\Projects\\**\\[!b]*.dll");
+    ASSERT_FALSE( v.Validate(c) );
+    v.SetInserve("pattern");
+    v.SetPattern("glob:C:\\Projects\\**\\[x-z]*.dll");
+    ASSERT_TRUE( v.Validate(c) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestValidator, testGetDependencies)
+  {
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    Validator::PropertyIdList ids;
+
+    //assert the default validator does not depend on anything
+    Validator v;
+    ASSERT_EQ( 0, v.GetDependencies(ids) );
+    ASSERT_TRUE( ids.empty() );
+
+    v.SetMaxFiles(3);
+    ASSERT_EQ( Validator::DEPENDS_ON_COUNTS, v.GetDependencies(ids) );
+
+    v = Validator();
+    v.SetFileExtensions("txt");
+    v.SetPattern("*.txt");
+    ASSERT_EQ( Validator::DEPENDS_ON_EXTENSIONS | Validator::DEPENDS_ON_PATHS, v.GetDependencies(ids) );
+
+    v = Validator();
+    v.SetFileExists("C:\\Windows");
+    ASSERT_EQ( Validator::DEPENDS_ON_FILESYSTEM, v.GetDependencies(ids) );
+
+    v = Validator();
+    v.SetClass("drive:network");
+    ASSERT_EQ( Validator::DEPENDS_ON_COUNTS | Validator::DEPENDS_ON_EXTENSIONS | Validator::DEPENDS_ON_DRIVES, v.GetDependencies(ids) );
+    ASSERT_TRUE( ids.empty() );
+
+    //assert the properties are listed
+    v = Validator();
+    v.SetProperties("foo;bar");
+    ASSERT_EQ( Validator::DEPENDS_ON_PROPERTIES, v.GetDependencies(ids) );
+    ASSERT_EQ( 2, ids.size() );
+    ASSERT_EQ( pmgr.GetPropertyId("foo"), ids[0] );
+    ASSERT_EQ( pmgr.GetPropertyId("bar"), ids[1] );
+
+    //assert referenced properties are listed
+    ids.clear();
+    v = Validator();
+    v.SetFileExtensions("${foo}");
+    ASSERT_EQ( Validator::DEPENDS_ON_EXTENSIONS | Validator::DEPENDS_ON_PROPERTIES, v.GetDependencies(ids) );
+    ASSERT_EQ( 1, ids.size() );
+    ASSERT_EQ( pmgr.GetPropertyId("foo"), ids[0] );
+
+    //assert the names of expanded properties are unknown, they may be selection properties
+    ids.clear();
+    v = Validator();
+    v.SetProperties("${foo}");
+    ASSERT_EQ( Validator::DEPENDS_ON_PATHS | Validator::DEPENDS_ON_PROPERTIES | Validator::DEPENDS_ON_ALL_PROPERTIES, v.GetDependencies(ids) );
+
+    //assert selection properties depend on the elements
+    ids.clear();
+    v = Validator();
+    v.SetPattern("${selection.parent.path}\\*.txt");
+    ASSERT_EQ( Validator::DEPENDS_ON_PATHS | Validator::DEPENDS_ON_PROPERTIES, v.GetDependencies(ids) );
+    ASSERT_EQ( 2, ids.size() );
+    ASSERT_EQ( pmgr.GetPropertyId("selection.parent.path"), ids[0] );
+    ASSERT_EQ( pmgr.GetPropertyId(Context::MULTI_SELECTION_SEPARATOR_PROPERTY_NAME), ids[1] );
+  }
+  //--------------------------------------------------------------------------------------------------
 
 } //namespace test
 } //namespace shellanything
@@ -0,0 +1,160 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestValidatorCache.h"
+#include "ValidatorCache.h"
+#include "shellanything/Menu.h"
+#include "PropertyManager.h"
+#include "rapidassist/testing.h"
+
+namespace shellanything { namespace test
+{
+
+  //--------------------------------------------------------------------------------------------------
+  void TestValidatorCache::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestValidatorCache::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestValidatorCache, testIntern)
+  {
+    ValidatorCache & cache = ValidatorCache::GetInstance();
+    const std::string property_name = ra::testing::GetTestQualifiedName();
+
+    Validator v1;
+    v1.SetProperties(property_name);
+    v1.SetPattern("*.txt");
+    Validator v2 = v1;
+    Validator v3 = v1;
+    v3.SetInserve("pattern");
+
+    ValidatorCache::ValidatorPtr p1 = cache.Intern(v1);
+    ValidatorCache::ValidatorPtr p2 = cache.Intern(v2);
+    ValidatorCache::ValidatorPtr p3 = cache.Intern(v3);
+
+    //assert identical validators are shared
+    ASSERT_TRUE( p1.get() == p2.get() );
+    ASSERT_TRUE( p1.get() != p3.get() );
+    ASSERT_EQ( std::string("*.txt"), p1->GetPattern() );
+    ASSERT_EQ( std::string("pattern"), p3->GetInserve() );
+
+    //assert a validator which is not used anymore is forgotten
+    const size_t count = cache.GetInternedCount();
+    p3.reset();
+    ASSERT_EQ( count - 1, cache.GetInternedCount() );
+
+    //assert a forgotten validator is interned again
+    p3 = cache.Intern(v3);
+    ASSERT_EQ( count, cache.GetInternedCount() );
+    ASSERT_EQ( std::string("pattern"), p3->GetInserve() );
+
+    //assert many validators which are not used anymore are forgotten
+    for(int i=0; i<1000; i++)
+    {
+      Validator temporary = v1;
+      temporary.SetMaxFiles(i);
+      ASSERT_EQ( i, cache.Intern(temporary)->GetMaxFiles() );
+    }
+    ASSERT_EQ( count, cache.GetInternedCount() );
+    ASSERT_TRUE( p1.get() == cache.Intern(v2).get() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestValidatorCache, testMenuSharedValidators)
+  {
+    const std::string property_name = ra::testing::GetTestQualifiedName();
+
+    Validator v;
+    v.SetProperties(property_name);
+
+    Menu m1;
+    Menu m2;
+    m1.SetVisibility(v);
+    m2.SetVisibility(v);
+    m2.SetValidity(v);
+
+    ASSERT_TRUE( &m1.GetVisibility() == &m2.GetVisibility() );
+    ASSERT_TRUE( &m2.GetVisibility() == &m2.GetValidity() );
+    ASSERT_TRUE( &m1.GetVisibility() != &m1.GetValidity() );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestValidatorCache, testUpdatePass)
+  {
+    ValidatorCache & cache = ValidatorCache::GetInstance();
+    PropertyManager & pmgr = PropertyManager::GetInstance();
+    const std::string property_name = ra::testing::GetTestQualifiedName();
+
+    Validator v;
+    v.SetProperties(property_name);
+    ValidatorCache::ValidatorPtr validator = cache.Intern(v);
+
+    Context c1;
+    Context c2;
+
+    size_t evaluations = 0;
+    size_t hits = 0;
+    size_t previous_evaluations = 0;
+    size_t previous_hits = 0;
+    cache.GetStatistics(previous_evaluations, previous_hits);
+
+    //assert results are not remembered outside of an update
+    ASSERT_FALSE( cache.Validate(*validator, c1) );
+    ASSERT_FALSE( cache.Validate(*validator, c1) );
+    cache.GetStatistics(evaluations, hits);
+    ASSERT_EQ( previous_evaluations + 2, evaluations );
+    ASSERT_EQ( previous_hits, hits );
+
+    {
+      ValidatorCache::UpdatePass update_pass;
+
+      //assert a validator is evaluated once per context
+      ASSERT_FALSE( cache.Validate(*validator, c1) );
+      ASSERT_FALSE( cache.Validate(*validator, c1) );
+      ASSERT_FALSE( cache.Validate(*validator, c1) );
+      cache.GetStatistics(evaluations, hits);
+      ASSERT_EQ( previous_evaluations + 3, evaluations );
+      ASSERT_EQ( previous_hits + 2, hits );
+
+      //assert the validator is evaluated again with another context
+      ASSERT_FALSE( cache.Validate(*validator, c2) );
+      cache.GetStatistics(evaluations, hits);
+      ASSERT_EQ( previous_evaluations + 4, evaluations );
+
+      //assert the validator is evaluated again when the properties are modified
+      pmgr.SetProperty(property_name, "defined");
+      ASSERT_TRUE( cache.Validate(*validator, c2) );
+      ASSERT_TRUE( cache.Validate(*validator, c2) );
+      cache.GetStatistics(evaluations, hits);
+      ASSERT_EQ( previous_evaluations + 5, evaluations );
+      ASSERT_EQ( previous_hits + 3, hits );
+    }
+
+    pmgr.ClearProperty(property_name);
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
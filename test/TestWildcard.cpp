@@ -24,7 +24,9 @@
 
 #include "TestWildcard.h"
 #include "Wildcard.h"
+#include "rapidassist/strings.h"
 #include <sstream>
+#include <random>
 
 namespace shellanything { namespace test
 {
@@ -60,6 +62,105 @@ namespace shellanything { namespace test
     return s;
   }
 
+  /// <summary>
+  /// Recursive implementation of WildcardMatch() used before the linear-time implementation.
+  /// Used as a reference for validating the current implementation.
+  /// </summary>
+  bool WildcardMatchReference(const char * pattern, const char * value)
+  {
+    bool matching_characters = true;
+    while(matching_characters)
+    {
+      if (pattern[0] == '\0')
+        return (value[0] == '\0');
+
+      if (value[0] == '\0')
+      {
+        while(pattern[0] == '*')
+          pattern++;
+        return (pattern[0] == '\0');
+      }
+
+      matching_characters = false;
+      while(pattern[0] == '*' && pattern[1] == '*')
+      {
+        pattern++;
+        matching_characters = true;
+      }
+
+      if (pattern[0] == '?' || pattern[0] == value[0])
+      {
+        pattern++;
+        value++;
+        matching_characters = true;
+      }
+    }
+
+    if (pattern[0] == '*')
+    {
+      if (WildcardMatchReference(pattern, value+1))
+        return true;
+      if (WildcardMatchReference(pattern+1, value))
+        return true;
+    }
+    return false;
+  }
+
+  /// <summary>
+  /// Recursive implementation of WildcardSolve() which tries the longest value of each '*' character first.
+  /// Used as a reference for validating the current implementation. The pattern must be simplified.
+  /// </summary>
+  bool WildcardSolveReference(const std::string & pattern, size_t pattern_offset, const std::string & value, size_t value_offset, std::vector<WILDCARD_SPAN> & spans)
+  {
+    if (pattern_offset == pattern.size())
+      return (value_offset == value.size());
+
+    WILDCARD_SPAN span;
+    span.character = pattern[pattern_offset];
+    span.index = pattern_offset;
+    span.offset = value_offset;
+
+    if (pattern[pattern_offset] == '*')
+    {
+      for(size_t length = value.size() - value_offset + 1; length > 0; length--)
+      {
+        span.length = length - 1;
+        spans.push_back(span);
+        if (WildcardSolveReference(pattern, pattern_offset + 1, value, value_offset + span.length, spans))
+          return true;
+        spans.pop_back();
+      }
+      return false;
+    }
+
+    if (value_offset == value.size())
+      return false;
+    if (pattern[pattern_offset] == '?')
+    {
+      span.length = 1;
+      spans.push_back(span);
+      if (WildcardSolveReference(pattern, pattern_offset + 1, value, value_offset + 1, spans))
+        return true;
+      spans.pop_back();
+      return false;
+    }
+    if (pattern[pattern_offset] != value[value_offset])
+      return false;
+    return WildcardSolveReference(pattern, pattern_offset + 1, value, value_offset + 1, spans);
+  }
+
+  std::string GetRandomString(std::mt19937 & generator, const char * alphabet, size_t max_length)
+  {
+    const size_t alphabet_length = strlen(alphabet);
+    const size_t length = generator() % (max_length + 1);
+    std::string output;
+    for(size_t i=0; i<length; i++)
+    {
+      output.append(1, alphabet[generator() % alphabet_length]);
+    }
+    return output;
+  }
+
   //--------------------------------------------------------------------------------------------------
   void TestWildcard::SetUp()
   {
@@ -621,6 +722,193 @@ namespace shellanything { namespace test
     }
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWildcard, testMatchDifferential)
+  {
+    // Compare with the reference implementation on random patterns and values.
+    // The values do not contain '*' characters: the reference implementation may consume a '*' character of the value
+    // as a literal character instead of expanding the pattern's '*' character. Paths can not contain '*' characters.
+    std::mt19937 generator(0x5A5A);
+    static const size_t NUM_ITERATIONS = 200000;
+    for(size_t i=0; i<NUM_ITERATIONS; i++)
+    {
+      const std::string pattern = GetRandomString(generator, "ab*?", 8);
+      const std::string value   = GetRandomString(generator, "ab.?", 12);
+
+      bool expected = WildcardMatchReference(pattern.c_str(), value.c_str());
+      bool actual = WildcardMatch(pattern.c_str(), value.c_str());
+      ASSERT_EQ( expected, actual ) << "pattern='" << pattern << "' value='" << value << "'";
+
+      actual = WildcardMatch(pattern.c_str(), pattern.size(), value.c_str(), value.size());
+      ASSERT_EQ( expected, actual ) << "pattern='" << pattern << "' value='" << value << "'";
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWildcard, testMatchLength)
+  {
+    // Assert only the given lengths are matched
+    const char * pattern = "*.txt;*.dat";
+    const char * value = "file.txt;file.dat";
+    ASSERT_TRUE ( WildcardMatch(pattern, 5, value, 8) );
+    ASSERT_FALSE( WildcardMatch(pattern, 5, value, 9) );
+    ASSERT_TRUE ( WildcardMatch(pattern, strlen(pattern), value, strlen(value)) );
+    ASSERT_TRUE ( WildcardMatch(pattern, 0, value, 0) );
+    ASSERT_FALSE( WildcardMatch(NULL, 0, value, 0) );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWildcard, testMatchPathological)
+  {
+    // The recursive implementation requires an exponential time to reject these values
+    std::string value(1000, 'a');
+    ASSERT_FALSE( WildcardMatch("*a*a*a*a*a*a*a*a*a*a*a*a*b", value.c_str()) );
+    ASSERT_FALSE( WildcardMatch("*?*?*?*?*?*?*?*?*?*?*?*?*b", value.c_str()) );
+    value.append(1, 'b');
+    ASSERT_TRUE ( WildcardMatch("*a*a*a*a*a*a*a*a*a*a*a*a*b", value.c_str()) );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+  TEST_F(TestWildcard, testSolveSpans)
+  {
+    const std::string pattern = "C:\\*\\?ILE*.TXT";
+    const std::string value = "C:\\TEMP\\FOO\\FILE01.TXT";
+    WILDCARD_SPAN spans[3];
+    size_t num_spans = 0;
+    ASSERT_TRUE( WildcardSolve(pattern.c_str(), pattern.size(), value.c_str(), value.size(), spans, 3, &num_spans) );
+    ASSERT_EQ( 3, num_spans );
+
+    ASSERT_EQ( '*', spans[0].character );
+    ASSERT_EQ( 3, spans[0].index );
+    ASSERT_EQ( std::string("TEMP\\FOO"), value.substr(spans[0].offset, spans[0].length) );
+    ASSERT_EQ( '?', spans[1].character );
+    ASSERT_EQ( 5, spans[1].index );
+    ASSERT_EQ( std::string("F"), value.substr(spans[1].offset, spans[1].length) );
+    ASSERT_EQ( '*', spans[2].character );
+    ASSERT_EQ( 9, spans[2].index );
+    ASSERT_EQ( std::string("01"), value.substr(spans[2].offset, spans[2].length) );
+
+    // A small buffer only receives the first spans
+    WILDCARD_SPAN first;
+    ASSERT_TRUE( WildcardSolve(pattern.c_str(), pattern.size(), value.c_str(), value.size(), &first, 1, &num_spans) );
+    ASSERT_EQ( 3, num_spans );
+    ASSERT_EQ( spans[0].offset, first.offset );
+    ASSERT_EQ( spans[0].length, first.length );
+
+    // A '*' sequence is a single wildcard
+    ASSERT_TRUE( WildcardSolve("a**b", 4, "axxb", 4, spans, 3, &num_spans) );
+    ASSERT_EQ( 1, num_spans );
+    ASSERT_EQ( 1, spans[0].index );
+    ASSERT_EQ( 2, spans[0].length );
+
+    ASSERT_FALSE( WildcardSolve(pattern.c_str(), pattern.size(), "C:\\FILE.DAT", 11, NULL, 0, NULL) );
+    ASSERT_FALSE( WildcardSolve(NULL, 0, value.c_str(), value.size(), NULL, 0, &num_spans) );
+    ASSERT_EQ( 0, num_spans );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWildcard, testSolveCaptures)
+  {
+    // Each '*' takes the longest span, left to right
+    WildcardList matches;
+    ASSERT_TRUE( WildcardSolve("*a*", "bbaaaa", matches) );
+    ASSERT_EQ( 2, matches.size() );
+    ASSERT_EQ( std::string("bbaaa"), matches[0].value );
+    ASSERT_EQ( std::string(""),      matches[1].value );
+
+    ASSERT_TRUE( WildcardSolve("*a?*", "bbaaaa", matches) );
+    ASSERT_EQ( 3, matches.size() );
+    ASSERT_EQ( std::string("bbaa"), matches[0].value );
+    ASSERT_EQ( std::string("a"),    matches[1].value );
+    ASSERT_EQ( std::string(""),     matches[2].value );
+
+    // A '*' may capture an empty span at both ends of the value
+    ASSERT_TRUE( WildcardSolve("*b*", "b", matches) );
+    ASSERT_EQ( 2, matches.size() );
+    ASSERT_EQ( std::string(""), matches[0].value );
+    ASSERT_EQ( std::string(""), matches[1].value );
+
+    ASSERT_TRUE( WildcardSolve("a*", "a", matches) );
+    ASSERT_EQ( 1, matches.size() );
+    ASSERT_EQ( std::string(""), matches[0].value );
+
+    // The offset-based function produces the same spans
+    WILDCARD_SPAN spans[2];
+    size_t num_spans = 0;
+    ASSERT_TRUE( WildcardSolve("*a*", 3, "bbaaaa", 6, spans, 2, &num_spans) );
+    ASSERT_EQ( 2, num_spans );
+    ASSERT_EQ( 0, spans[0].offset );
+    ASSERT_EQ( 5, spans[0].length );
+    ASSERT_EQ( 6, spans[1].offset );
+    ASSERT_EQ( 0, spans[1].length );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWildcard, testSolveDifferential)
+  {
+    // Compare the spans with the reference implementation on random simplified patterns and values.
+    std::mt19937 generator(0xC0DE);
+    static const size_t NUM_ITERATIONS = 100000;
+    for(size_t i=0; i<NUM_ITERATIONS; i++)
+    {
+      char simplified[16];
+      strcpy(simplified, GetRandomString(generator, "ab*?", 8).c_str());
+      WildcardSimplify(simplified);
+      const std::string pattern = simplified;
+      const std::string value = GetRandomString(generator, "ab.", 12);
+
+      std::vector<WILDCARD_SPAN> expected;
+      bool expected_success = WildcardSolveReference(pattern, 0, value, 0, expected);
+
+      WILDCARD_SPAN spans[16];
+      size_t num_spans = 0;
+      bool success = WildcardSolve(pattern.c_str(), pattern.size(), value.c_str(), value.size(), spans, 16, &num_spans);
+      ASSERT_EQ( expected_success, success ) << "pattern='" << pattern << "' value='" << value << "'";
+      if (!success)
+        continue;
+
+      ASSERT_EQ( expected.size(), num_spans ) << "pattern='" << pattern << "' value='" << value << "'";
+      for(size_t j=0; j<num_spans; j++)
+      {
+        ASSERT_EQ( expected[j].character, spans[j].character ) << "pattern='" << pattern << "' value='" << value << "' j=" << j;
+        ASSERT_EQ( expected[j].index,     spans[j].index     ) << "pattern='" << pattern << "' value='" << value << "' j=" << j;
+        ASSERT_EQ( expected[j].offset,    spans[j].offset    ) << "pattern='" << pattern << "' value='" << value << "' j=" << j;
+        ASSERT_EQ( expected[j].length,    spans[j].length    ) << "pattern='" << pattern << "' value='" << value << "' j=" << j;
+      }
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWildcard, testSolvePathological)
+  {
+    // The recursive implementation requires an exponential time to reject these values
+    std::string value(1000, 'a');
+    WildcardList matches;
+    ASSERT_FALSE( WildcardSolve("*a*a*a*a*a*a*a*a*a*a*a*a*b", value.c_str(), matches) );
+    value.append(1, 'b');
+    ASSERT_TRUE ( WildcardSolve("*a*a*a*a*a*a*a*a*a*a*a*a*b", value.c_str(), matches) );
+    ASSERT_EQ( 13, matches.size() );
+    ASSERT_EQ( 988, matches[0].value.size() ); // the last 13 characters match the fixed characters
+  }
+  //--------------------------------------------------------------------------------------------------
+
+  TEST_F(TestWildcard, testMatchNoCase)
+  {
+    ASSERT_TRUE ( WildcardMatchNoCase("*.TXT", 5, "c:\\temp\\file.txt", 16) );
+    ASSERT_TRUE ( WildcardMatchNoCase("*.txt", 5, "C:\\TEMP\\FILE.TXT", 16) );
+    ASSERT_FALSE( WildcardMatchNoCase("*.txt", 5, "C:\\TEMP\\FILE.DAT", 16) );
+    ASSERT_FALSE( WildcardMatchNoCase("*.@", 3, "file.`", 6) ); // not letters
+
+    // Compare with the case sensitive function on values in uppercase
+    std::mt19937 generator(0xCA5E);
+    static const size_t NUM_ITERATIONS = 50000;
+    for(size_t i=0; i<NUM_ITERATIONS; i++)
+    {
+      const std::string pattern = GetRandomString(generator, "aB*?", 8);
+      const std::string value   = GetRandomString(generator, "aAbB.", 12);
+      const std::string pattern_uppercase = ra::strings::Uppercase(pattern);
+      const std::string value_uppercase = ra::strings::Uppercase(value);
+
+      bool expected = WildcardMatch(pattern_uppercase.c_str(), value_uppercase.c_str());
+      bool actual = WildcardMatchNoCase(pattern.c_str(), pattern.size(), value.c_str(), value.size());
+      ASSERT_EQ( expected, actual ) << "pattern='" << pattern << "' value='" << value << "'";
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
 
 } //namespace test
 } //namespace shellanything
@@ -0,0 +1,274 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestWildcardPattern.h"
+#include "shellanything/WildcardPattern.h"
+#include "Wildcard.h"
+
+#include <random>
+
+namespace shellanything { namespace test
+{
+  std::string GetRandomPatternString(std::mt19937 & generator, const char * alphabet, size_t max_length)
+  {
+    const size_t alphabet_length = strlen(alphabet);
+    const size_t length = generator() % (max_length + 1);
+    std::string output;
+    for(size_t i=0; i<length; i++)
+    {
+      output.append(1, alphabet[generator() % alphabet_length]);
+    }
+    return output;
+  }
+
+  /// <summary>
+  /// Splits a path in segments separated by '\\' or '/' characters.
+  /// </summary>
+  std::vector<std::string> SplitSegments(const std::string & path)
+  {
+    std::vector<std::string> segments(1);
+    for(size_t i=0; i<path.size(); i++)
+    {
+      if (path[i] == '\\' || path[i] == '/')
+        segments.push_back(std::string());
+      else
+        segments.back().append(1, path[i]);
+    }
+    return segments;
+  }
+
+  /// <summary>
+  /// Recursive implementation of a glob pattern without sets. Used as a reference for validating WildcardPattern.
+  /// Each segment is matched with WildcardMatch().
+  /// </summary>
+  bool GlobMatchReference(const std::vector<std::string> & pattern, size_t pattern_index, const std::vector<std::string> & value, size_t value_index)
+  {
+    if (pattern_index == pattern.size())
+      return (value_index == value.size());
+    if (pattern[pattern_index] == "**")
+    {
+      if (GlobMatchReference(pattern, pattern_index + 1, value, value_index))
+        return true;
+      return (value_index < value.size() && GlobMatchReference(pattern, pattern_index, value, value_index + 1));
+    }
+    if (value_index == value.size())
+      return false;
+    return WildcardMatch(pattern[pattern_index].c_str(), value[value_index].c_str()) && GlobMatchReference(pattern, pattern_index + 1, value, value_index + 1);
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  void TestWildcardPattern::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestWildcardPattern::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWildcardPattern, testMatch)
+  {
+    WildcardPattern extension("*.TXT");
+    ASSERT_TRUE ( extension.Match("C:\\TEMP\\FILE.TXT") );
+    ASSERT_TRUE ( extension.Match(".TXT") );
+    ASSERT_FALSE( extension.Match("C:\\TEMP\\FILE.TXT.BAK") );
+    ASSERT_FALSE( extension.Match("TXT") );
+
+    WildcardPattern literal("C:\\WINDOWS");
+    ASSERT_TRUE ( literal.Match("C:\\WINDOWS") );
+    ASSERT_FALSE( literal.Match("C:\\WINDOWS\\") );
+    ASSERT_FALSE( literal.Match("C:\\WINDOW") );
+
+    WildcardPattern complex("C:\\*\\SYSTEM32\\*.?LL");
+    ASSERT_TRUE ( complex.Match("C:\\WINDOWS\\SYSTEM32\\KERNEL32.DLL") );
+    ASSERT_TRUE ( complex.Match("C:\\FOO\\SYSTEM32\\BAR\\.XLL") );
+    ASSERT_FALSE( complex.Match("C:\\WINDOWS\\SYSTEM\\KERNEL32.DLL") );
+    ASSERT_FALSE( complex.Match("D:\\WINDOWS\\SYSTEM32\\KERNEL32.DLL") );
+    ASSERT_FALSE( complex.Match("C:\\WINDOWS\\SYSTEM32\\KERNEL32.DL") );
+
+    WildcardPattern questions("???.EXE");
+    ASSERT_TRUE ( questions.Match("CMD.EXE") );
+    ASSERT_FALSE( questions.Match("NOTEPAD.EXE") );
+
+    WildcardPattern empty;
+    ASSERT_TRUE ( empty.Match("") );
+    ASSERT_FALSE( empty.Match("A") );
+
+    empty.SetPattern("*");
+    ASSERT_EQ( std::string("*"), empty.GetPattern() );
+    ASSERT_TRUE ( empty.Match("") );
+    ASSERT_TRUE ( empty.Match("A") );
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWildcardPattern, testMatchDifferential)
+  {
+    // Compare with WildcardMatch() on random patterns and values
+    std::mt19937 generator(0xA5A5);
+    static const size_t NUM_ITERATIONS = 200000;
+    for(size_t i=0; i<NUM_ITERATIONS; i++)
+    {
+      const std::string pattern = GetRandomPatternString(generator, "ab*?", 10);
+      const std::string value   = GetRandomPatternString(generator, "ab.", 14);
+
+      WildcardPattern compiled(pattern);
+      bool expected = WildcardMatch(pattern.c_str(), value.c_str());
+      bool actual = compiled.Match(value);
+      ASSERT_EQ( expected, actual ) << "pattern='" << pattern << "' value='" << value << "'";
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+
+  TEST_F(TestWildcardPattern, testMatchNoCase)
+  {
+    WildcardPattern extension("*.txt", false);
+    ASSERT_FALSE( extension.IsCaseSensitive() );
+    ASSERT_EQ( std::string("*.TXT"), extension.GetPattern() );
+    ASSERT_TRUE ( extension.Match("C:\\TEMP\\FILE.TXT") );
+    ASSERT_TRUE ( extension.Match("c:\\temp\\file.Txt") );
+    ASSERT_FALSE( extension.Match("c:\\temp\\file.txt.bak") );
+
+    WildcardPattern literal("C:\\Program Files\\*\\?in\\shellext.dll", false);
+    ASSERT_TRUE ( literal.Match("c:\\program files\\ShellAnything\\bin\\SHELLEXT.DLL") );
+    ASSERT_FALSE( literal.Match("c:\\program files\\ShellAnything\\lib\\SHELLEXT.DLL") );
+
+    // The utf-8 characters must be identical
+    WildcardPattern utf8("*caf\xC3\xA9*", false);
+    ASSERT_TRUE ( utf8.Match("C:\\CAF\xC3\xA9\\MENU.XML") );
+    ASSERT_FALSE( utf8.Match("C:\\CAF\xC3\x89\\MENU.XML") );
+
+    WildcardPattern sensitive("*.txt");
+    ASSERT_TRUE ( sensitive.IsCaseSensitive() );
+    ASSERT_FALSE( sensitive.Match("FILE.TXT") );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+  TEST_F(TestWildcardPattern, testGlob)
+  {
+    WildcardPattern flat("C:\\*.txt", false);
+    ASSERT_FALSE( flat.IsGlob() );
+    ASSERT_TRUE ( flat.Match("c:\\temp\\file.txt") ); // '*' matches path separators
+
+    // "**" matches any number of directories
+    WildcardPattern globstar("glob:C:\\**\\*.txt", false);
+    ASSERT_TRUE ( globstar.IsGlob() );
+    ASSERT_TRUE ( globstar.Match("c:\\file.txt") );
+    ASSERT_TRUE ( globstar.Match("c:\\temp\\file.txt") );
+    ASSERT_TRUE ( globstar.Match("C:/temp/foo/bar/FILE.TXT") );
+    ASSERT_FALSE( globstar.Match("d:\\temp\\file.txt") );
+    ASSERT_FALSE( globstar.Match("c:\\temp\\file.txt\\foo.dat") );
+
+    // '*' and '?' do not match path separators
+    WildcardPattern segment("glob:C:\\**\\build\\*\\?.dll", false);
+    ASSERT_TRUE ( segment.Match("c:\\projects\\foo\\build\\release\\a.dll") );
+    ASSERT_FALSE( segment.Match("c:\\projects\\foo\\build\\release\\x64\\a.dll") );
+    ASSERT_FALSE( segment.Match("c:\\projects\\foo\\build\\release\\ab.dll") );
+    ASSERT_FALSE( segment.Match("c:\\build\\a.dll") );
+
+    // Sets
+    WildcardPattern set("glob:*\\file[0-9][!a-c].[tx]xt", false);
+    ASSERT_TRUE ( set.IsGlob() );
+    ASSERT_TRUE ( set.Match("temp\\file1d.txt") );
+    ASSERT_TRUE ( set.Match("temp\\FILE9Z.XXT") );
+    ASSERT_FALSE( set.Match("temp\\filex1.txt") );
+    ASSERT_FALSE( set.Match("temp\\file1b.txt") );
+    ASSERT_FALSE( set.Match("temp\\file1d.dxt") );
+    ASSERT_FALSE( set.Match("foo\\temp\\file1d.txt") ); // '*' matches a single directory
+
+    WildcardPattern bracket("glob:[]a]\\[!]]\\[", true);
+    ASSERT_TRUE ( bracket.Match("]\\b\\[") );
+    ASSERT_TRUE ( bracket.Match("a\\b\\[") );
+    ASSERT_FALSE( bracket.Match("a\\]\\[") );
+
+    // Trailing and repeated "**"
+    WildcardPattern trailing("glob:c:\\temp\\**\\**", true);
+    ASSERT_TRUE ( trailing.Match("c:\\temp") );
+    ASSERT_TRUE ( trailing.Match("c:\\temp\\foo\\bar") );
+    ASSERT_FALSE( trailing.Match("c:\\tmp\\foo") );
+
+    // Literals found in all matching values
+    ASSERT_EQ( std::string("TEMP"), WildcardPattern("glob:C:\\TEMP\\**\\[ab]*", true).GetLongestLiteral() );
+    ASSERT_EQ( std::string("C:\\TEMP\\"), WildcardPattern("C:\\TEMP\\*", true).GetLongestLiteral() );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+  TEST_F(TestWildcardPattern, testGlobPrefix)
+  {
+    // Without the "glob:" prefix, '[' is a literal character and "**" matches path separators
+    WildcardPattern literal_set("*[1]*.txt", false);
+    ASSERT_FALSE( literal_set.IsGlob() );
+    ASSERT_TRUE ( literal_set.Match("c:\\temp\\file[1]x.txt") );
+    ASSERT_FALSE( literal_set.Match("c:\\temp\\file1x.txt") );
+    ASSERT_EQ( WildcardMatch("*[1]*.txt", "file[1].txt"), literal_set.Match("file[1].txt") );
+
+    WildcardPattern double_star("**.txt", true);
+    ASSERT_FALSE( double_star.IsGlob() );
+    ASSERT_TRUE ( double_star.Match("c:\\temp\\foo\\file.txt") );
+    ASSERT_EQ( std::string("**.txt"), double_star.GetPattern() );
+
+    // The prefix is not case sensitive and is kept in the pattern
+    WildcardPattern upper("GLOB:*[1]*.txt", true);
+    ASSERT_TRUE ( upper.IsGlob() );
+    ASSERT_TRUE ( upper.Match("file1x.txt") );
+    ASSERT_FALSE( upper.Match("file[2]x.txt") );
+    ASSERT_FALSE( upper.Match("c:\\temp\\file1x.txt") );
+    ASSERT_EQ( std::string("GLOB:*[1]*.txt"), upper.GetPattern() );
+
+    // The prefix is not a literal of the values
+    WildcardPattern prefix("glob:c:\\temp\\*.txt", false);
+    ASSERT_TRUE ( prefix.Match("C:/TEMP/FILE.TXT") );
+    ASSERT_FALSE( prefix.Match("glob:c:\\temp\\file.txt") );
+    ASSERT_EQ( std::string("TEMP"), prefix.GetLongestLiteral() );
+
+    WildcardPattern empty("glob:", true);
+    ASSERT_TRUE ( empty.IsGlob() );
+    ASSERT_TRUE ( empty.Match("") );
+    ASSERT_FALSE( empty.Match("glob:") );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+  TEST_F(TestWildcardPattern, testGlobDifferential)
+  {
+    // Compare the path patterns with a recursive implementation on random patterns and values
+    std::mt19937 generator(0x610B);
+    static const size_t NUM_ITERATIONS = 100000;
+    size_t num_globs = 0;
+    for(size_t i=0; i<NUM_ITERATIONS; i++)
+    {
+      const std::string pattern = GetRandomPatternString(generator, "ab**?\\", 10);
+      const std::string value   = GetRandomPatternString(generator, "ab\\/", 10);
+
+      WildcardPattern compiled("glob:" + pattern);
+      if (pattern.find("**") == std::string::npos)
+        continue;
+      num_globs++;
+
+      bool expected = GlobMatchReference(SplitSegments(pattern), 0, SplitSegments(value), 0);
+      bool actual = compiled.Match(value);
+      ASSERT_EQ( expected, actual ) << "pattern='" << pattern << "' value='" << value << "'";
+    }
+    ASSERT_GT( num_globs, 1000 );
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything
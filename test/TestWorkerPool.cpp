@@ -0,0 +1,192 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+
+#include "TestWorkerPool.h"
+#include "WorkerPool.h"
+
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+namespace shellanything { namespace test
+{
+  /// <summary>
+  /// A job which counts how many times each item is processed.
+  /// Throws when the item at position mFailure is processed.
+  /// </summary>
+  class CountingJob : public WorkerPool::Job
+  {
+  public:
+    CountingJob(size_t num_items, size_t failure) :
+      mCounts(num_items),
+      mNext(0),
+      mFailure(failure)
+    {
+      for(size_t i=0; i<mCounts.size(); i++)
+      {
+        mCounts[i] = 0;
+      }
+    }
+
+    virtual void Execute()
+    {
+      for(;;)
+      {
+        size_t i = mNext.fetch_add(1);
+        if (i >= mCounts.size())
+          return;
+        mCounts[i]++;
+        if (i == mFailure)
+          throw std::runtime_error("failure");
+      }
+    }
+
+    bool IsEachItemProcessedOnce() const
+    {
+      for(size_t i=0; i<mCounts.size(); i++)
+      {
+        if (mCounts[i] != 1)
+          return false;
+      }
+      return true;
+    }
+
+  private:
+    std::vector<std::atomic<int> > mCounts;
+    std::atomic<size_t> mNext;
+    size_t mFailure;
+  };
+
+  static const size_t NO_FAILURE = (size_t)-1;
+
+  /// <summary>
+  /// A job which runs a CountingJob on the WorkerPool for each of its items.
+  /// </summary>
+  class NestedJob : public WorkerPool::Job
+  {
+  public:
+    NestedJob(size_t num_items) :
+      mNumItems(num_items),
+      mNext(0),
+      mNumSucceeded(0)
+    {
+    }
+
+    virtual void Execute()
+    {
+      for(;;)
+      {
+        size_t i = mNext.fetch_add(1);
+        if (i >= mNumItems)
+          return;
+        CountingJob job(100, NO_FAILURE);
+        WorkerPool::GetInstance().Run(job, 4);
+        if (job.IsEachItemProcessedOnce())
+          mNumSucceeded++;
+      }
+    }
+
+    size_t GetNumSucceeded() const
+    {
+      return mNumSucceeded;
+    }
+
+  private:
+    size_t mNumItems;
+    std::atomic<size_t> mNext;
+    std::atomic<size_t> mNumSucceeded;
+  };
+
+  //--------------------------------------------------------------------------------------------------
+  void TestWorkerPool::SetUp()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestWorkerPool::TearDown()
+  {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWorkerPool, testRun)
+  {
+    WorkerPool & pool = WorkerPool::GetInstance();
+
+    CountingJob job(10000, NO_FAILURE);
+    pool.Run(job, 4);
+    ASSERT_TRUE(job.IsEachItemProcessedOnce());
+    ASSERT_GE(pool.GetNumThreads(), (size_t)1);
+    ASSERT_LE(pool.GetNumThreads(), WorkerPool::MAX_THREADS);
+
+    //the calling thread alone
+    CountingJob single(10000, NO_FAILURE);
+    pool.Run(single, 1);
+    ASSERT_TRUE(single.IsEachItemProcessedOnce());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWorkerPool, testThreadsReused)
+  {
+    WorkerPool & pool = WorkerPool::GetInstance();
+
+    CountingJob first(10000, NO_FAILURE);
+    pool.Run(first, 4);
+    const size_t num_threads = pool.GetNumThreads();
+
+    //the idle threads execute the next jobs
+    for(size_t i=0; i<10; i++)
+    {
+      CountingJob job(10000, NO_FAILURE);
+      pool.Run(job, 4);
+      ASSERT_TRUE(job.IsEachItemProcessedOnce());
+    }
+    ASSERT_EQ(num_threads, pool.GetNumThreads());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWorkerPool, testException)
+  {
+    WorkerPool & pool = WorkerPool::GetInstance();
+
+    //the exception is thrown by the calling thread or by a worker thread
+    for(size_t i=0; i<20; i++)
+    {
+      CountingJob job(10000, 5000);
+      ASSERT_THROW(pool.Run(job, 4), std::runtime_error);
+    }
+
+    //the pool is still usable
+    CountingJob job(10000, NO_FAILURE);
+    pool.Run(job, 4);
+    ASSERT_TRUE(job.IsEachItemProcessedOnce());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestWorkerPool, testNested)
+  {
+    //jobs executed by a worker thread run other jobs on the pool
+    NestedJob job(50);
+    WorkerPool::GetInstance().Run(job, 4);
+    ASSERT_EQ((size_t)50, job.GetNumSucceeded());
+  }
+  //--------------------------------------------------------------------------------------------------
+
+} //namespace test
+} //namespace shellanything